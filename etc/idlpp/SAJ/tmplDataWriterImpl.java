@@ -139,7 +139,7 @@ public class $(type-name)DataWriterImpl extends org.opensplice.dds.dcps.DataWrit
                 org.opensplice.dds.dcps.ReportStack.report(
                     result, "instance_data 'null' is invalid.");
             } else {
-                result = org.opensplice.dds.dcps.FooDataWriterImpl.jniWrite(
+                result = this.writeSample(
                         uWriter,
                         copyCache,
                         instance_data,
@@ -174,7 +174,7 @@ public class $(type-name)DataWriterImpl extends org.opensplice.dds.dcps.DataWrit
             }
 
             if (result == DDS.RETCODE_OK.value) {
-                result = org.opensplice.dds.dcps.FooDataWriterImpl.jniWrite(
+                result = this.writeSample(
                         uWriter,
                         copyCache,
                         instance_data,
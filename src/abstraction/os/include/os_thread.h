@@ -56,6 +56,7 @@ typedef enum os_threadMemoryIndex {
     OS_THREAD_PROCESS_INFO,
     OS_THREAD_STATE, /* Used for monitoring thread progress */
     OS_THREAD_STR_ERROR,
+    OS_THREAD_ALLOC_SAMPLER, /* Allocation sampling countdown of c_base */
     OS_THREAD_MEM_ARRAY_SIZE /* Number of slots in Thread Private Memory */
 } os_threadMemoryIndex;
 
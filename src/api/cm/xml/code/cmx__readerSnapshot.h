@@ -27,6 +27,7 @@
 #include "c_typebase.h"
 #include "c_iterator.h"
 #include "v_kernel.h"
+#include "sd_serializer.h"
 
 #if defined (__cplusplus)
 extern "C" {
@@ -35,8 +36,14 @@ extern "C" {
 
 C_CLASS(cmx_readerSnapshot);
 
+/* The samples are captured in compact binary form while the reader is
+ * locked; they are only converted to XML when read or taken from the
+ * snapshot, so the reader lock is not held during XML serialization.
+ */
 C_STRUCT(cmx_readerSnapshot){
-    c_iter samples;
+    c_iter samples;       /* sd_serializedData, big-endian binary */
+    sd_serializer binary; /* serializer used to capture the samples */
+    sd_serializer xml;    /* created on first read/take */
 };
 
 struct cmx_readerSnapshotArg{
@@ -37,8 +37,13 @@ extern "C" {
 
 C_CLASS(cmx_writerSnapshot);
 
+/* The history is captured in compact binary form while the writer is
+ * locked and only converted to XML when read or taken from the snapshot.
+ */
 C_STRUCT(cmx_writerSnapshot){
-    c_iter samples;
+    c_iter samples;       /* sd_serializedData, big-endian binary */
+    sd_serializer binary; /* serializer used to capture the samples */
+    sd_serializer xml;    /* created on first read/take */
 };
 
 struct cmx_writerSnapshotArg{
@@ -75,7 +80,7 @@ cmx_writerSnapshot  cmx_writerSnapshotLookup    (const c_char* snapshot);
  *
  * @param sample The sample to copy.
  * @param args Must be of type struct cmx_writerSnapshotArg. It will be filled
- *             with the XML representation of samples in the history during
+ *             with the binary representation of samples in the history during
  *             the execution of this function.
  */
 c_bool              cmx_writerHistoryCopy       (c_object sample,
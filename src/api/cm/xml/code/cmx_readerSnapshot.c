@@ -37,10 +37,61 @@
 #include "os_report.h"
 #include "os_stdlib.h"
 #include "sd_serializerXML.h"
+#include "sd_serializerBigE.h"
 #include "os_abstract.h"
 
 static c_iter readerSnapshots = NULL;
 
+static void
+cmx_readerSnapshotDeinit(
+    cmx_readerSnapshot s)
+{
+    sd_serializedData data;
+
+    if(s->samples != NULL){
+        data = (sd_serializedData)(c_iterTakeFirst(s->samples));
+
+        while(data != NULL){
+            sd_serializedDataFree(data);
+            data = (sd_serializedData)(c_iterTakeFirst(s->samples));
+        }
+        c_iterFree(s->samples);
+    }
+    if(s->binary != NULL){
+        sd_serializerFree(s->binary);
+    }
+    if(s->xml != NULL){
+        sd_serializerFree(s->xml);
+    }
+}
+
+/* Converts a sample captured in binary form into its XML representation.
+ * This is done outside the reader lock, one sample at a time.
+ */
+static c_char*
+cmx_readerSnapshotToXML(
+    cmx_readerSnapshot s,
+    sd_serializedData data)
+{
+    c_object sample;
+    sd_serializedData xmlData;
+    c_char* result;
+
+    result = NULL;
+    sample = sd_serializerDeserialize(s->binary, data);
+
+    if(sample != NULL){
+        if(s->xml == NULL){
+            s->xml = sd_serializerXMLNewTyped(c_getType(sample));
+        }
+        xmlData = sd_serializerSerialize(s->xml, sample);
+        result = sd_serializerToString(s->xml, xmlData);
+        sd_serializedDataFree(xmlData);
+        c_free(sample);
+    }
+    return result;
+}
+
 c_char*
 cmx_readerSnapshotNew(
     const c_char* reader)
@@ -88,7 +139,6 @@ cmx_readerSnapshotNewAction(
     v_query query;
     c_bool release;
     sd_serializer ser;
-    sd_serializedData data;
     struct cmx_readerSnapshotArg* arg;
 
     release = FALSE;
@@ -138,6 +188,8 @@ cmx_readerSnapshotNewAction(
     }
     if(arg->success == TRUE){
         arg->snapshot->samples = c_iterNew(NULL);
+        arg->snapshot->binary = NULL;
+        arg->snapshot->xml = NULL;
     }
     if(instances != NULL){
         v_dataReaderSample sampleShallowCopy = NULL;
@@ -160,11 +212,10 @@ cmx_readerSnapshotNewAction(
                     sampleShallowCopy->_parent.sampleState |= state;
 
                     if(ser == NULL){
-                        ser = sd_serializerXMLNewTyped(c_getType(c_object(sampleShallowCopy)));
+                        ser = sd_serializerBigENewTyped(c_getType(c_object(sampleShallowCopy)));
                     }
-                    data = sd_serializerSerialize(ser, c_object(sampleShallowCopy));
-                    arg->snapshot->samples = c_iterInsert(arg->snapshot->samples, sd_serializerToString(ser, data));
-                    sd_serializedDataFree(data);
+                    arg->snapshot->samples = c_iterInsert(arg->snapshot->samples,
+                                                          sd_serializerSerialize(ser, c_object(sampleShallowCopy)));
 
                     sample = sample->newer;
                 } while (sample != NULL);
@@ -187,7 +238,8 @@ cmx_readerSnapshotNewAction(
         }
     }
     if(ser != NULL){
-        sd_serializerFree(ser);
+        /* Kept with the snapshot to deserialize the samples on read/take. */
+        arg->snapshot->binary = ser;
     }
 }
 
@@ -196,7 +248,6 @@ cmx_readerSnapshotFree(
     c_char* snapshot)
 {
     cmx_readerSnapshot s;
-    c_char* sample;
     os_mutex m;
 
     s = cmx_readerSnapshotLookup(snapshot);
@@ -207,15 +258,7 @@ cmx_readerSnapshotFree(
         c_iterTake(readerSnapshots, s);
         os_mutexUnlock(&m);
 
-        if(s->samples != NULL){
-            sample = (c_char*)(c_iterTakeFirst(s->samples));
-
-            while(sample != NULL){
-                os_free(sample);
-                sample = (c_char*)(c_iterTakeFirst(s->samples));
-            }
-            c_iterFree(s->samples);
-        }
+        cmx_readerSnapshotDeinit(s);
         os_free(s);
         os_free(snapshot);
     }
@@ -225,7 +268,6 @@ void
 cmx_readerSnapshotFreeAll()
 {
     cmx_readerSnapshot s;
-    c_char* sample;
     os_mutex m;
 
     m = cmx_getReaderSnapshotMutex();
@@ -233,15 +275,7 @@ cmx_readerSnapshotFreeAll()
     s = cmx_readerSnapshot(c_iterTakeFirst(readerSnapshots));
 
     while(s != NULL){
-        if(s->samples != NULL){
-            sample = (c_char*)(c_iterTakeFirst(s->samples));
-
-            while(sample != NULL){
-                os_free(sample);
-                sample = (c_char*)(c_iterTakeFirst(s->samples));
-            }
-            c_iterFree(s->samples);
-        }
+        cmx_readerSnapshotDeinit(s);
         os_free(s);
         s = cmx_readerSnapshot(c_iterTakeFirst(readerSnapshots));
     }
@@ -254,15 +288,15 @@ cmx_readerSnapshotRead(
 {
     cmx_readerSnapshot s;
     c_char* result;
-    c_char* temp;
+    sd_serializedData data;
     s = cmx_readerSnapshotLookup(snapshot);
     result = NULL;
 
     if(s != NULL){
-        temp = (c_char*)(c_iterObject(s->samples, 0));
+        data = (sd_serializedData)(c_iterObject(s->samples, 0));
 
-        if(temp != NULL){
-            result = (c_char*)(os_strdup(temp));
+        if(data != NULL){
+            result = cmx_readerSnapshotToXML(s, data);
         }
     }
     return result;
@@ -274,11 +308,17 @@ cmx_readerSnapshotTake(
 {
     cmx_readerSnapshot s;
     c_char* result;
+    sd_serializedData data;
     s = cmx_readerSnapshotLookup(snapshot);
     result = NULL;
 
     if(s != NULL){
-        result = (c_char*)(c_iterTakeFirst(s->samples));
+        data = (sd_serializedData)(c_iterTakeFirst(s->samples));
+
+        if(data != NULL){
+            result = cmx_readerSnapshotToXML(s, data);
+            sd_serializedDataFree(data);
+        }
     }
     return result;
 }
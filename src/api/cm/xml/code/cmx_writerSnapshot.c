@@ -24,6 +24,7 @@
 #include "cmx__factory.h"
 #include "sd_serializer.h"
 #include "sd_serializerXML.h"
+#include "sd_serializerBigE.h"
 #include "u_observable.h"
 #include "v_kernel.h"
 #include "v_writer.h"
@@ -34,6 +35,56 @@
 
 static c_iter writerSnapshots = NULL;
 
+static void
+cmx_writerSnapshotDeinit(
+    cmx_writerSnapshot s)
+{
+    sd_serializedData data;
+
+    if(s->samples != NULL){
+        data = (sd_serializedData)(c_iterTakeFirst(s->samples));
+
+        while(data != NULL){
+            sd_serializedDataFree(data);
+            data = (sd_serializedData)(c_iterTakeFirst(s->samples));
+        }
+        c_iterFree(s->samples);
+    }
+    if(s->binary != NULL){
+        sd_serializerFree(s->binary);
+    }
+    if(s->xml != NULL){
+        sd_serializerFree(s->xml);
+    }
+}
+
+/* Converts a sample captured in binary form into its XML representation.
+ * This is done outside the writer lock, one sample at a time.
+ */
+static c_char*
+cmx_writerSnapshotToXML(
+    cmx_writerSnapshot s,
+    sd_serializedData data)
+{
+    c_object sample;
+    sd_serializedData xmlData;
+    c_char* result;
+
+    result = NULL;
+    sample = sd_serializerDeserialize(s->binary, data);
+
+    if(sample != NULL){
+        if(s->xml == NULL){
+            s->xml = sd_serializerXMLNewTyped(c_getType(sample));
+        }
+        xmlData = sd_serializerSerialize(s->xml, sample);
+        result = sd_serializerToString(s->xml, xmlData);
+        sd_serializedDataFree(xmlData);
+        c_free(sample);
+    }
+    return result;
+}
+
 c_char*
 cmx_writerSnapshotNew(
     const c_char* writer)
@@ -86,11 +137,11 @@ cmx_writerSnapshotNewAction(
         arg->success = TRUE;
         arg->snapshot = cmx_writerSnapshot(os_malloc(C_SIZEOF(cmx_writerSnapshot)));
         arg->snapshot->samples = NULL;
+        arg->snapshot->xml = NULL;
         writer = v_writer(p);
         v_writerRead(writer, cmx_writerHistoryCopy, args);
-        if(arg->serializer != NULL){
-            sd_serializerFree(arg->serializer);
-        }
+        /* Kept with the snapshot to deserialize the samples on read/take. */
+        arg->snapshot->binary = arg->serializer;
     break;
     default:
     break;
@@ -103,19 +154,14 @@ cmx_writerHistoryCopy(
     c_voidp args)
 {
     struct cmx_writerSnapshotArg* arg;
-    sd_serializedData data;
-    c_char* xml;
 
     arg = (struct cmx_writerSnapshotArg*)args;
 
     if(arg->serializer == NULL){
-        arg->serializer = sd_serializerXMLNewTyped(c_getType(sample));
+        arg->serializer = sd_serializerBigENewTyped(c_getType(sample));
     }
-
-    data = sd_serializerSerialize(arg->serializer, sample);
-    xml = sd_serializerToString(arg->serializer, data);
-    arg->snapshot->samples = c_iterInsert(arg->snapshot->samples, xml);
-    sd_serializedDataFree(data);
+    arg->snapshot->samples = c_iterInsert(arg->snapshot->samples,
+                                          sd_serializerSerialize(arg->serializer, sample));
 
     return TRUE;
 }
@@ -125,7 +171,6 @@ cmx_writerSnapshotFree(
     c_char* snapshot)
 {
     cmx_writerSnapshot s;
-    c_char* sample;
     os_mutex m;
 
     s = cmx_writerSnapshotLookup(snapshot);
@@ -136,15 +181,7 @@ cmx_writerSnapshotFree(
         c_iterTake(writerSnapshots, s);
         os_mutexUnlock(&m);
 
-        if(s->samples != NULL){
-            sample = (c_char*)(c_iterTakeFirst(s->samples));
-
-            while(sample != NULL){
-                os_free(sample);
-                sample = (c_char*)(c_iterTakeFirst(s->samples));
-            }
-            c_iterFree(s->samples);
-        }
+        cmx_writerSnapshotDeinit(s);
         os_free(s);
         os_free(snapshot);
     }
@@ -154,7 +191,6 @@ void
 cmx_writerSnapshotFreeAll()
 {
     cmx_writerSnapshot s;
-    c_char* sample;
     os_mutex m;
 
     m = cmx_getWriterSnapshotMutex();
@@ -162,15 +198,7 @@ cmx_writerSnapshotFreeAll()
     s = cmx_writerSnapshot(c_iterTakeFirst(writerSnapshots));
 
     while(s != NULL){
-        if(s->samples != NULL){
-            sample = (c_char*)(c_iterTakeFirst(s->samples));
-
-            while(sample != NULL){
-                os_free(sample);
-                sample = (c_char*)(c_iterTakeFirst(s->samples));
-            }
-            c_iterFree(s->samples);
-        }
+        cmx_writerSnapshotDeinit(s);
         os_free(s);
         s = cmx_writerSnapshot(c_iterTakeFirst(writerSnapshots));
     }
@@ -183,15 +211,15 @@ cmx_writerSnapshotRead(
 {
     cmx_writerSnapshot s;
     c_char* result;
-    c_char* temp;
+    sd_serializedData data;
     s = cmx_writerSnapshotLookup(snapshot);
     result = NULL;
 
     if(s != NULL){
-        temp = (c_char*)(c_iterObject(s->samples, 0));
+        data = (sd_serializedData)(c_iterObject(s->samples, 0));
 
-        if(temp != NULL){
-            result = (c_char*)(os_strdup(temp));
+        if(data != NULL){
+            result = cmx_writerSnapshotToXML(s, data);
         }
     }
     return result;
@@ -203,11 +231,17 @@ cmx_writerSnapshotTake(
 {
     cmx_writerSnapshot s;
     c_char* result;
+    sd_serializedData data;
     s = cmx_writerSnapshotLookup(snapshot);
     result = NULL;
 
     if(s != NULL){
-        result = (c_char*)(c_iterTakeFirst(s->samples));
+        data = (sd_serializedData)(c_iterTakeFirst(s->samples));
+
+        if(data != NULL){
+            result = cmx_writerSnapshotToXML(s, data);
+            sd_serializedDataFree(data);
+        }
     }
     return result;
 }
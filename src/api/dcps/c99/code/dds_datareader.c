@@ -392,7 +392,6 @@ struct flushCopyArg {
     DDS_TypeSupportCopyInfo copyInfo;
     void **data;
     dds_sample_info_t *info;
-    uint32_t seqIndex;
 };
 
 #define C99_GET_SAMPLE_STATE(x)   ((dds_sample_state_t)((x) & 0x3))
@@ -420,19 +419,23 @@ copy_sample_info(
     dst->reception_timestamp         = (dds_time_t)            OS_TIMEW_GET_VALUE(srcInfo->reception_timestamp);
 }
 
+/* The samples may be copied by several threads at once, see
+ * cmn_samplesList_flushIndexed, so only the slot of the given index is
+ * written.
+ */
 static void
 sample_flush_copy(
     void * sample,
     cmn_sampleInfo sampleInfo,
+    os_uint32 index,
     void *arg)
 {
     struct flushCopyArg *a = (struct flushCopyArg *)arg;
     void *dst;
 
-    dst = a->data[a->seqIndex];
+    dst = a->data[index];
     DDS_TypeSupportCopyInfo_copy_out(a->copyInfo, a->data, dst, sample);
-    copy_sample_info(sampleInfo, &(a->info[a->seqIndex]));
-    a->seqIndex++;
+    copy_sample_info(sampleInfo, &(a->info[index]));
 }
 
 
@@ -455,10 +458,11 @@ samples_flush_copy(
         arg.copyInfo       = dds_loanRegistry_copyInfo(registry);
         arg.data           = data;
         arg.info           = info;
-        arg.seqIndex       = 0;
         result = result_from_u_result(u_readerProtectCopyOutEnter(uEntity));
         if (result == DDS_RETCODE_OK) {
-            testlength = cmn_samplesList_flush(samplesList, sample_flush_copy, &arg);
+            testlength = cmn_samplesList_flushIndexed(samplesList,
+                    (cmn_parallelCopy)DDS_DataReader_get_parallel_copy(reader),
+                    uEntity, sample_flush_copy, &arg);
             if (testlength < 0) {
                 result = DDS_RETCODE_ALREADY_DELETED;
             }
@@ -26,6 +26,7 @@
 #include "v_dataViewSample.h"
 #include "v_state.h"
 #include "os_report.h"
+#include "os_atomics.h"
 
 
 #if 0
@@ -78,6 +79,46 @@ C_STRUCT (cmn_readList) {
     os_uint32 iterator;
 };
 
+/* A block of one read buffer keeps the claims of the copying threads on
+ * separate cache lines, below four blocks the wake-up of the workers costs
+ * more than the copy itself.
+ */
+#define CMN_PARALLELCOPY_BLOCK (READBUFFERSIZE)
+#define CMN_PARALLELCOPY_THRESHOLD (4 * CMN_PARALLELCOPY_BLOCK)
+
+/* The parallelCopy holds the worker threads that copy out the samples of a
+ * flushIndexed() call together with the calling thread. The workers stay
+ * alive between calls and claim blocks of samples by incrementing nextIndex.
+ * A reader shares one parallelCopy over all its lists; flushMtx makes sure
+ * only one flush uses the workers at a time, the others copy serially.
+ */
+C_STRUCT(cmn_parallelCopy) {
+    os_uint32 nrofWorkers;  /* Number of worker threads, the calling thread participates as well */
+    os_threadId *tids;
+    struct {
+        os_uint32 threshold; /* Minimum number of samples for which the copy is parallelized */
+        os_uint32 block;     /* Number of samples claimed by a thread at once */
+    } heuristics;
+    struct {
+        pa_uint32_t nextIndex;       /* First sample of the next unclaimed block */
+        pa_uint32_t failed;          /* Set when a worker could not protect the copy */
+        os_uint32 length;            /* The number of samples to be copied */
+        cmn_readBuffer *buffers;     /* Read buffers of the list, indexed by sample index / READBUFFERSIZE */
+        os_uint32 maxBuffers;        /* Allocated length of buffers */
+        os_boolean isView;
+        u_entity reader;
+        cmn_sampleList_indexed_copy_func copy_action;
+        void *copy_arg;
+    } copy_info;
+    os_mutex flushMtx;
+    os_mutex mtx;
+    os_cond startCnd;       /* Signals the workers that a new generation is to be copied */
+    os_cond readyCnd;       /* Signals the calling thread that all workers are done */
+    os_uint32 generation;   /* Incremented for every parallel copy */
+    os_uint32 busy;         /* Number of workers still copying the current generation */
+    os_boolean terminate;
+};
+
 C_STRUCT(cmn_samplesList) {
     C_STRUCT(cmn_readList) list;
     os_int32               maxSamples;
@@ -711,3 +752,302 @@ cmn_samplesList_read(
 
     return 1;
 }
+
+static void
+parallelCopyRange(
+    cmn_parallelCopy pc)
+{
+    os_uint32 i, end;
+    os_uint32 bufnum;
+    os_uint32 block = pc->heuristics.block;
+    os_uint32 length = pc->copy_info.length;
+    cmn_readBuffer buffer;
+    v_dataReaderSample sample;
+    v_message message;
+
+    while ((i = pa_add32_nv(&pc->copy_info.nextIndex, block) - block) < length) {
+        end = (length - i > block) ? (i + block) : length;
+        for (; i < end; i++) {
+            buffer = pc->copy_info.buffers[i / READBUFFERSIZE];
+            bufnum = i % READBUFFERSIZE;
+            if (pc->copy_info.isView) {
+                sample = v_dataReaderSample(v_dataViewSampleTemplate(buffer->samples[bufnum])->sample);
+            } else {
+                sample = v_dataReaderSample(buffer->samples[bufnum]);
+            }
+            message = v_dataReaderSampleMessage(sample);
+            pc->copy_info.copy_action(C_DISPLACE(message, C_SIZEOF(v_message)),
+                                      &buffer->infos[bufnum], i,
+                                      pc->copy_info.copy_arg);
+        }
+    }
+}
+
+static void *
+parallelCopyWorkerMain(
+    void *arg)
+{
+    cmn_parallelCopy pc = (cmn_parallelCopy)arg;
+    os_uint32 generation;
+
+    os_mutexLock(&pc->mtx);
+    generation = pc->generation;
+    while (!pc->terminate) {
+        if (generation == pc->generation) {
+            os_condWait(&pc->startCnd, &pc->mtx);
+        } else {
+            generation = pc->generation;
+            os_mutexUnlock(&pc->mtx);
+
+            if (u_readerProtectCopyOutEnter(pc->copy_info.reader) == U_RESULT_OK) {
+                v_kernelProtectStrictReadOnlyEnter();
+                parallelCopyRange(pc);
+                v_kernelProtectStrictReadOnlyExit();
+                u_readerProtectCopyOutExit(pc->copy_info.reader);
+            } else {
+                pa_st32(&pc->copy_info.failed, 1);
+            }
+
+            os_mutexLock(&pc->mtx);
+            if (--pc->busy == 0) {
+                os_condSignal(&pc->readyCnd);
+            }
+        }
+    }
+    os_mutexUnlock(&pc->mtx);
+
+    return NULL;
+}
+
+void
+cmn_parallelCopy_free(
+    cmn_parallelCopy _this)
+{
+    os_uint32 i;
+
+    if (_this == NULL) {
+        return;
+    }
+    os_mutexLock(&_this->mtx);
+    _this->terminate = OS_TRUE;
+    os_condBroadcast(&_this->startCnd);
+    os_mutexUnlock(&_this->mtx);
+
+    for (i = 0; i < _this->nrofWorkers; i++) {
+        (void) os_threadWaitExit(_this->tids[i], NULL);
+    }
+    os_condDestroy(&_this->readyCnd);
+    os_condDestroy(&_this->startCnd);
+    os_mutexDestroy(&_this->mtx);
+    os_mutexDestroy(&_this->flushMtx);
+    os_free(_this->copy_info.buffers);
+    os_free(_this->tids);
+    os_free(_this);
+}
+
+cmn_parallelCopy
+cmn_parallelCopy_new(
+    os_uint32 threadCount)
+{
+    cmn_parallelCopy pc;
+    os_threadAttr attr;
+    os_uint32 i;
+
+    if (threadCount <= 1) {
+        return NULL;
+    }
+
+    pc = os_malloc(sizeof(*pc));
+    pc->nrofWorkers = 0;
+    pc->tids = os_malloc((threadCount - 1) * sizeof(*pc->tids));
+    pc->heuristics.threshold = CMN_PARALLELCOPY_THRESHOLD;
+    pc->heuristics.block = CMN_PARALLELCOPY_BLOCK;
+    pa_st32(&pc->copy_info.nextIndex, 0);
+    pa_st32(&pc->copy_info.failed, 0);
+    pc->copy_info.length = 0;
+    pc->copy_info.buffers = NULL;
+    pc->copy_info.maxBuffers = 0;
+    pc->copy_info.isView = OS_FALSE;
+    pc->copy_info.reader = NULL;
+    pc->copy_info.copy_action = NULL;
+    pc->copy_info.copy_arg = NULL;
+    pc->generation = 0;
+    pc->busy = 0;
+    pc->terminate = OS_FALSE;
+
+    if (os_mutexInit(&pc->flushMtx, NULL) != os_resultSuccess) goto err_flushmtx_init;
+    if (os_mutexInit(&pc->mtx, NULL) != os_resultSuccess) goto err_mtx_init;
+    if (os_condInit(&pc->startCnd, &pc->mtx, NULL) != os_resultSuccess) goto err_startcnd_init;
+    if (os_condInit(&pc->readyCnd, &pc->mtx, NULL) != os_resultSuccess) goto err_readycnd_init;
+
+    os_threadAttrInit(&attr);
+    for (i = 0; i < threadCount - 1; i++) {
+        if (os_threadCreate(&pc->tids[i], "parCopyWorker", &attr,
+                            parallelCopyWorkerMain, pc) != os_resultSuccess) {
+            OS_REPORT(OS_WARNING, "cmn_parallelCopy_new", os_resultFail,
+                      "Could not start %u copy-out threads, copying on the reading thread only.",
+                      threadCount - 1);
+            cmn_parallelCopy_free(pc);
+            return NULL;
+        }
+        pc->nrofWorkers++;
+    }
+    return pc;
+
+/* Error-handling */
+err_readycnd_init:
+    (void) os_condDestroy(&pc->startCnd);
+err_startcnd_init:
+    (void) os_mutexDestroy(&pc->mtx);
+err_mtx_init:
+    (void) os_mutexDestroy(&pc->flushMtx);
+err_flushmtx_init:
+    os_free(pc->tids);
+    os_free(pc);
+    return NULL;
+}
+
+os_uint32
+cmn_parallelCopy_threadCount(
+    u_participant uParticipant)
+{
+    os_uint32 count = 0;
+    c_iter nodes = NULL;
+    u_cfElement element = NULL;
+    u_cfNode node = NULL;
+
+    assert (uParticipant != NULL);
+
+    element = u_participantGetConfiguration (uParticipant);
+    if (element != NULL) {
+        nodes = u_cfElementXPath (element, "Domain/DataReaders/ParallelReadThreadCount/#text");
+        if (nodes != NULL) {
+            node = u_cfNode (c_iterTakeFirst (nodes));
+            if (node != NULL) {
+                if (u_cfNodeKind (node) != V_CFDATA || !u_cfDataULongValue (u_cfData(node), &count)) {
+                    OS_REPORT (
+                        OS_WARNING, OS_FUNCTION, OS_RETCODE_BAD_PARAMETER,
+                        "Domain/DataReaders/ParallelReadThreadCount element is invalid.");
+                    count = 0;
+                }
+                u_cfNodeFree (node);
+            }
+
+            for (node = u_cfNode (c_iterTakeFirst (nodes));
+                 node != NULL;
+                 node = u_cfNode (c_iterTakeFirst (nodes)))
+            {
+                u_cfNodeFree (node);
+            }
+            c_iterFree (nodes);
+        }
+        u_cfElementFree (element);
+    }
+
+    return count;
+}
+
+static void
+parallelCopyFlush(
+    cmn_parallelCopy pc,
+    cmn_samplesList list,
+    u_entity reader,
+    cmn_sampleList_indexed_copy_func copy_action,
+    void *copy_arg)
+{
+    os_uint32 i, n;
+    cmn_readBuffer buffer;
+
+    n = (list->list.readBufferLength + READBUFFERSIZE - 1) / READBUFFERSIZE;
+    if (n > pc->copy_info.maxBuffers) {
+        os_free(pc->copy_info.buffers);
+        pc->copy_info.buffers = os_malloc(n * sizeof(*pc->copy_info.buffers));
+        pc->copy_info.maxBuffers = n;
+    }
+    buffer = &list->list.readBuffer;
+    for (i = 0; i < n; i++) {
+        pc->copy_info.buffers[i] = buffer;
+        buffer = buffer->next;
+    }
+
+    os_mutexLock(&pc->mtx);
+    pa_st32(&pc->copy_info.nextIndex, 0);
+    pa_st32(&pc->copy_info.failed, 0);
+    pc->copy_info.length = list->list.readBufferLength;
+    pc->copy_info.isView = list->isView;
+    pc->copy_info.reader = reader;
+    pc->copy_info.copy_action = copy_action;
+    pc->copy_info.copy_arg = copy_arg;
+    pc->busy = pc->nrofWorkers;
+    pc->generation++;
+    os_condBroadcast(&pc->startCnd);
+    os_mutexUnlock(&pc->mtx);
+
+    /* The calling thread is already protected by the caller. */
+    v_kernelProtectStrictReadOnlyEnter();
+    parallelCopyRange(pc);
+    v_kernelProtectStrictReadOnlyExit();
+
+    /* All workers must have finished before the samples are released. */
+    os_mutexLock(&pc->mtx);
+    while (pc->busy > 0) {
+        os_condWait(&pc->readyCnd, &pc->mtx);
+    }
+    os_mutexUnlock(&pc->mtx);
+}
+
+os_int32
+cmn_samplesList_flushIndexed(
+    cmn_samplesList _this,
+    cmn_parallelCopy pc,
+    u_entity reader,
+    cmn_sampleList_indexed_copy_func copy_action,
+    void *copy_arg)
+{
+    os_uint32 length;
+    os_uint32 i;
+    os_int32  r;
+    cmn_readBuffer buffer;
+    v_dataReaderSample sample;
+    v_message message;
+    void *data;
+
+    cmn_readList list = &_this->list;
+
+    assert(copy_action);
+
+    buffer = &list->readBuffer;
+    length = list->readBufferLength;
+    r = (os_int32) length;
+    if (length > 0) {
+        if ((pc != NULL) && (length >= pc->heuristics.threshold) &&
+            (os_mutexTryLock(&pc->flushMtx) == os_resultSuccess)) {
+            parallelCopyFlush(pc, _this, reader, copy_action, copy_arg);
+            if (pa_ld32(&pc->copy_info.failed)) {
+                r = -1;
+            }
+            os_mutexUnlock(&pc->flushMtx);
+        } else {
+            v_kernelProtectStrictReadOnlyEnter();
+            for ( i = 0; i < length; i++ ) {
+                os_uint32 bufnum = i % READBUFFERSIZE;
+                if ((bufnum == 0) && (i > 0)) {
+                    buffer = buffer->next;
+                }
+                if (_this->isView) {
+                    sample = v_dataReaderSample(v_dataViewSampleTemplate(buffer->samples[bufnum])->sample);
+                } else {
+                    sample = v_dataReaderSample(buffer->samples[bufnum]);
+                }
+                message = v_dataReaderSampleMessage(sample);
+                data = C_DISPLACE(message, C_SIZEOF(v_message));
+
+                copy_action(data, &buffer->infos[bufnum], i, copy_arg);
+            }
+            v_kernelProtectStrictReadOnlyExit();
+        }
+        readListFreeContents(list);
+        readListFree(list);
+    }
+    return r;
+}
@@ -39,6 +39,11 @@
  *
  *  cmn_samplesList_read();
  *  cmn_samplesList_flush();
+ *  cmn_samplesList_flushIndexed();
+ *
+ *  cmn_parallelCopy_new();
+ *  cmn_parallelCopy_free();
+ *  cmn_parallelCopy_threadCount();
  *
  *  cmn_samplesList_full();
  *  cmn_samplesList_empty();
@@ -94,6 +99,13 @@ extern "C" {
  */
 C_CLASS(cmn_samplesList);
 
+/** \brief The cmn_parallelCopy module.
+ *
+ * A set of worker threads that cmn_samplesList_flushIndexed() can use to
+ * copy out the samples of a list. A reader keeps one for all its lists.
+ */
+C_CLASS(cmn_parallelCopy);
+
 /** \brief The cmn_sampleInfo structure.
  *
  * This will contain information about the related stored read sample.
@@ -138,6 +150,27 @@ typedef void
         cmn_sampleInfo info,
         void *copy_arg);
 
+/** \brief The indexed sample copy callback function.
+ *
+ * Called by cmn_samplesList_flushIndexed() for every sample within the list.
+ * Because the samples may be copied by several threads at the same time, in
+ * no particular order, the callback gets the position of the sample within
+ * the list and must only write to the destination belonging to that index.
+ *
+ * \param sample   The sample data.
+ * \param info     The sample info.
+ * \param index    Position of the sample within the list.
+ * \param copy_arg The copy_arg provided with the flushIndexed() call.
+ *
+ * \return         void
+ */
+typedef void
+(*cmn_sampleList_indexed_copy_func)(
+        void *sample,
+        cmn_sampleInfo info,
+        os_uint32 index,
+        void *copy_arg);
+
 
 
 /** \brief The class constructor.
@@ -265,6 +298,69 @@ cmn_samplesList_flush2(
     cmn_sampleList_copy_func copy_action,
     void *copy_arg);
 
+/** \brief Read and remove all single samples, possibly in parallel.
+ *
+ * Same as cmn_samplesList_flush(), except that the samples are provided by
+ * a callback to the index aware 'copy_action()'. When 'pc' is not NULL, is
+ * not in use by another flush and the list holds enough samples, the copy is
+ * divided over its worker threads and the calling thread. Otherwise all
+ * samples are copied by the calling thread.
+ *
+ * The caller must have protected the copy by u_readerProtectCopyOutEnter(),
+ * the workers protect themselves with the given reader.
+ *
+ * \param _this       The sampleList.
+ * \param pc          The worker threads to use, or NULL.
+ * \param reader      The user reader that owns the samples.
+ * \param copy_action The copy callback function.
+ * \param copy_arg    The argument passed along with the copy_action calls.
+ *
+ * \return os_int32   The number of read samples or -1 when a worker failed
+ *                    to protect the copy.
+ */
+OS_API os_int32
+cmn_samplesList_flushIndexed(
+    cmn_samplesList _this,
+    cmn_parallelCopy pc,
+    u_entity reader,
+    cmn_sampleList_indexed_copy_func copy_action,
+    void *copy_arg);
+
+/** \brief Start the worker threads for parallel copy-out.
+ *
+ * The calling thread of a flush participates, so 'threadCount'-1 worker
+ * threads are started. They stay alive until cmn_parallelCopy_free().
+ *
+ * \param threadCount The total number of copying threads.
+ *
+ * \return The new cmn_parallelCopy, or NULL when 'threadCount' is 0 or 1 or
+ *         when the worker threads could not be started.
+ */
+OS_API cmn_parallelCopy
+cmn_parallelCopy_new(
+    os_uint32 threadCount);
+
+/** \brief Stop the worker threads and free the cmn_parallelCopy.
+ *
+ * \param _this The cmn_parallelCopy, may be NULL.
+ */
+OS_API void
+cmn_parallelCopy_free(
+    cmn_parallelCopy _this);
+
+/** \brief Get the configured number of copy-out threads per reader.
+ *
+ * Reads Domain/DataReaders/ParallelReadThreadCount from the configuration
+ * of the participant's domain.
+ *
+ * \param uParticipant The participant.
+ *
+ * \return The configured thread count, 0 when not configured.
+ */
+OS_API os_uint32
+cmn_parallelCopy_threadCount(
+    u_participant uParticipant);
+
 /** \brief Check if the list is full.
  *
  * Check if the given sampleList is full.
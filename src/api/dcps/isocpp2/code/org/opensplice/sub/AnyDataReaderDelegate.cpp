@@ -61,12 +61,13 @@ struct ReaderCopyInfo {
 AnyDataReaderDelegate::AnyDataReaderDelegate(
         const dds::sub::qos::DataReaderQos& qos,
         const dds::topic::TopicDescription& td)
-    : copyIn(NULL), copyOut(NULL), qos_(qos), td_(td)
+    : copyIn(NULL), copyOut(NULL), qos_(qos), td_(td), parallelCopy_(NULL)
 {
 }
 
 AnyDataReaderDelegate::~AnyDataReaderDelegate()
 {
+    cmn_parallelCopy_free(this->parallelCopy_);
 }
 
 const dds::topic::TopicDescription&
@@ -240,8 +241,7 @@ AnyDataReaderDelegate::read(
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderRead failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(reader), samples);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -274,8 +274,7 @@ AnyDataReaderDelegate::take(
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderTake failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(reader), samples);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -312,8 +311,7 @@ AnyDataReaderDelegate::read_instance(
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderReadInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(reader), samples);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -349,8 +347,7 @@ AnyDataReaderDelegate::take_instance(
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderTakeInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(reader), samples);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -386,8 +383,7 @@ AnyDataReaderDelegate::read_next_instance(
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderReadNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(reader), samples);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -423,8 +419,7 @@ AnyDataReaderDelegate::take_next_instance(
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderTakeNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(reader), samples);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -456,8 +451,7 @@ AnyDataReaderDelegate::read_w_condition(
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryRead failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(query), samples);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -487,8 +481,7 @@ AnyDataReaderDelegate::take_w_condition(
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTake failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(query), samples);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -519,8 +512,7 @@ AnyDataReaderDelegate::read_instance_w_condition(
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryReadInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(query), samples);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -551,8 +543,7 @@ AnyDataReaderDelegate::take_instance_w_condition(
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTakeInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(query), samples);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -584,8 +575,7 @@ AnyDataReaderDelegate::read_next_instance_w_condition(
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryReadNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(query), samples);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -616,8 +606,7 @@ AnyDataReaderDelegate::take_next_instance_w_condition(
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTakeNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = flush(cmnSampleList, u_entity(query), samples);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -879,6 +868,9 @@ AnyDataReaderDelegate::close()
 {
     this->queries.all_close();
 
+    cmn_parallelCopy_free(this->parallelCopy_);
+    this->parallelCopy_ = NULL;
+
     org::opensplice::core::EntityDelegate::close();
 }
 
@@ -940,6 +932,47 @@ AnyDataReaderDelegate::flush_action(
     flushArgs->samples++;
 }
 
+void
+AnyDataReaderDelegate::flush_action_indexed(
+    void *sample,
+    cmn_sampleInfo sampleInfo,
+    os_uint32 index,
+    void *args)
+{
+    FlushActionArguments *flushArgs = (FlushActionArguments *) args;
+
+    flushArgs->reader.copyOut(sample, flushArgs->samples.data_at(index));
+    copy_sample_info(sampleInfo, flushArgs->samples.info_at(index));
+}
+
+int32_t
+AnyDataReaderDelegate::flush(
+    cmn_samplesList samplesList,
+    u_entity reader,
+    dds::sub::detail::SamplesHolder& samples)
+{
+    FlushActionArguments flushArgs = {*this, samples};
+    int32_t length;
+
+    /* Only holders with random access can be filled by several threads. */
+    if (samples.indexed()) {
+        length = cmn_samplesList_flushIndexed(samplesList, this->parallelCopy_, reader, flush_action_indexed, &flushArgs);
+        if (length > 0) {
+            samples.set_index((uint32_t)length);
+        }
+    } else {
+        length = cmn_samplesList_flush(samplesList, flush_action, &flushArgs);
+    }
+    return length;
+}
+
+void
+AnyDataReaderDelegate::parallel_copy_init(
+    u_participant participant)
+{
+    this->parallelCopy_ = cmn_parallelCopy_new(cmn_parallelCopy_threadCount(participant));
+}
+
 v_copyin_result
 AnyDataReaderDelegate::copy_key(c_type t, const void *data, void *to)
 {
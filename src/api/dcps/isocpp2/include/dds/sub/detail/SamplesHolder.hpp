@@ -69,6 +69,26 @@ public:
         return (*this->samples_.delegate())[this->index].delegate().info_ptr();
     }
 
+    bool indexed() const
+    {
+        return true;
+    }
+
+    void *data_at(uint32_t i)
+    {
+        return (*this->samples_.delegate())[i].delegate().data_ptr();
+    }
+
+    detail::SampleInfo* info_at(uint32_t i)
+    {
+        return (*this->samples_.delegate())[i].delegate().info_ptr();
+    }
+
+    void set_index(uint32_t i)
+    {
+        this->index = i;
+    }
+
 private:
     dds::sub::LoanedSamples<T>& samples_;
     uint32_t index;
@@ -605,6 +605,8 @@ dds::sub::detail::DataReader<T>::common_constructor(
     this->AnyDataReaderDelegate::setCopyIn(org::opensplice::topic::TopicTraits<T>::getCopyIn());
 
     this->userHandle = u_object(uReader);
+    this->AnyDataReaderDelegate::parallel_copy_init(
+            u_participant(this->sub_.delegate()->participant().delegate()->get_user_handle()));
     this->listener_set((void*)listener, mask);
     this->set_domain_id(this->sub_.delegate()->get_domain_id());
 }
@@ -90,6 +90,12 @@ public:
     virtual SamplesHolder& operator++(int) = 0;
     virtual void *data() = 0;
     virtual detail::SampleInfo* info() = 0;
+
+    /* Random access, for holders that are filled by several threads. */
+    virtual bool indexed() const { return false; }
+    virtual void *data_at(uint32_t) { return NULL; }
+    virtual detail::SampleInfo* info_at(uint32_t) { return NULL; }
+    virtual void set_index(uint32_t) {}
 };
 
 }
@@ -254,6 +260,8 @@ public:
     u_instanceHandle lookup_instance(
             const u_dataReader reader, const void *key) const;
 
+    void parallel_copy_init(u_participant participant);
+
     void close();
 
 private:
@@ -267,6 +275,8 @@ private:
     } FlushActionArguments;
 
     static void flush_action(void *sample, cmn_sampleInfo sampleInfo, void *args);
+    static void flush_action_indexed(void *sample, cmn_sampleInfo sampleInfo, os_uint32 index, void *args);
+    int32_t flush(cmn_samplesList samplesList, u_entity reader, dds::sub::detail::SamplesHolder& samples);
     static void copy_sample_info(cmn_sampleInfo from, dds::sub::SampleInfo *to);
     static v_copyin_result copy_key(c_type t, const void *data, void *to);
 
@@ -277,6 +287,8 @@ protected:
     dds::sub::qos::DataReaderQos qos_;
     dds::topic::TopicDescription td_;
 
+private:
+    cmn_parallelCopy parallelCopy_;
 };
 
 
@@ -0,0 +1,320 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+package org.opensplice.dds.dcps;
+
+import org.omg.CORBA.NO_IMPLEMENT;
+import org.omg.CORBA.BAD_PARAM;
+
+/**
+ * Big-endian CDR OutputStream for the Helper.write() operations of the
+ * CORBA cohabitation types, writing directly into a reusable direct
+ * ByteBuffer so that CDR copy-in does not allocate per sample. Only the
+ * types that can occur in DDS topics are supported.
+ */
+public final class CDROutputStream extends org.omg.CORBA.portable.OutputStream
+    implements CDROutputBuffer
+{
+    private static final int INITIAL_CAPACITY = 4096;
+
+    private java.nio.ByteBuffer buf;
+
+    public CDROutputStream()
+    {
+        buf = java.nio.ByteBuffer.allocateDirect(INITIAL_CAPACITY);
+    }
+
+    @Override
+    public void reset()
+    {
+        buf.clear();
+    }
+
+    @Override
+    public java.nio.ByteBuffer getByteBuffer()
+    {
+        return buf;
+    }
+
+    @Override
+    public int size()
+    {
+        return buf.position();
+    }
+
+    private void reserve(int n)
+    {
+        if (buf.remaining() < n) {
+            int cap = Math.max(2 * buf.capacity(), buf.position() + n);
+            java.nio.ByteBuffer nbuf = java.nio.ByteBuffer.allocateDirect(cap);
+            buf.flip();
+            nbuf.put(buf);
+            buf = nbuf;
+        }
+    }
+
+    /* Aligns to a (a power of two) and makes room for n bytes after that */
+    private void align(int a, int n)
+    {
+        int pad = (a - (buf.position() & (a - 1))) & (a - 1);
+        reserve(pad + n);
+        while (pad-- > 0) {
+            buf.put((byte)0);
+        }
+    }
+
+    @Override
+    public org.omg.CORBA.portable.InputStream create_input_stream()
+    {
+        throw new NO_IMPLEMENT();
+    }
+
+    @Override
+    public void write_boolean(boolean value)
+    {
+        reserve(1);
+        buf.put(value ? (byte)1 : (byte)0);
+    }
+
+    @Override
+    public void write_char(char value)
+    {
+        reserve(1);
+        buf.put((byte)value);
+    }
+
+    @Override
+    public void write_wchar(char value)
+    {
+        throw new NO_IMPLEMENT("wchar");
+    }
+
+    @Override
+    public void write_octet(byte value)
+    {
+        reserve(1);
+        buf.put(value);
+    }
+
+    @Override
+    public void write_short(short value)
+    {
+        align(2, 2);
+        buf.putShort(value);
+    }
+
+    @Override
+    public void write_ushort(short value)
+    {
+        write_short(value);
+    }
+
+    @Override
+    public void write_long(int value)
+    {
+        align(4, 4);
+        buf.putInt(value);
+    }
+
+    @Override
+    public void write_ulong(int value)
+    {
+        write_long(value);
+    }
+
+    @Override
+    public void write_longlong(long value)
+    {
+        align(8, 8);
+        buf.putLong(value);
+    }
+
+    @Override
+    public void write_ulonglong(long value)
+    {
+        write_longlong(value);
+    }
+
+    @Override
+    public void write_float(float value)
+    {
+        align(4, 4);
+        buf.putFloat(value);
+    }
+
+    @Override
+    public void write_double(double value)
+    {
+        align(8, 8);
+        buf.putDouble(value);
+    }
+
+    @Override
+    public void write_string(String value)
+    {
+        int i, n;
+
+        if (value == null) {
+            throw new BAD_PARAM("null string");
+        }
+        n = value.length();
+        align(4, 4 + n + 1);
+        buf.putInt(n + 1);
+        for (i = 0; i < n; i++) {
+            buf.put((byte)value.charAt(i));
+        }
+        buf.put((byte)0);
+    }
+
+    @Override
+    public void write_wstring(String value)
+    {
+        throw new NO_IMPLEMENT("wstring");
+    }
+
+    @Override
+    public void write_boolean_array(boolean[] value, int offset, int length)
+    {
+        int i;
+        reserve(length);
+        for (i = 0; i < length; i++) {
+            buf.put(value[offset + i] ? (byte)1 : (byte)0);
+        }
+    }
+
+    @Override
+    public void write_char_array(char[] value, int offset, int length)
+    {
+        int i;
+        reserve(length);
+        for (i = 0; i < length; i++) {
+            buf.put((byte)value[offset + i]);
+        }
+    }
+
+    @Override
+    public void write_wchar_array(char[] value, int offset, int length)
+    {
+        throw new NO_IMPLEMENT("wchar");
+    }
+
+    @Override
+    public void write_octet_array(byte[] value, int offset, int length)
+    {
+        reserve(length);
+        buf.put(value, offset, length);
+    }
+
+    @Override
+    public void write_short_array(short[] value, int offset, int length)
+    {
+        int i;
+        if (length > 0) {
+            align(2, 2 * length);
+            for (i = 0; i < length; i++) {
+                buf.putShort(value[offset + i]);
+            }
+        }
+    }
+
+    @Override
+    public void write_ushort_array(short[] value, int offset, int length)
+    {
+        write_short_array(value, offset, length);
+    }
+
+    @Override
+    public void write_long_array(int[] value, int offset, int length)
+    {
+        int i;
+        if (length > 0) {
+            align(4, 4 * length);
+            for (i = 0; i < length; i++) {
+                buf.putInt(value[offset + i]);
+            }
+        }
+    }
+
+    @Override
+    public void write_ulong_array(int[] value, int offset, int length)
+    {
+        write_long_array(value, offset, length);
+    }
+
+    @Override
+    public void write_longlong_array(long[] value, int offset, int length)
+    {
+        int i;
+        if (length > 0) {
+            align(8, 8 * length);
+            for (i = 0; i < length; i++) {
+                buf.putLong(value[offset + i]);
+            }
+        }
+    }
+
+    @Override
+    public void write_ulonglong_array(long[] value, int offset, int length)
+    {
+        write_longlong_array(value, offset, length);
+    }
+
+    @Override
+    public void write_float_array(float[] value, int offset, int length)
+    {
+        int i;
+        if (length > 0) {
+            align(4, 4 * length);
+            for (i = 0; i < length; i++) {
+                buf.putFloat(value[offset + i]);
+            }
+        }
+    }
+
+    @Override
+    public void write_double_array(double[] value, int offset, int length)
+    {
+        int i;
+        if (length > 0) {
+            align(8, 8 * length);
+            for (i = 0; i < length; i++) {
+                buf.putDouble(value[offset + i]);
+            }
+        }
+    }
+
+    @Override
+    public void write_Object(org.omg.CORBA.Object value)
+    {
+        throw new NO_IMPLEMENT("Object");
+    }
+
+    @Override
+    public void write_TypeCode(org.omg.CORBA.TypeCode value)
+    {
+        throw new NO_IMPLEMENT("TypeCode");
+    }
+
+    @Override
+    public void write_any(org.omg.CORBA.Any value)
+    {
+        throw new NO_IMPLEMENT("any");
+    }
+}
@@ -22,6 +22,7 @@
 #include "saj__exception.h"
 
 #include "c_base.h"
+#include "sd_cdr.h"
 
 #include "vortex_os.h"
 #include "os_report.h"
@@ -4609,3 +4610,27 @@ saj_copyInStruct (
     }
     return result;
 }
+
+os_int32
+saj_CDRInStruct (
+    c_base base,
+    const void *src,
+    void *dst)
+{
+    saj_cdrSrcInfo srcInfo = (saj_cdrSrcInfo)src;
+    os_int32 result;
+    int rc;
+
+    OS_UNUSED_ARG(base);
+
+    rc = sd_cdrDeserializeRawBE(dst, saj_copyCacheCdrInfo(srcInfo->copyProgram),
+                                srcInfo->size, srcInfo->blob);
+    if (rc >= 0) {
+        result = OS_RETCODE_OK;
+    } else if (rc == SD_CDR_OUT_OF_MEMORY) {
+        result = OS_RETCODE_OUT_OF_RESOURCES;
+    } else {
+        result = OS_RETCODE_BAD_PARAMETER;
+    }
+    return result;
+}
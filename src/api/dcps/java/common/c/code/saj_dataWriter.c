@@ -80,6 +80,26 @@ SAJ_FUNCTION(jniDataWriterNew) (
     return 0;
 }
 
+/*
+ * Method: jniPrepareCDRCopy
+ * Param : -
+ * Return: return code
+ */
+JNIEXPORT jint JNICALL
+SAJ_FUNCTION(jniPrepareCDRCopy) (
+    JNIEnv  *env,
+    jobject this)
+{
+    saj_returnCode retcode;
+
+    retcode = saj_prepare_CDRCopy(env, this);
+    if (retcode != SAJ_RETCODE_OK) {
+        retcode = SAJ_RETCODE_UNSUPPORTED;
+        SAJ_REPORT(retcode, "CDRCopy is not supported for this type.");
+    }
+    return (jint)retcode;
+}
+
 JNIEXPORT jint JNICALL
 SAJ_FUNCTION(jniDataWriterFree) (
     JNIEnv  *env,
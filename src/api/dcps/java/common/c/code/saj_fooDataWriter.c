@@ -59,6 +59,28 @@ copyAction(
     return result;
 }
 
+static v_copyin_result
+CDRCopyAction(
+    c_type type,
+    const void *data,
+    void *to)
+{
+    v_copyin_result result;
+
+    switch (saj_CDRInStruct(c_getBase(type), data, to)) {
+    case OS_RETCODE_OK:
+        result = V_COPYIN_RESULT_OK;
+        break;
+    case OS_RETCODE_OUT_OF_RESOURCES:
+        result = V_COPYIN_RESULT_OUT_OF_MEMORY;
+        break;
+    default:
+        result = V_COPYIN_RESULT_INVALID;
+        break;
+    }
+    return result;
+}
+
 static u_bool
 copyKeyAction(
     void *data,
@@ -211,6 +233,58 @@ SAJ_FUNCTION(jniWrite) (
     return (jint)retcode;
 }
 
+/*
+ * Class:     org_opensplice_dds_dcps_FooDataWriterImpl
+ * Method:    jniWriteCDR
+ * Signature: (JJLjava/nio/ByteBuffer;IJLDDS/Time_t;)I
+ */
+/*
+    private native static int jniWriteCDR (
+        long uWriter,
+        long copyCache,
+        java.nio.ByteBuffer cdr,
+        int length,
+        long handle,
+        DDS.Time_t source_timestamp);
+*/
+JNIEXPORT jint JNICALL
+SAJ_FUNCTION(jniWriteCDR) (
+    JNIEnv *env,
+    jclass object,
+    jlong uWriter,
+    jlong copyCache,
+    jobject cdr,
+    jint length,
+    jlong handle,
+    jobject source_timestamp)
+{
+    u_result uResult;
+    saj_returnCode retcode = SAJ_RETCODE_OK;
+    os_timeW timestamp;
+    C_STRUCT(saj_cdrSrcInfo) srcInfo;
+
+    assert (copyCache != 0);
+    OS_UNUSED_ARG(object);
+
+    srcInfo.blob = (cdr != NULL) ? (*env)->GetDirectBufferAddress(env, cdr) : NULL;
+    if ((srcInfo.blob != NULL) && (length >= 0) &&
+        ((jlong)length <= (*env)->GetDirectBufferCapacity(env, cdr))) {
+        srcInfo.size = (os_uint32)length;
+        srcInfo.copyProgram = (saj_copyCache)(PA_ADDRCAST)copyCache;
+        retcode = saj_timeCopyIn (env, source_timestamp, &timestamp);
+        if (retcode == SAJ_RETCODE_OK) {
+            uResult = u_writerWrite(SAJ_VOIDP(uWriter), CDRCopyAction, &srcInfo,
+                                    timestamp, (u_instanceHandle)handle);
+            retcode = saj_retcode_from_user_result(uResult);
+        }
+    } else {
+        retcode = SAJ_RETCODE_BAD_PARAMETER;
+        SAJ_REPORT(retcode, "CDR buffer is invalid.");
+    }
+
+    return (jint)retcode;
+}
+
 /*
  * Class:     org_opensplice_dds_dcps_FooDataWriterImpl
  * Method:    jniDispose
@@ -1306,10 +1306,10 @@ saj_read_parallelDemarshallingContext_address(
     CATCH_EXCEPTION: return SAJ_RETCODE_ERROR;
 }
 
-static saj_returnCode saj_prepare_CDRCopy (JNIEnv *env, jobject obj)
+saj_returnCode saj_prepare_CDRCopy (JNIEnv *env, jobject obj)
 {
-    /* obj is an instance of <Type>DataReaderImpl, I'm pretty sure. That
-     * one has a "private long copyCache" containing the address of the
+    /* obj is an instance of <Type>DataReaderImpl or <Type>DataWriterImpl.
+     * Both have a "private long copyCache" containing the address of the
      * relevant copyCache.
      */
     jclass objClass;
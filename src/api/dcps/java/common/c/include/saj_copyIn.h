@@ -49,6 +49,20 @@ saj_copyInStruct (
     c_base base,
     const void *src,
     void *dst);
+
+C_CLASS(saj_cdrSrcInfo);
+
+C_STRUCT(saj_cdrSrcInfo) {
+    const void *blob;
+    os_uint32 size;
+    saj_copyCache copyProgram;
+};
+
+OS_API os_int32
+saj_CDRInStruct (
+    c_base base,
+    const void *src,
+    void *dst);
     
 #undef OS_API
 
@@ -1046,6 +1046,11 @@ saj_write_CDRCopy_value(
     jobject java_object,
     long value);
 
+saj_returnCode
+saj_prepare_CDRCopy(
+    JNIEnv *env,
+    jobject java_object);
+
 c_bool
 saj_setThreadEnv(
     JNIEnv *env);
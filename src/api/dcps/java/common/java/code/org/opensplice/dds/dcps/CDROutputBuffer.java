@@ -0,0 +1,38 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+package org.opensplice.dds.dcps;
+
+/**
+ * Destination of CDR copy-in (see DataWriterImpl.setCDRCopy): a CORBA
+ * OutputStream that marshals into a direct ByteBuffer which is reused
+ * between writes. Implemented by CDROutputStream, which is only available
+ * with CORBA cohabitation.
+ */
+interface CDROutputBuffer {
+    /** Discards the contents, the buffer is kept. */
+    void reset();
+
+    /** The buffer holding the marshalled data, from offset 0. */
+    java.nio.ByteBuffer getByteBuffer();
+
+    /** Number of bytes marshalled since the last reset(). */
+    int size();
+}
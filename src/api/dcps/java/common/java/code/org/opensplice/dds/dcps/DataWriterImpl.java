@@ -32,6 +32,15 @@ public class DataWriterImpl extends DataWriterBase implements DDS.DataWriter {
     private TopicImpl topic;
     private DDS.DataWriterListener listener = null;
 
+    /**
+     * If true, write() marshals the sample to CDR in Java and hands it to
+     * the native layer in a single JNI call instead of one JNI call per
+     * field. Enabled by means of setCDRCopy(...) on the writer. */
+    private boolean CDRCopy = false;
+    private final Object CDRLock = new Object();
+    private java.lang.reflect.Method CDRHelperWrite;
+    private CDROutputBuffer CDRStream;
+
     protected DataWriterImpl() { }
 
     protected int init (
@@ -440,6 +449,125 @@ public class DataWriterImpl extends DataWriterBase implements DDS.DataWriter {
         return result;
     }
 
+    /**
+     * Enables or disables CDR copy-in for write() and write_w_timestamp().
+     * CDR copy requires the CORBA cohabitation Helper of the type.
+     */
+    public int setCDRCopy(boolean enable)
+    {
+        int result = DDS.RETCODE_OK.value;
+        ReportStack.start();
+
+        synchronized (CDRLock) {
+            if (enable) {
+                if (!CDRCopySetupHelper()) {
+                    result = DDS.RETCODE_UNSUPPORTED.value;
+                    ReportStack.report(result, "CDRCopy is not supported for this type.");
+                } else {
+                    result = jniPrepareCDRCopy();
+                }
+            }
+            if (result == DDS.RETCODE_OK.value) {
+                CDRCopy = enable;
+            }
+        }
+
+        ReportStack.flush(this, result != DDS.RETCODE_OK.value);
+        return result;
+    }
+
+    /**
+     * Resolves the write method for serializing the sample to CDR and
+     * creates the stream it writes to, both are kept for the lifetime of
+     * the writer. Mirrors DataReaderImpl.CDRCopySetupHelper().
+     */
+    @SuppressWarnings({ "rawtypes", "unchecked" })
+    private boolean CDRCopySetupHelper() {
+        try {
+            if (CDRHelperWrite == null) {
+                String name = this.getClass().getName();
+                if (!name.endsWith("DataWriterImpl")) {
+                    ReportStack.report(DDS.RETCODE_ERROR.value,
+                        "CDRCopySetupHelper unexpected class name: " + name);
+                    return false;
+                }
+                String helperName = name.substring(0, name.length()-14).concat("Helper");
+                Class helperClass = Class.forName(helperName);
+                Class absOsClass = Class.forName("org.omg.CORBA.portable.OutputStream");
+                /* Only part of the CORBA cohabitation jar */
+                Class osClass = Class.forName("org.opensplice.dds.dcps.CDROutputStream");
+                java.lang.reflect.Method write = null;
+                for (java.lang.reflect.Method m : helperClass.getMethods()) {
+                    Class[] params = m.getParameterTypes();
+                    if (m.getName().equals("write") && params.length == 2 &&
+                        params[0].equals(absOsClass)) {
+                        write = m;
+                    }
+                }
+                if (write == null) {
+                    return false;
+                }
+                CDRStream = (CDROutputBuffer)osClass.getConstructor().newInstance();
+                CDRHelperWrite = write;
+            }
+            return true;
+        } catch(Exception e) {
+            e.printStackTrace(System.out);
+            CDRHelperWrite = null;
+            CDRStream = null;
+            return false;
+        }
+    }
+
+    /**
+     * Serializes the sample into CDRStream, which is reused between
+     * writes. Returns the length of the serialized sample or -1 on
+     * failure. Must be called with CDRLock held.
+     */
+    private int CDRSerializeByteBuffer(Object instance_data)
+    {
+        CDRStream.reset();
+        try {
+            CDRHelperWrite.invoke(null, CDRStream, instance_data);
+        } catch(Exception e) {
+            ReportStack.report(DDS.RETCODE_ERROR.value,
+                "CDRSerializeByteBuffer: " + e.toString());
+            return -1;
+        }
+        return CDRStream.size();
+    }
+
+    /**
+     * Used by the generated write operations, takes the CDR path when it
+     * is enabled on this writer.
+     */
+    protected int writeSample(
+        long uWriter,
+        long copyCache,
+        Object instance_data,
+        long handle,
+        DDS.Time_t source_timestamp)
+    {
+        int result;
+
+        if (!CDRCopy) {
+            result = FooDataWriterImpl.jniWrite(
+                        uWriter, copyCache, instance_data, handle, source_timestamp);
+        } else {
+            synchronized (CDRLock) {
+                int length = CDRSerializeByteBuffer(instance_data);
+                if (length < 0) {
+                    result = DDS.RETCODE_ERROR.value;
+                } else {
+                    result = FooDataWriterImpl.jniWriteCDR(
+                        uWriter, copyCache, CDRStream.getByteBuffer(), length, handle, source_timestamp);
+                }
+            }
+        }
+        return result;
+    }
+
+    private native int jniPrepareCDRCopy();
     private native long jniDataWriterNew(long uPublisher, String name, long uTopic, DDS.DataWriterQos qos);
     private native int jniDataWriterFree(long uWriter);
 
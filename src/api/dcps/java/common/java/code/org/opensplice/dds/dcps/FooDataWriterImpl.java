@@ -47,6 +47,14 @@ public abstract class FooDataWriterImpl extends org.opensplice.dds.dcps.DataWrit
         long handle,
         DDS.Time_t source_timestamp);
 
+    public native static int jniWriteCDR (
+        long uWriter,
+        long copyCache,
+        java.nio.ByteBuffer cdr,
+        int length,
+        long handle,
+        DDS.Time_t source_timestamp);
+
     public native static int jniDispose (
         long uWriter,
         long copyCache,
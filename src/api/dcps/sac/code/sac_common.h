@@ -564,6 +564,7 @@ C_STRUCT(_DataReader)
     c_iter                dataReaderViewList;
     DDS_LoanRegistry      loanRegistry;
     cmn_samplesList       samplesList;
+    cmn_parallelCopy      parallelCopy;
 };
 
 C_STRUCT(_DataReaderView) {
@@ -188,6 +188,7 @@ _DataReader_deinit (
         c_iterFree(reader->readConditionList);
         DDS_LoanRegistry_free(reader->loanRegistry);
         cmn_samplesList_free(reader->samplesList);
+        cmn_parallelCopy_free(reader->parallelCopy);
         _Entity_deinit(_this);
     }
     return result;
@@ -215,9 +216,12 @@ _DataReader_samples_flush_copy(
         arg.seqIndex       = 0;
         result = DDS_ReturnCode_get(u_readerProtectCopyOutEnter(uEntity));
         if (result == DDS_RETCODE_OK) {
-            testlength = (DDS_long) cmn_samplesList_flush(samplesList, DDS_ReaderCommon_samples_flush_copy, &arg);
+            testlength = (DDS_long) cmn_samplesList_flushIndexed(samplesList, _this->parallelCopy, uEntity, DDS_ReaderCommon_samples_flush_copy_indexed, &arg);
             if (testlength < 0) {
                 result = DDS_RETCODE_ALREADY_DELETED;
+            } else {
+                data_seq->_length = (DDS_unsigned_long) testlength;
+                info_seq->_length = (DDS_unsigned_long) testlength;
             }
             u_readerProtectCopyOutExit(uEntity);
             assert((result != DDS_RETCODE_OK) || (length == testlength));
@@ -315,10 +319,25 @@ DDS_DataReaderNew (
         _this->copy_out = DDS_TypeSupportCopyOut (typeSupport);
         _this->copy_cache = DDS_TypeSupportCopyCache (typeSupport);
         _this->samplesList = cmn_samplesList_new(FALSE);
+        _this->parallelCopy = cmn_parallelCopy_new(cmn_parallelCopy_threadCount(
+                u_participant(_Entity_get_user_entity(_Subscriber(subscriber)->participant))));
     }
     return (DDS_DataReader)_this;
 }
 
+void *
+DDS_DataReader_get_parallel_copy (
+    DDS_DataReader _this)
+{
+    _DataReader reader;
+    cmn_parallelCopy pc = NULL;
+
+    if (DDS_DataReaderCheck(_this, &reader) == DDS_RETCODE_OK) {
+        pc = reader->parallelCopy;
+    }
+    return pc;
+}
+
 DDS_ReturnCode_t
 DDS_DataReaderFree (
     DDS_DataReader _this)
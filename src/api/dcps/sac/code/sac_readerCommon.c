@@ -148,3 +148,34 @@ DDS_ReaderCommon_samples_flush_copy(
     dataSeq->_length = a->seqIndex;
     infoSeq->_length = a->seqIndex;
 }
+
+/* Variant of DDS_ReaderCommon_samples_flush_copy for cmn_samplesList_flushIndexed.
+ * The samples may be copied concurrently and out of order, so the sequence
+ * lengths are left to the caller.
+ */
+void
+DDS_ReaderCommon_samples_flush_copy_indexed(
+    void * sample,
+    cmn_sampleInfo sampleInfo,
+    os_uint32 index,
+    void *arg)
+{
+    struct flushCopyArg *a = (struct flushCopyArg *)arg;
+    _DataReader reader = a->reader;
+    DDS_unsigned_long typeSize;
+    C_STRUCT(DDS_dstInfo) dstInfo;
+    void *dst;
+
+    typeSize = DDS_LoanRegistry_typeSize(reader->loanRegistry);
+    dst = &((char*)a->data_seq->_buffer)[index*typeSize];
+    if (reader->copy_cache != NULL) {
+        dstInfo.dst         = dst;
+        dstInfo.buf         = a->data_seq->_buffer;
+        dstInfo.copyProgram = reader->copy_cache;
+        reader->copy_out(sample, &dstInfo);
+    } else {
+        reader->copy_out(sample, dst);
+    }
+
+    _ReaderCommon_info_copy(sampleInfo, &(a->info_seq->_buffer[index]));
+}
@@ -46,6 +46,13 @@ DDS_ReaderCommon_samples_flush_copy(
     cmn_sampleInfo     sampleInfo,
     void              *arg);
 
+void
+DDS_ReaderCommon_samples_flush_copy_indexed(
+    void              *sample,
+    cmn_sampleInfo     sampleInfo,
+    os_uint32          index,
+    void              *arg);
+
 DDS_ReturnCode_t
 DDS_ReaderCommon_check_read_args(
     _DDS_sequence data_seq,
@@ -139,6 +139,15 @@ OS_API u_object
 DDS_Condition_get_user_object_for_test (
     DDS_Condition _this);
 
+/**
+ * Returns the cmn_parallelCopy of the reader, which the C99 API uses to
+ * copy out samples on the threads configured by
+ * Domain/DataReaders/ParallelReadThreadCount. NULL when not configured.
+ */
+OS_API void *
+DDS_DataReader_get_parallel_copy (
+    DDS_DataReader _this);
+
 OS_API const DDS_char *
 DDS_ReturnCode_image(
     DDS_ReturnCode_t code);
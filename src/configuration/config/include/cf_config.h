@@ -61,6 +61,7 @@ extern "C" {
 #define CFG_REPORT        "Report"
 #define CFG_IN_PROC_EXC   "InProcessExceptionHandling"
 #define CFG_MAINTAINOBJECTCOUNT "MaintainObjectCount"
+#define CFG_ALLOCSAMPLEINTERVAL "AllocationSampleInterval"
 #define CFG_Y2038READY    "y2038_ready"
 #define CFG_SERVICE       "Service"
 #define CFG_COMMAND       "Command"
@@ -110,14 +110,48 @@ C_STRUCT(c_baseCache) {
     C_STRUCT(c_typeCache) typeCache;
 };
 
+C_CLASS(c_baseAllocSite);
+C_CLASS(c_baseAllocProfile);
+
+/* Number of distinct types the allocation profile can hold, must be a
+ * power of two. Samples of types that do not fit are counted as dropped.
+ */
+#define C_BASE_ALLOCPROFILE_SIZE (1024)
+
+/* Aggregated samples for one type. Slots are claimed on the first sample
+ * of a type and never released, so tools may keep per-slot history.
+ */
+C_STRUCT(c_baseAllocSite) {
+    pa_voidp_t  type;    /* c_type of the sampled objects, NULL if unused */
+    pa_uint32_t count;   /* number of sampled allocations */
+    pa_uint32_t live;    /* number of sampled allocations not yet freed */
+    pa_uint32_t bytes;   /* accumulated size of the sampled allocations, low word */
+    pa_uint32_t bytesHi; /* high word of bytes, incremented when bytes wraps */
+};
+
+/* Sampling allocation profile, allocated in the database so that tools
+ * such as mmstat can read it while the system is running.
+ */
+C_STRUCT(c_baseAllocProfile) {
+    os_uint32   interval; /* approximately one in interval allocations is sampled */
+    pa_uint32_t samples;  /* total number of samples taken */
+    pa_uint32_t dropped;  /* samples that did not fit in the site table */
+    C_STRUCT(c_baseAllocSite) sites[C_BASE_ALLOCPROFILE_SIZE];
+};
+
 C_STRUCT(c_base) {
     C_EXTENDS(c_module);
     c_mm      mm;
     c_bool    maintainObjectCount;
+    pa_voidp_t allocProfile; /* c_baseAllocProfile, NULL if sampling is disabled */
     c_bool    y2038Ready;
     c_long    confidence;
     ut_avlTree_t bindings;
     c_mutex   bindLock;
+    ut_avlTree_t internedStrings;
+    c_mutex   internLock;
+    ut_avlTree_t typeDescriptors;
+    c_mutex   typeDescriptorLock;
     c_mutex   serLock; /* currently only used for defining enums from sd_serializerXMLTypeinfo.c */
     c_type    metaType[M_COUNT];
     c_type    string_type;
@@ -139,6 +173,17 @@ C_STRUCT(c_baseBinding) {
     c_char  *name;
 };
 
+C_STRUCT(c_baseInternedString) {
+    ut_avlNode_t avlnode;
+    c_string string;
+};
+
+C_STRUCT(c_baseTypeDescriptor) {
+    ut_avlNode_t avlnode;
+    os_uint64 hash;
+    c_string descriptor;
+};
+
 /** @fn c_getMetaType (c_base base, c_metaKind kind)
     @brief Lookup the database meta data description of the specified meta type kind.
 */
@@ -162,6 +207,12 @@ OS_API void     c__assertValidDatabaseObject(c_voidp o);
 
 OS_API os_scopeAttr c_baseGetScopeAttr(c_base base);
 
+/** @fn c__typeRefMapInit (c_type type)
+    @brief Build the flattened reference map c_free uses for instances of a
+           finalized class, structure or exception.
+*/
+OS_API void     c__typeRefMapInit(c_type type);
+
 #undef OS_API
 
 #if defined (__cplusplus)
@@ -48,7 +48,9 @@
 #define REFCOUNT_FLAG_ATOMIC     0x1000000u
 #define REFCOUNT_FLAG_TRACE      0x2000000u
 #define REFCOUNT_FLAG_TRACETYPE  0x4000000u
+#define REFCOUNT_FLAG_SAMPLED    0x8000000u
 #define REFCOUNT_FLAG_GARBAGE   0x10000000u
+#define REFCOUNT_FLAG_INTERNED  0x20000000u
 
 #define c_oid(o)    ((c_object)(C_ADDRESS(o) + HEADERSIZE))
 #define c_header(o) ((c_header)(C_ADDRESS(o) - HEADERSIZE))
@@ -78,6 +80,8 @@
         };
 
 C_CLASS(c_baseBinding);
+C_CLASS(c_baseInternedString);
+C_CLASS(c_baseTypeDescriptor);
 C_CLASS(c_header);
 
 C_STRUCT(c_header) {
@@ -110,6 +114,123 @@ static const ut_avlTreedef_t c_base_bindings_td =
                                      offsetof (C_STRUCT(c_baseBinding), name),
                                      strcmp, 0);
 
+static const ut_avlTreedef_t c_base_interned_td =
+  UT_AVL_TREEDEF_INITIALIZER_INDKEY (offsetof (C_STRUCT(c_baseInternedString), avlnode),
+                                     offsetof (C_STRUCT(c_baseInternedString), string),
+                                     strcmp, 0);
+
+static int
+c_base_descriptor_cmp (
+    const void *va,
+    const void *vb)
+{
+    const os_uint64 *a = va, *b = vb;
+    return (*a == *b) ? 0 : (*a < *b) ? -1 : 1;
+}
+
+static const ut_avlTreedef_t c_base_descriptor_td =
+  UT_AVL_TREEDEF_INITIALIZER (offsetof (C_STRUCT(c_baseTypeDescriptor), avlnode),
+                              offsetof (C_STRUCT(c_baseTypeDescriptor), hash),
+                              c_base_descriptor_cmp, 0);
+
+/* Returns TRUE once every profile->interval allocations of the calling
+ * thread. A per-thread countdown keeps the cost of an allocation that is
+ * not sampled to a thread-private decrement.
+ */
+static c_bool
+c_baseAllocSampleDue(
+    c_baseAllocProfile profile)
+{
+    os_uint32 *countdown;
+
+    countdown = (os_uint32 *)os_threadMemGet(OS_THREAD_ALLOC_SAMPLER);
+    if (countdown == NULL) {
+        countdown = (os_uint32 *)os_threadMemMalloc(OS_THREAD_ALLOC_SAMPLER, sizeof(*countdown), NULL, NULL);
+        if (countdown == NULL) {
+            return FALSE;
+        }
+        *countdown = profile->interval;
+    }
+    if (--(*countdown) != 0) {
+        return FALSE;
+    }
+    *countdown = profile->interval;
+    return TRUE;
+}
+
+static c_baseAllocSite
+c_baseAllocSiteLookup(
+    c_baseAllocProfile profile,
+    c_type type,
+    c_bool claim)
+{
+    os_uint32 i, n;
+    void *t;
+
+    i = (os_uint32)(((os_address)type >> 4) * 2654435761u);
+    for (n = 0; n < C_BASE_ALLOCPROFILE_SIZE; n++, i++) {
+        c_baseAllocSite site = &profile->sites[i & (C_BASE_ALLOCPROFILE_SIZE - 1)];
+        t = pa_ldvoidp(&site->type);
+        if (t == type) {
+            return site;
+        } else if (t == NULL) {
+            if (!claim) {
+                return NULL;
+            }
+            if (pa_casvoidp(&site->type, NULL, type) || pa_ldvoidp(&site->type) == type) {
+                return site;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Records a sampled allocation of size bytes for the given type. Returns
+ * TRUE if the allocation was recorded, in which case the object must be
+ * flagged with REFCOUNT_FLAG_SAMPLED so the release is accounted for.
+ */
+static c_bool
+c_baseAllocSample(
+    c_base base,
+    c_type type,
+    c_size size)
+{
+    c_baseAllocProfile profile;
+    c_baseAllocSite site;
+
+    profile = (c_baseAllocProfile)pa_ldvoidp(&base->allocProfile);
+    if (c_likely(profile == NULL) || !c_baseAllocSampleDue(profile)) {
+        return FALSE;
+    }
+    pa_inc32(&profile->samples);
+    if ((site = c_baseAllocSiteLookup(profile, type, TRUE)) == NULL) {
+        pa_inc32(&profile->dropped);
+        return FALSE;
+    }
+    pa_inc32(&site->count);
+    pa_inc32(&site->live);
+    /* Not all platforms provide 64-bit atomics, so carry into the high
+     * word; readers may briefly see the low word wrapped before the carry. */
+    if (pa_add32_nv(&site->bytes, (os_uint32)size) < (os_uint32)size) {
+        pa_inc32(&site->bytesHi);
+    }
+    return TRUE;
+}
+
+static void
+c_baseAllocRelease(
+    c_base base,
+    c_type type)
+{
+    c_baseAllocProfile profile;
+    c_baseAllocSite site;
+
+    profile = (c_baseAllocProfile)pa_ldvoidp(&base->allocProfile);
+    if (profile != NULL && (site = c_baseAllocSiteLookup(profile, type, FALSE)) != NULL) {
+        pa_dec32(&site->live);
+    }
+}
+
 static c_string
 c__stringMalloc(
     c_base base,
@@ -140,6 +261,9 @@ c__stringMalloc(
             pa_inc32(&base->string_type->objectCount);
         }
         pa_st32(&header->refCount, 1 | REFCOUNT_FLAG_ATOMIC);
+        if (c_baseAllocSample(base, base->string_type, length)) {
+            pa_or32(&header->refCount, REFCOUNT_FLAG_SAMPLED);
+        }
         s = (c_string)c_oid(header);
         s[0] = '\0'; /* c_stringNew/Malloc always return a null-terminated string */
 #ifndef NDEBUG
@@ -226,6 +350,9 @@ c__wstringMalloc(
             pa_inc32(&wstring_t->objectCount);
         }
         pa_st32(&header->refCount, 1 | REFCOUNT_FLAG_ATOMIC);
+        if (c_baseAllocSample(base, wstring_t, length*sizeof(c_wchar))) {
+            pa_or32(&header->refCount, REFCOUNT_FLAG_SAMPLED);
+        }
         s = (c_wstring)c_oid(header);
         s[0] = 0; /* c_wstringNew/Malloc always return a nul-terminated string */
 #ifndef NDEBUG
@@ -242,6 +369,168 @@ c__wstringMalloc(
     return s;
 }
 
+/* Interned strings are referenced weakly by the intern table: the entry is
+ * removed by c_free when the last real reference goes away.  A lookup racing
+ * with that final c_free must not resurrect the string, hence the conditional
+ * increment.
+ */
+static c_string
+c_stringInternKeep(
+    c_string s)
+{
+    c_header header = c_header(s);
+    os_uint32 count;
+
+    do {
+        count = pa_ld32(&header->refCount);
+        if ((count & REFCOUNT_MASK) == 0) {
+            return NULL;
+        }
+    } while (!pa_cas32(&header->refCount, count, count + 1));
+    return s;
+}
+
+static c_string
+c_stringInternNew(
+    c_base base,
+    const c_char *str)
+{
+    c_string s;
+
+    if ((s = c_stringNew(base, str)) != NULL) {
+        pa_or32(&c_header(s)->refCount, REFCOUNT_FLAG_INTERNED);
+    }
+    return s;
+}
+
+static void
+c_stringUnintern(
+    c_base base,
+    c_string s)
+{
+    c_baseInternedString interned;
+
+    c_mutexLock(&base->internLock);
+    /* The entry may already have been taken over by a new string with the same
+     * value while this one was being freed. */
+    if ((interned = ut_avlLookup (&c_base_interned_td, &base->internedStrings, s)) != NULL &&
+        interned->string == s) {
+        ut_avlDelete (&c_base_interned_td, &base->internedStrings, interned);
+        c_mmFree(base->mm, interned);
+    }
+    c_mutexUnlock(&base->internLock);
+}
+
+c_string
+c_stringIntern(
+    c_base base,
+    const c_char *str)
+{
+    ut_avlIPath_t p;
+    c_baseInternedString interned;
+    c_string s = NULL;
+
+    assert(base);
+    assert(base->confidence == CONFIDENCE);
+
+    if (str == NULL) {
+        return NULL;
+    }
+    if (*str == '\0') {
+        return c_keep(base->emptyString);
+    }
+
+    c_mutexLock(&base->internLock);
+    if ((interned = ut_avlLookupIPath (&c_base_interned_td, &base->internedStrings, str, &p)) != NULL) {
+        if ((s = c_stringInternKeep(interned->string)) == NULL) {
+            /* Being freed: take over the entry with a fresh string. */
+            if ((s = c_stringInternNew(base, str)) != NULL) {
+                interned->string = s;
+            } else {
+                ut_avlDelete (&c_base_interned_td, &base->internedStrings, interned);
+                c_mmFree(base->mm, interned);
+            }
+        }
+    } else if ((interned = (c_baseInternedString) c_mmMalloc (base->mm, sizeof (*interned))) != NULL) {
+        if ((s = c_stringInternNew(base, str)) != NULL) {
+            interned->string = s;
+            ut_avlInsertIPath (&c_base_interned_td, &base->internedStrings, interned, &p);
+        } else {
+            c_mmFree(base->mm, interned);
+        }
+    }
+    c_mutexUnlock(&base->internLock);
+
+    return s;
+}
+
+/* FNV-1a, only used to index the type descriptors: a hit is always
+ * verified against the stored descriptor. */
+static os_uint64
+c_baseDescriptorHash (
+    const c_char *descriptor)
+{
+    const unsigned char *p = (const unsigned char *) descriptor;
+    os_uint64 h = PA_UINT64_C(14695981039346656037);
+
+    while (*p) {
+        h ^= *p++;
+        h *= PA_UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+c_bool
+c_baseLookupTypeDescriptor(
+    c_base base,
+    const c_char *descriptor)
+{
+    c_baseTypeDescriptor d;
+    os_uint64 hash;
+    c_bool found = FALSE;
+
+    assert(base);
+    assert(base->confidence == CONFIDENCE);
+
+    hash = c_baseDescriptorHash(descriptor);
+    c_mutexLock(&base->typeDescriptorLock);
+    if ((d = ut_avlLookup (&c_base_descriptor_td, &base->typeDescriptors, &hash)) != NULL) {
+        found = (strcmp(d->descriptor, descriptor) == 0);
+    }
+    c_mutexUnlock(&base->typeDescriptorLock);
+
+    return found;
+}
+
+void
+c_baseRegisterTypeDescriptor(
+    c_base base,
+    const c_char *descriptor)
+{
+    ut_avlIPath_t p;
+    c_baseTypeDescriptor d;
+    os_uint64 hash;
+
+    assert(base);
+    assert(base->confidence == CONFIDENCE);
+
+    hash = c_baseDescriptorHash(descriptor);
+    c_mutexLock(&base->typeDescriptorLock);
+    /* On a hash collision the first descriptor stays cached, the other one
+     * is simply deserialized on every registration. */
+    if (ut_avlLookupIPath (&c_base_descriptor_td, &base->typeDescriptors, &hash, &p) == NULL) {
+        if ((d = (c_baseTypeDescriptor) c_mmMalloc (base->mm, sizeof (*d))) != NULL) {
+            d->hash = hash;
+            if ((d->descriptor = c_stringNew(base, descriptor)) != NULL) {
+                ut_avlInsertIPath (&c_base_descriptor_td, &base->typeDescriptors, d, &p);
+            } else {
+                c_mmFree(base->mm, d);
+            }
+        }
+    }
+    c_mutexUnlock(&base->typeDescriptorLock);
+}
+
 c_wstring
 c_wstringMalloc(
     c_base base,
@@ -514,6 +803,38 @@ c_baseSetMaintainObjectCount (
     base->maintainObjectCount = enable;
 }
 
+void
+c_baseSetAllocSampling (
+    c_base base,
+    c_ulong interval)
+{
+    c_baseAllocProfile profile;
+
+    if (interval == 0) {
+        /* Sampling cannot be switched off again once enabled; objects that
+         * are still flagged as sampled need the profile on release. */
+        return;
+    }
+    profile = (c_baseAllocProfile)pa_ldvoidp(&base->allocProfile);
+    if (profile == NULL) {
+        profile = (c_baseAllocProfile)c_mmMalloc(base->mm, C_SIZEOF(c_baseAllocProfile));
+        if (profile == NULL) {
+            OS_REPORT(OS_WARNING, "c_baseSetAllocSampling", 0,
+                      "Failed to allocate the allocation profile, sampling disabled");
+            return;
+        }
+        memset(profile, 0, C_SIZEOF(c_baseAllocProfile));
+        profile->interval = interval;
+        if (!pa_casvoidp(&base->allocProfile, NULL, profile)) {
+            c_mmFree(base->mm, profile);
+            profile = (c_baseAllocProfile)pa_ldvoidp(&base->allocProfile);
+        }
+    }
+    /* Not bothering with locking here, threads pick up a new interval
+       when their current countdown expires */
+    profile->interval = interval;
+}
+
 void
 c_baseSetY2038Ready (
     c_base base,
@@ -566,6 +887,7 @@ c_baseInit (
     /* First, attach mm to base. */
     base->mm = mm;
     base->maintainObjectCount = FALSE;
+    pa_stvoidp(&base->allocProfile, NULL);
     base->y2038Ready = FALSE;
 
     /* c_baseObject init */
@@ -583,6 +905,10 @@ c_baseInit (
     base->confidence = CONFIDENCE;
     ut_avlInit (&c_base_bindings_td, &base->bindings);
     c_mutexInit(base, &base->bindLock);
+    ut_avlInit (&c_base_interned_td, &base->internedStrings);
+    c_mutexInit(base, &base->internLock);
+    ut_avlInit (&c_base_descriptor_td, &base->typeDescriptors);
+    c_mutexInit(base, &base->typeDescriptorLock);
     c_mutexInit(base, &base->serLock);
 
     /* metaType[M_COUNT], string_type and emptyString are initialized when types
@@ -1081,6 +1407,10 @@ c_baseInit (
         type = ResolveType(base,c_address);
         C_META_ATTRIBUTE_(c_type,o,size,type);
         c_free(type);
+        type = ResolveType(base,pa_voidp_t);
+        C_META_ATTRIBUTE_(c_type,o,objCache,type);
+        C_META_ATTRIBUTE_(c_type,o,refMap,type);
+        c_free(type);
         C_META_FINALIZE_(o);
         c_free(o);
 
@@ -1826,6 +2156,164 @@ c_baseReleaseMemReservation(
     }
 }
 
+/* Per-type free-object caches
+ *
+ * For hot types (kernel messages and samples), c_free does not return
+ * the memory of an object to the memory manager but keeps it on a
+ * free-list attached to the type, and c_new takes it from there. This
+ * avoids the memory manager (and, for a shared memory database, its
+ * global lock) for the bulk of the allocations of such types. The
+ * number of objects retained is bounded per type, beyond that objects
+ * are returned to the memory manager as usual.
+ *
+ * Free objects are linked through the first word of the object, which
+ * is why caching is only supported for types at least the size of a
+ * pointer. The cache is destroyed together with the type.
+ */
+C_CLASS(c_typeObjCache);
+C_STRUCT(c_typeObjCache) {
+    c_mutex mtx;
+    c_header free;
+    c_ulong nfree;
+    c_ulong retain;
+    c_ulonglong hits;
+    c_ulonglong misses;
+    c_ulonglong cached;
+    c_ulonglong released;
+};
+
+#define c_typeObjCacheNext(h) (*(c_header *) c_oid (h))
+
+static c_header
+c_typeObjCacheTake (
+    c_typeObjCache cache)
+{
+    c_header header;
+    c_mutexLock (&cache->mtx);
+    if ((header = cache->free) != NULL) {
+        cache->free = c_typeObjCacheNext (header);
+        cache->nfree--;
+        cache->hits++;
+    } else {
+        cache->misses++;
+    }
+    c_mutexUnlock (&cache->mtx);
+    return header;
+}
+
+static c_bool
+c_typeObjCachePut (
+    c_typeObjCache cache,
+    c_header header)
+{
+    c_bool result;
+    c_mutexLock (&cache->mtx);
+    if (cache->nfree < cache->retain) {
+        c_typeObjCacheNext (header) = cache->free;
+        cache->free = header;
+        cache->nfree++;
+        cache->cached++;
+        result = TRUE;
+    } else {
+        cache->released++;
+        result = FALSE;
+    }
+    c_mutexUnlock (&cache->mtx);
+    return result;
+}
+
+static void
+c_typeObjCacheDrain (
+    c_base base,
+    c_typeObjCache cache)
+{
+    c_header header, next;
+    c_mutexLock (&cache->mtx);
+    header = cache->free;
+    cache->free = NULL;
+    cache->nfree = 0;
+    c_mutexUnlock (&cache->mtx);
+    while (header != NULL) {
+        next = c_typeObjCacheNext (header);
+        c_mmFree (base->mm, header);
+        header = next;
+    }
+}
+
+static void
+c_typeObjCacheFree (
+    c_base base,
+    c_typeObjCache cache)
+{
+    c_typeObjCacheDrain (base, cache);
+    c_mutexDestroy (&cache->mtx);
+    c_mmFree (base->mm, cache);
+}
+
+c_bool
+c_baseTypeCacheEnable (
+    c_type type,
+    c_ulong retain)
+{
+    c_type t;
+    c_base base;
+    c_typeObjCache cache;
+
+    ACTUALTYPE (t, type);
+    if (c_baseObjectKind (t) != M_CLASS || t->size < sizeof (c_header)) {
+        return FALSE;
+    }
+    base = t->base;
+    if ((cache = (c_typeObjCache) pa_ldvoidp (&t->objCache)) == NULL) {
+        if ((cache = c_mmMalloc (base->mm, C_SIZEOF (c_typeObjCache))) == NULL) {
+            return FALSE;
+        }
+        memset (cache, 0, C_SIZEOF (c_typeObjCache));
+        if (c_mutexInit (base, &cache->mtx) != SYNC_RESULT_SUCCESS) {
+            c_mmFree (base->mm, cache);
+            return FALSE;
+        }
+        cache->retain = retain;
+        if (!pa_casvoidp (&t->objCache, NULL, cache)) {
+            /* someone else beat us to it */
+            c_mutexDestroy (&cache->mtx);
+            c_mmFree (base->mm, cache);
+            cache = (c_typeObjCache) pa_ldvoidp (&t->objCache);
+        } else {
+            return TRUE;
+        }
+    }
+    /* Type shared by multiple users, retain the maximum requested */
+    c_mutexLock (&cache->mtx);
+    if (retain > cache->retain) {
+        cache->retain = retain;
+    }
+    c_mutexUnlock (&cache->mtx);
+    return TRUE;
+}
+
+c_bool
+c_baseTypeCacheGetStats (
+    c_type type,
+    c_baseTypeCacheStats *stats)
+{
+    c_type t;
+    c_typeObjCache cache;
+    ACTUALTYPE (t, type);
+    if ((cache = (c_typeObjCache) pa_ldvoidp (&t->objCache)) == NULL) {
+        return FALSE;
+    }
+    c_mutexLock (&cache->mtx);
+    stats->retain = cache->retain;
+    stats->nfree = cache->nfree;
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->cached = cache->cached;
+    stats->released = cache->released;
+    c_mutexUnlock (&cache->mtx);
+    return TRUE;
+}
+
 static c_object
 c__newCommon (
     c_type type,
@@ -1835,6 +2323,7 @@ c__newCommon (
     c_object o;
     os_size_t size;
     os_uint32 traceType;
+    c_typeObjCache cache;
 
     assert(type);
 
@@ -1856,7 +2345,10 @@ c__newCommon (
     }
     assert (size > 0);
 
-    if (check) {
+    if ((cache = (c_typeObjCache) pa_ldvoidp (&type->objCache)) != NULL &&
+        (header = c_typeObjCacheTake (cache)) != NULL) {
+        /* recycled, memory already accounted for */
+    } else if (check) {
         header = (c_header) c_mmMallocThreshold (type->base->mm, MEMSIZE(size));
     } else {
         header = (c_header) c_mmMalloc (type->base->mm, MEMSIZE(size));
@@ -1882,6 +2374,9 @@ c__newCommon (
     if (type->base->maintainObjectCount) {
         pa_inc32(&type->objectCount);
     }
+    if (c_baseAllocSample(type->base, type, size)) {
+        pa_or32(&header->refCount, REFCOUNT_FLAG_SAMPLED);
+    }
 #ifndef NDEBUG
     header->confidence = CONFIDENCE;
 #ifdef OBJECT_WALK
@@ -1999,6 +2494,9 @@ c__newBaseArrayObjectCommon (
                 if (base->maintainObjectCount) {
                     pa_inc32(&header->type->objectCount);
                 }
+                if (c_baseAllocSample(base, header->type, allocSize)) {
+                    pa_or32(&header->refCount, REFCOUNT_FLAG_SAMPLED);
+                }
 
                 o = c_oid(header);
 
@@ -2346,6 +2844,266 @@ _c_freeReferences (
     return TRUE;
 }
 
+/* Reference maps: for structured types (classes, structures and exceptions)
+ * the list of references that c_free must release is flattened once into an
+ * array of runs, so that freeing an instance no longer has to walk the
+ * meta-data recursively. Embedded structures and fixed-size arrays are
+ * expanded in place; anything that needs per-instance inspection (unions,
+ * enumerations) falls back to the recursive walk in _c_freeReferences.
+ */
+#define C_REFMAP_UNSUPPORTED ((void *) 1)
+#define C_REFMAP_MAXENTRIES  (1024)
+
+typedef enum c_refMapKind {
+    C_REFMAP_REF,
+    C_REFMAP_MUTEX,
+    C_REFMAP_LOCK,
+    C_REFMAP_COND
+} c_refMapKind;
+
+C_CLASS(c_refMap);
+
+typedef struct c_refMapEntry {
+    c_ulong offset;
+    c_ulong count; /* number of consecutive references, 1 for other kinds */
+    c_ulong kind;
+} c_refMapEntry;
+
+C_STRUCT(c_refMap) {
+    c_ulong n;
+    c_refMapEntry e[1];
+};
+
+typedef struct c_refMapBuilder {
+    c_refMapEntry *e; /* NULL while counting */
+    c_ulong n;
+    c_refMapEntry last;
+} c_refMapBuilder;
+
+static c_bool c_refMapAddType (c_refMapBuilder *b, c_ulong offset, c_type type);
+
+static c_bool
+c_refMapAppend (
+    c_refMapBuilder *b,
+    c_ulong offset,
+    c_refMapKind kind)
+{
+    if (b->n > 0 && kind == C_REFMAP_REF && b->last.kind == C_REFMAP_REF &&
+        b->last.offset + b->last.count * sizeof (c_voidp) == offset) {
+        b->last.count++;
+    } else if (b->n == C_REFMAP_MAXENTRIES) {
+        return FALSE;
+    } else {
+        b->last.offset = offset;
+        b->last.count = 1;
+        b->last.kind = kind;
+        b->n++;
+    }
+    if (b->e) {
+        b->e[b->n - 1] = b->last;
+    }
+    return TRUE;
+}
+
+static c_bool
+c_refMapAddReference (
+    c_refMapBuilder *b,
+    c_ulong offset,
+    c_type type)
+{
+    c_type t, subType;
+    c_ulong i;
+
+    ACTUALTYPE (t, type);
+    switch (c_baseObjectKind (t)) {
+    case M_CLASS:
+    case M_INTERFACE:
+    case M_ANNOTATION:
+        return c_refMapAppend (b, offset, C_REFMAP_REF);
+    case M_BASE:
+    case M_COLLECTION:
+        if ((c_collectionType (t)->kind == OSPL_C_ARRAY) &&
+            (c_collectionType (t)->maxSize != 0)) {
+            ACTUALTYPE (subType, c_collectionType (t)->subType);
+            if (c_typeIsRef (subType)) {
+                for (i = 0; i < c_collectionType (t)->maxSize; i++) {
+                    if (!c_refMapAppend (b, offset + i * sizeof (c_voidp), C_REFMAP_REF)) {
+                        return FALSE;
+                    }
+                }
+            } else if (c_typeHasRef (subType)) {
+                for (i = 0; i < c_collectionType (t)->maxSize; i++) {
+                    if (!c_refMapAddReference (b, offset + i * (c_ulong) subType->size, subType)) {
+                        return FALSE;
+                    }
+                }
+            }
+            return TRUE;
+        } else {
+            return c_refMapAppend (b, offset, C_REFMAP_REF);
+        }
+    case M_EXCEPTION:
+    case M_STRUCTURE:
+        return c_refMapAddType (b, offset, t);
+    case M_PRIMITIVE:
+        switch (c_primitive (t)->kind) {
+        case P_MUTEX: return c_refMapAppend (b, offset, C_REFMAP_MUTEX);
+        case P_LOCK:  return c_refMapAppend (b, offset, C_REFMAP_LOCK);
+        case P_COND:  return c_refMapAppend (b, offset, C_REFMAP_COND);
+        default:      return TRUE;
+        }
+    default:
+        /* unions and anything unexpected: leave it to _c_freeReferences */
+        return FALSE;
+    }
+}
+
+static c_bool
+c_refMapAddType (
+    c_refMapBuilder *b,
+    c_ulong offset,
+    c_type type)
+{
+    c_class cls;
+    c_property property;
+    c_member member;
+    c_array references;
+    c_ulong i, length;
+
+    switch (c_baseObjectKind (type)) {
+    case M_CLASS:
+        if (type == type->base->metaType[M_ENUMERATION]) {
+            return FALSE;
+        }
+        cls = c_class (type);
+        while (cls) {
+            references = c_interface (cls)->references;
+            length = c_arraySize (references);
+            for (i = 0; i < length; i++) {
+                property = c_property (references[i]);
+                if (!c_refMapAddReference (b, offset + (c_ulong) property->offset, property->type)) {
+                    return FALSE;
+                }
+            }
+            cls = cls->extends;
+        }
+        return TRUE;
+    case M_EXCEPTION:
+    case M_STRUCTURE:
+        references = c_structure (type)->references;
+        length = c_arraySize (references);
+        for (i = 0; i < length; i++) {
+            member = c_member (references[i]);
+            if (!c_refMapAddReference (b, offset + (c_ulong) member->offset, c_specifier (member)->type)) {
+                return FALSE;
+            }
+        }
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static c_refMap
+c_refMapNew (
+    c_type type)
+{
+    c_refMapBuilder b;
+    c_refMap map;
+
+    memset (&b, 0, sizeof (b));
+    if (!c_refMapAddType (&b, 0, type)) {
+        return C_REFMAP_UNSUPPORTED;
+    }
+    map = c_mmMalloc (type->base->mm, C_SIZEOF (c_refMap) + (b.n ? b.n - 1 : 0) * sizeof (c_refMapEntry));
+    if (map == NULL) {
+        return C_REFMAP_UNSUPPORTED;
+    }
+    map->n = b.n;
+    b.e = map->e;
+    b.n = 0;
+    (void) c_refMapAddType (&b, 0, type);
+    assert (b.n == map->n);
+    return map;
+}
+
+/* Called by c__metaFinalize once the references arrays of the type (and of
+ * the types it extends or embeds) are complete, so instances can never be
+ * freed through a partial map. Types that are not finalized have no map and
+ * are freed by the recursive walk.
+ */
+void
+c__typeRefMapInit (
+    c_type type)
+{
+    c_refMap map;
+
+    if (pa_ldvoidp (&type->refMap) != NULL) {
+        return;
+    }
+    map = c_refMapNew (type);
+    if (!pa_casvoidp (&type->refMap, NULL, map) && map != C_REFMAP_UNSUPPORTED) {
+        c_mmFree (type->base->mm, map);
+    }
+}
+
+static void
+c_refMapFree (
+    c_base base,
+    c_type type)
+{
+    c_refMap map = (c_refMap) pa_ldvoidp (&type->refMap);
+    if (map != NULL && map != C_REFMAP_UNSUPPORTED) {
+        c_mmFree (base->mm, map);
+    }
+}
+
+static void
+c_freeReferencesByType (
+    c_type type,
+    c_object o)
+{
+    c_refMap map;
+    c_voidp *p;
+    c_ulong i, j;
+
+    switch (c_baseObjectKind (type)) {
+    case M_CLASS:
+    case M_EXCEPTION:
+    case M_STRUCTURE:
+        map = (c_refMap) pa_ldvoidp (&type->refMap);
+        if (map != NULL && map != C_REFMAP_UNSUPPORTED) {
+            for (i = 0; i < map->n; i++) {
+                const c_refMapEntry *e = &map->e[i];
+                p = (c_voidp *) C_DISPLACE (o, e->offset);
+                switch ((c_refMapKind) e->kind) {
+                case C_REFMAP_REF:
+                    for (j = 0; j < e->count; j++) {
+                        if (p[j] != NULL) {
+                            c_free (p[j]);
+                        }
+                    }
+                    break;
+                case C_REFMAP_MUTEX:
+                    c_mutexDestroy ((c_mutex *) p);
+                    break;
+                case C_REFMAP_LOCK:
+                    c_lockDestroy ((c_lock *) p);
+                    break;
+                case C_REFMAP_COND:
+                    c_condDestroy ((c_cond *) p);
+                    break;
+                }
+            }
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    (void) c_freeReferences (c_metaObject (type), o);
+}
+
 #ifndef NDEBUG
 /*
  * Function used in OS_REPORT in c_free
@@ -2394,6 +3152,7 @@ c_free (
     c_header header;
     c_type type, headerType;
     os_uint32 safeCount;
+    c_typeObjCache cache;
 #if CHECK_REF
     c_bool matchesRefRequest = FALSE;
 #endif
@@ -2458,8 +3217,21 @@ c_free (
 #endif
 
         base = type->base;
+        if (type == base->metaType[M_CLASS] &&
+            (cache = (c_typeObjCache) pa_ldvoidp (&c_type(object)->objCache)) != NULL) {
+            /* the object is itself a class with a free-object cache */
+            c_typeObjCacheFree (base, cache);
+        }
+        if (type == base->metaType[M_CLASS] ||
+            type == base->metaType[M_STRUCTURE] ||
+            type == base->metaType[M_EXCEPTION]) {
+            c_refMapFree (base, c_type(object));
+        }
+        if (safeCount & REFCOUNT_FLAG_INTERNED) {
+            c_stringUnintern(base, object);
+        }
         if (!(safeCount & REFCOUNT_FLAG_ATOMIC)) {
-            c_freeReferences(c_metaObject(type),object);
+            c_freeReferencesByType(type,object);
         }
 #ifndef NDEBUG
 #ifdef OBJECT_WALK
@@ -2513,7 +3285,10 @@ c_free (
             if (safeCount & REFCOUNT_FLAG_TRACE) {
                 c_mmTrackObject (base->mm, header, C_MMTRACKOBJECT_CODE_MIN + 3);
             }
-            c_mmFree(base->mm, header);
+            if ((cache = (c_typeObjCache) pa_ldvoidp (&type->objCache)) == NULL ||
+                !c_typeObjCachePut (cache, header)) {
+                c_mmFree(base->mm, header);
+            }
         }
         /* Do not use type, as it refers to an actual type, while
          * we incremented the header->type.
@@ -2523,6 +3298,9 @@ c_free (
              * return-value of the decrement isn't needed. */
             (void) pa_dec32_nv(&headerType->objectCount);
         }
+        if (safeCount & REFCOUNT_FLAG_SAMPLED) {
+            c_baseAllocRelease(base, headerType);
+        }
 #if TYPE_REFC_COUNTS_OBJECTS
         c_free(headerType); /* free the header->type */
 #endif
@@ -3105,6 +3883,33 @@ static void freeBindings (void *binding, void *arg)
     c_mmFree(a->mm, b);
 }
 
+static void freeInternedStrings (void *interned, void *arg)
+{
+    c_baseInternedString i = (c_baseInternedString)interned;
+    bindArgp a = (bindArgp)arg;
+    c_header header = c_header(i->string);
+
+    /* Interned strings still referenced by bound objects are already in the trash. */
+    if ((pa_ld32(&header->refCount) & REFCOUNT_FLAG_GARBAGE) == 0) {
+        pa_or32(&header->refCount, REFCOUNT_FLAG_GARBAGE);
+        c_iterInsert(a->trashcan->trash, i->string);
+    }
+    c_mmFree(a->mm, i);
+}
+
+static void freeTypeDescriptors (void *descriptor, void *arg)
+{
+    c_baseTypeDescriptor d = (c_baseTypeDescriptor)descriptor;
+    bindArgp a = (bindArgp)arg;
+    c_header header = c_header(d->descriptor);
+
+    if ((pa_ld32(&header->refCount) & REFCOUNT_FLAG_GARBAGE) == 0) {
+        pa_or32(&header->refCount, REFCOUNT_FLAG_GARBAGE);
+        c_iterInsert(a->trashcan->trash, d->descriptor);
+    }
+    c_mmFree(a->mm, d);
+}
+
 static void
 deleteGarbage(
     c_base base)
@@ -3113,6 +3918,7 @@ deleteGarbage(
     c_mm mm;
     c_object trash;
     struct bindArg barg;
+    void *profile;
 
     if (base == NULL) return;
 
@@ -3129,7 +3935,15 @@ deleteGarbage(
     barg.trashcan = &trashcan;
     barg.mm = mm;
 
+    profile = pa_ldvoidp(&base->allocProfile);
+    pa_stvoidp(&base->allocProfile, NULL);
+    if (profile != NULL) {
+        c_mmFree(mm, profile);
+    }
+
     ut_avlFreeArg (&c_base_bindings_td, &base->bindings, freeBindings, &barg);
+    ut_avlFreeArg (&c_base_interned_td, &base->internedStrings, freeInternedStrings, &barg);
+    ut_avlFreeArg (&c_base_descriptor_td, &base->typeDescriptors, freeTypeDescriptors, &barg);
     OS_REPORT(OS_INFO,"Database close",0,"Removed %d objects",c_iterLength(trashcan.trash));
 
     while ((trash = c_iterTakeFirst(trashcan.scopes)) != NULL)
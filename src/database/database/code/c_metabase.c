@@ -1347,6 +1347,7 @@ c__metaFinalize(
             size = alignSize(size,alignment);
             c_typeInit(o,alignment,size);
         }
+        c__typeRefMapInit(c_type(o));
     }
     break;
     case M_UNION:
@@ -1638,6 +1639,9 @@ if ((offset != 0) && (offset != property->offset)) {
             }
             c_iterFree(refList);
         }
+        if (c_baseObjectKind(o) == M_CLASS) {
+            c__typeRefMapInit(c_type(o));
+        }
     }
     break;
     case M_TYPEDEF:
@@ -2336,6 +2340,9 @@ c_metaCopy(
         c_interface(d)->references = c_keep(c_interface(s)->references);
         metaScopeWalk(s, copyScopeObjectScopeWalkAction, d);
         c_typeCopy(c_type(s),c_type(d));
+        if (c_baseObjectKind(d) == M_CLASS) {
+            c__typeRefMapInit(c_type(d));
+        }
     break;
     case M_COLLECTION:
         c_collectionType(d)->kind = c_collectionType(s)->kind;
@@ -2356,6 +2363,7 @@ c_metaCopy(
         c_structure(d)->members = c_keep(c_structure(s)->members);
         c_structure(d)->references = c_keep(c_structure(s)->references);
         metaScopeWalk(s, copyScopeObjectScopeWalkAction, d);
+        c__typeRefMapInit(c_type(d));
     break;
     case M_MODULE:
         metaScopeWalk(s, copyScopeObjectScopeWalkAction, d);
@@ -2560,6 +2568,7 @@ c_metaFindByComp (
     c_baseObject o = NULL;
     const c_char *head,*tail;
     c_char *str;
+    c_char buf[64];
     c_size length;
     c_state state;
     c_token tok;
@@ -2629,8 +2638,9 @@ c_metaFindByComp (
             }
         break;
         case TK_IDENT:
+            /* Short identifiers are copied to the stack. */
             length = (c_size) (tail - head + 1);
-            str = (char *)os_malloc(length);
+            str = (length <= sizeof(buf)) ? buf : (char *)os_malloc(length);
             memcpy(str,head,length-1);
             str[length-1]=0;
 
@@ -2672,7 +2682,9 @@ c_metaFindByComp (
                 state = ST_ERROR;
             break;
             }
-            os_free(str);
+            if (str != buf) {
+                os_free(str);
+            }
         break;
         case TK_END:
             switch (state) {
@@ -27,6 +27,7 @@
 #include "os_report.h"
 #include "os_abstract.h"
 #include "os_stdlib.h"
+#include "os_heap.h"
 
 #ifdef NDEBUG
 #define purify_memset(v,b,s)
@@ -746,6 +747,87 @@ c_valueStringMatch (
 }
 
 
+C_STRUCT(c_stringMatcher) {
+    c_char *pattern;
+    c_bool wildcard;        /* pattern contains '*' or '?' */
+    c_bool variableLength;  /* pattern contains '*' */
+    os_size_t length;       /* length of pattern */
+    os_size_t minLength;    /* number of characters in pattern other than '*' */
+    os_size_t prefixLength; /* number of literal characters before the first wildcard */
+    os_size_t suffixLength; /* number of literal characters after the last '*' */
+};
+
+c_stringMatcher
+c_stringMatcherNew (
+    const c_char *pattern)
+{
+    c_stringMatcher m;
+    const c_char *p, *star;
+
+    assert(pattern != NULL);
+
+    m = os_malloc(sizeof(*m));
+    m->pattern = os_strdup(pattern);
+    m->length = strlen(pattern);
+    m->prefixLength = strcspn(pattern, "*?");
+    m->wildcard = (m->prefixLength < m->length);
+    m->minLength = 0;
+    for (p = pattern; *p; p++) {
+        if (*p != '*') {
+            m->minLength++;
+        }
+    }
+    star = strrchr(pattern, '*');
+    m->variableLength = (star != NULL);
+    if ((star != NULL) && (strchr(star, '?') == NULL)) {
+        m->suffixLength = strlen(star + 1);
+    } else {
+        m->suffixLength = 0;
+    }
+    return m;
+}
+
+c_bool
+c_stringMatcherMatch (
+    c_stringMatcher m,
+    const c_char *str)
+{
+    os_size_t length;
+
+    assert(m != NULL);
+
+    if (str == NULL) {
+        str = "";
+    }
+    if (!m->wildcard) {
+        return (strcmp(m->pattern, str) == 0);
+    }
+    length = strlen(str);
+    if ((length < m->minLength) ||
+        (!m->variableLength && (length != m->minLength))) {
+        return FALSE;
+    }
+    if (strncmp(m->pattern, str, m->prefixLength) != 0) {
+        return FALSE;
+    }
+    if ((m->suffixLength > 0) &&
+        (memcmp(m->pattern + m->length - m->suffixLength,
+                str + length - m->suffixLength, m->suffixLength) != 0)) {
+        return FALSE;
+    }
+    return (c_bool) patmatch (m->pattern + m->prefixLength, str + m->prefixLength);
+}
+
+void
+c_stringMatcherFree (
+    c_stringMatcher m)
+{
+    if (m != NULL) {
+        os_free(m->pattern);
+        os_free(m);
+    }
+}
+
 c_value
 c_valueADD (
     c_value v1,
@@ -206,6 +206,38 @@ c_baseReleaseMemReservation(
     c_base _this,
     os_address amount) __nonnull_all__;
 
+/* Per-type free-object caches.
+ *
+ * c_baseTypeCacheEnable makes c_free retain up to "retain" freed objects of
+ * the given class type for reuse by c_new, instead of returning them to the
+ * memory manager. It is meant for the few kernel types that are allocated
+ * and freed at a high rate. Enabling it again for the same type raises the
+ * retention limit to the maximum requested. Returns FALSE if the type does
+ * not support caching (not a class, or smaller than a pointer) or no memory
+ * is available.
+ *
+ * Retained objects are returned to the memory manager when the type is
+ * freed. c_baseTypeCacheGetStats retrieves the statistics (FALSE if not
+ * enabled), mmstat -c shows them for all types.
+ */
+typedef struct c_baseTypeCacheStats_s {
+    c_ulong retain;        /* maximum number of free objects retained */
+    c_ulong nfree;         /* number of free objects currently retained */
+    c_ulonglong hits;      /* c_new calls served from the cache */
+    c_ulonglong misses;    /* c_new calls that went to the memory manager */
+    c_ulonglong cached;    /* c_free calls that retained the object */
+    c_ulonglong released;  /* c_free calls that exceeded the retention limit */
+} c_baseTypeCacheStats;
+
+OS_API c_bool
+c_baseTypeCacheEnable(
+    c_type type,
+    c_ulong retain) __nonnull_all__;
+
+OS_API c_bool
+c_baseTypeCacheGetStats(
+    c_type type,
+    c_baseTypeCacheStats *stats) __nonnull_all__;
 
 /* c_new() method specificly for arrays and sequences (only).
  *
@@ -503,6 +535,62 @@ c_stringNew_s (
     c_base base,
     const c_char *str) __nonnull((1));
 
+/**
+ * \brief This operation returns the interned database string object with
+ *        the value of the given string.
+ *
+ * All calls with equal values of str return a reference to the same string
+ * object, so interned strings can be compared by reference instead of by
+ * value. The returned string is shared and must never be written to.
+ * The database does not hold a reference of its own: the string is removed
+ * from the intern table when its last reference is freed. Use it when
+ * creating long-lived names, like those of partitions and topics, and not
+ * for lookup keys.
+ *
+ * \param base  The database in which the string object must reside.
+ * \param str   The string value that must be interned.
+ * \pre base is a valid database
+ * \pre str is either NULL or a '\0'-terminated string
+ *
+ * \return A new reference to the interned string object is returned. If
+ * str == NULL or if not enough resources are available, NULL is returned.
+ */
+OS_API c_string
+c_stringIntern (
+    c_base base,
+    const c_char *str) __nonnull((1));
+
+/**
+ * \brief This operation checks whether the given type descriptor has been
+ *        loaded into the database before.
+ *
+ * Type descriptors are looked up by a hash of their value, so repeated
+ * registration of the same type by participants in the same or other
+ * processes can skip deserializing the descriptor altogether.
+ *
+ * \param base       The database.
+ * \param descriptor The type descriptor.
+ *
+ * \return TRUE if the descriptor was registered with
+ * c_baseRegisterTypeDescriptor before, FALSE otherwise.
+ */
+OS_API c_bool
+c_baseLookupTypeDescriptor (
+    c_base base,
+    const c_char *descriptor) __nonnull_all__;
+
+/**
+ * \brief This operation records that the types defined by the given type
+ *        descriptor have been loaded into the database.
+ *
+ * \param base       The database.
+ * \param descriptor The type descriptor that was loaded successfully.
+ */
+OS_API void
+c_baseRegisterTypeDescriptor (
+    c_base base,
+    const c_char *descriptor) __nonnull_all__;
+
 /**
  * \brief This operation will create a new database string object of the
  *        specified length.
@@ -650,6 +738,18 @@ c_baseSetMaintainObjectCount (
     c_base base,
     c_bool enable);
 
+/**
+ * Enables the sampling allocation profile of the database: approximately
+ * one in interval allocations (per thread) is recorded with its type and
+ * size, so tools can report live bytes and growth per type at a fraction
+ * of the cost of maintaining exact object counts. An interval of 0 leaves
+ * the current setting unchanged.
+ */
+OS_API void
+c_baseSetAllocSampling (
+    c_base base,
+    c_ulong interval);
+
 OS_API void
 c_baseSetY2038Ready (
     c_base base,
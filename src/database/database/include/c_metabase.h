@@ -226,6 +226,8 @@ C_STRUCT(c_type) {
     c_base base;
     pa_uint32_t objectCount;
     os_size_t size;
+    pa_voidp_t objCache; /* free-object cache, NULL unless enabled by c_baseTypeCacheEnable */
+    pa_voidp_t refMap;   /* flattened reference map used by c_free, built by c__metaFinalize */
 };
 C_ALIGNMENT_C_STRUCT_TYPE (c_type);
 
@@ -292,6 +292,18 @@ OS_API c_value    c_valueCast        (const c_value v,  const c_valueKind kind);
 OS_API c_value    c_valueKeepRef     (c_value v);
 OS_API c_value    c_valueFreeRef     (c_value v);
 
+/* A c_stringMatcher is a wildcard pattern as matched by c_valueStringMatch,
+ * compiled once for matching it against many strings. The literal prefix,
+ * the literal suffix and the minimum length of the pattern are used to
+ * reject most strings before the pattern itself is matched.
+ * The matcher is allocated on the heap and is not shared between processes.
+ */
+C_CLASS(c_stringMatcher);
+
+OS_API c_stringMatcher c_stringMatcherNew   (const c_char *pattern);
+OS_API c_bool          c_stringMatcherMatch (c_stringMatcher matcher, const c_char *str);
+OS_API void            c_stringMatcherFree  (c_stringMatcher matcher);
+
 #undef OS_API
 
 #if defined (__cplusplus)
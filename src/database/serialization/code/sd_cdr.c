@@ -26,6 +26,7 @@
 #include "os_thread.h"
 #include "os_heap.h"
 #include "os_mutex.h"
+#include "os_atomics.h"
 
 #include "c_base.h"
 #include "c_collection.h"
@@ -200,6 +201,197 @@ static unsigned long long bswap8u (unsigned long long x)
     ( x >> 56);
 }
 
+/************** BULK BYTE SWAPPING **************/
+
+/* Arrays and sequences of primitives exchanged with a peer of the
+   other endianness are swapped by a kernel selected once at run-time:
+   AVX2 if the CPU supports it, else SSE2 when the compiler targets it
+   (always on x86-64), else plain C. Source and destination need not
+   be aligned, and short runs don't go through the function pointer
+   at all as the call would dominate. */
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SD_CDR_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define SD_CDR_HAVE_SSE2 0
+#endif
+
+#if SD_CDR_HAVE_SSE2 && (defined (__clang__) || (defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define SD_CDR_HAVE_AVX2 1
+#include <immintrin.h>
+#define SD_CDR_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#else
+#define SD_CDR_HAVE_AVX2 0
+#endif
+
+#define BSWAP_BULK_MIN 16 /* minimum number of elements for using a bulk kernel */
+
+typedef void (*bswap_copy_fn_t) (void *dst, const void *src, os_uint32 n);
+
+struct bswap_kernels {
+  const char *name;
+  bswap_copy_fn_t copy2;
+  bswap_copy_fn_t copy4;
+  bswap_copy_fn_t copy8;
+};
+
+static void bswap_copy2_scalar (void *dst, const void *src, os_uint32 n)
+{
+  const os_ushort *s = src;
+  os_ushort *d = dst;
+  os_uint32 i;
+  for (i = 0; i < n; i++)
+    d[i] = bswap2u (s[i]);
+}
+
+static void bswap_copy4_scalar (void *dst, const void *src, os_uint32 n)
+{
+  const os_uint32 *s = src;
+  os_uint32 *d = dst;
+  os_uint32 i;
+  for (i = 0; i < n; i++)
+    d[i] = bswap4u (s[i]);
+}
+
+static void bswap_copy8_scalar (void *dst, const void *src, os_uint32 n)
+{
+  /* 8-byte quantities in CDR are only guaranteed to be 4-byte aligned */
+  const char *s = src;
+  os_uint64 *d = dst;
+  os_uint32 i;
+  for (i = 0; i < n; i++)
+  {
+    os_uint64 x;
+    memcpy (&x, s + 8 * i, 8);
+    d[i] = bswap8u (x);
+  }
+}
+
+static const struct bswap_kernels bswap_kernels_scalar = {
+  "scalar", bswap_copy2_scalar, bswap_copy4_scalar, bswap_copy8_scalar
+};
+
+#if SD_CDR_HAVE_SSE2
+/* SSE2 has no byte shuffle: swap the bytes in each 16-bit lane with
+   shifts, then reorder the 16-bit lanes for the wider types */
+static __m128i bswap16_sse2 (__m128i v)
+{
+  return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+}
+
+static void bswap_copy2_sse2 (void *dst, const void *src, os_uint32 n)
+{
+  const char *s = src;
+  char *d = dst;
+  os_uint32 i;
+  for (i = 0; i + 8 <= n; i += 8)
+  {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (s + 2 * i));
+    _mm_storeu_si128 ((__m128i *) (d + 2 * i), bswap16_sse2 (v));
+  }
+  bswap_copy2_scalar (d + 2 * i, s + 2 * i, n - i);
+}
+
+static void bswap_copy4_sse2 (void *dst, const void *src, os_uint32 n)
+{
+  const char *s = src;
+  char *d = dst;
+  os_uint32 i;
+  for (i = 0; i + 4 <= n; i += 4)
+  {
+    __m128i v = bswap16_sse2 (_mm_loadu_si128 ((const __m128i *) (s + 4 * i)));
+    v = _mm_shufflelo_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+    v = _mm_shufflehi_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+    _mm_storeu_si128 ((__m128i *) (d + 4 * i), v);
+  }
+  bswap_copy4_scalar (d + 4 * i, s + 4 * i, n - i);
+}
+
+static void bswap_copy8_sse2 (void *dst, const void *src, os_uint32 n)
+{
+  const char *s = src;
+  char *d = dst;
+  os_uint32 i;
+  for (i = 0; i + 2 <= n; i += 2)
+  {
+    __m128i v = bswap16_sse2 (_mm_loadu_si128 ((const __m128i *) (s + 8 * i)));
+    v = _mm_shufflelo_epi16 (v, _MM_SHUFFLE (0, 1, 2, 3));
+    v = _mm_shufflehi_epi16 (v, _MM_SHUFFLE (0, 1, 2, 3));
+    _mm_storeu_si128 ((__m128i *) (d + 8 * i), v);
+  }
+  bswap_copy8_scalar (d + 8 * i, s + 8 * i, n - i);
+}
+
+static const struct bswap_kernels bswap_kernels_sse2 = {
+  "sse2", bswap_copy2_sse2, bswap_copy4_sse2, bswap_copy8_sse2
+};
+#endif /* SD_CDR_HAVE_SSE2 */
+
+#if SD_CDR_HAVE_AVX2
+/* vpshufb shuffles within each 128-bit lane, so the mask is the same
+   for both halves */
+#define BSWAP_AVX2_KERNEL(width, nper, tail, ...)                        \
+  SD_CDR_TARGET_AVX2 static void bswap_copy##width##_avx2 (void *dst, const void *src, os_uint32 n) \
+  {                                                                     \
+    const __m256i mask = _mm256_setr_epi8 (__VA_ARGS__, __VA_ARGS__);   \
+    const char *s = src;                                                \
+    char *d = dst;                                                      \
+    os_uint32 i;                                                        \
+    for (i = 0; i + (nper) <= n; i += (nper))                           \
+    {                                                                   \
+      __m256i v = _mm256_loadu_si256 ((const __m256i *) (s + (width) * i)); \
+      _mm256_storeu_si256 ((__m256i *) (d + (width) * i), _mm256_shuffle_epi8 (v, mask)); \
+    }                                                                   \
+    tail (d + (width) * i, s + (width) * i, n - i);                     \
+  }
+BSWAP_AVX2_KERNEL (2, 16, bswap_copy2_sse2, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+BSWAP_AVX2_KERNEL (4, 8, bswap_copy4_sse2, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+BSWAP_AVX2_KERNEL (8, 4, bswap_copy8_sse2, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8)
+#undef BSWAP_AVX2_KERNEL
+
+static const struct bswap_kernels bswap_kernels_avx2 = {
+  "avx2", bswap_copy2_avx2, bswap_copy4_avx2, bswap_copy8_avx2
+};
+#endif /* SD_CDR_HAVE_AVX2 */
+
+/* Selected on first use. Racing selections compute the same result, so
+   it doesn't matter which one gets stored. */
+static pa_voidp_t bswap_kernels = PA_VOIDP_INIT (0);
+
+static const struct bswap_kernels *bswap_kernels_select (void)
+{
+  const struct bswap_kernels *k = &bswap_kernels_scalar;
+#if SD_CDR_HAVE_SSE2
+  k = &bswap_kernels_sse2;
+#endif
+#if SD_CDR_HAVE_AVX2
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    k = &bswap_kernels_avx2;
+#endif
+  (void) pa_casvoidp (&bswap_kernels, NULL, (void *) k);
+  return pa_ldvoidp (&bswap_kernels);
+}
+
+static const struct bswap_kernels *bswap_kernels_get (void)
+{
+  const struct bswap_kernels *k = pa_ldvoidp (&bswap_kernels);
+  return k ? k : bswap_kernels_select ();
+}
+
+#define BSWAP_COPY(width) static void bswap_copy##width (void *dst, const void *src, os_uint32 n) \
+  {                                                                     \
+    if (n < BSWAP_BULK_MIN)                                             \
+      bswap_copy##width##_scalar (dst, src, n);                         \
+    else                                                                \
+      bswap_kernels_get ()->copy##width (dst, src, n);                  \
+  }
+BSWAP_COPY (2)
+BSWAP_COPY (4)
+BSWAP_COPY (8)
+#undef BSWAP_COPY
+
 /************** SPECIAL-PURPOSE ALLOCATOR **************/
 
 struct convtype_allocator {
@@ -3202,22 +3394,10 @@ static int serprog_exec (struct sd_cdrSerdata *sd, const struct serprog *prog, c
 
 /******************** SERIALIZE VM (SWAPPED) ********************/
 
-#define SER_OPER_COPY_MULTIPLE_SWAP(width) static void ser_oper_copy_multiple_swap_##width (char *dst, const char *src, os_uint32 n) { \
-    const serprog_uint##width##_t *tsrc =       \
-      (const serprog_uint##width##_t *) src;    \
-    serprog_uint##width##_t *tdst;              \
-    os_uint32 i;                                \
-    tdst = (serprog_uint##width##_t *) dst;     \
-    for (i = 0; i < n; i++)                     \
-      *tdst++ = bswap##width##u (*tsrc++);      \
-  }
-SER_OPER_COPY_MULTIPLE_SWAP (2)
-SER_OPER_COPY_MULTIPLE_SWAP (4)
-SER_OPER_COPY_MULTIPLE_SWAP (8)
 #define SER_OPER_COPY_MULTIPLE_SWAP_0(n) memcpy (*dst, *src, (n))
-#define SER_OPER_COPY_MULTIPLE_SWAP_1(n) ser_oper_copy_multiple_swap_2 (*dst, *src, n)
-#define SER_OPER_COPY_MULTIPLE_SWAP_2(n) ser_oper_copy_multiple_swap_4 (*dst, *src, n)
-#define SER_OPER_COPY_MULTIPLE_SWAP_3(n) ser_oper_copy_multiple_swap_8 (*dst, *src, n)
+#define SER_OPER_COPY_MULTIPLE_SWAP_1(n) bswap_copy2 (*dst, *src, n)
+#define SER_OPER_COPY_MULTIPLE_SWAP_2(n) bswap_copy4 (*dst, *src, n)
+#define SER_OPER_COPY_MULTIPLE_SWAP_3(n) bswap_copy8 (*dst, *src, n)
 
 #define SER_SLOWPATH_MULTIPLE_SWAP(OPER, oper, lg2_width) static int ser_slowpath_##oper##_multiple_swap_##lg2_width ( \
           const struct sd_cdrControl *control,                          \
@@ -4004,23 +4184,10 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
 /******************** DESERIALIZE VM (SWAPPED) ********************/
 
 #define DESERPROG_EXEC_MULTIPLE(width, n) do {          \
-    const serprog_uint##width##_t *tsrc;                \
-    serprog_uint##width##_t *tdst =                     \
-      (serprog_uint##width##_t *) dst;                  \
-    unsigned i;                                         \
     SRC_CHECK_ALIGN (width*(n), width);                 \
-    tsrc = (const serprog_uint##width##_t *) src;       \
-    for (i = 0; i < n; i++) {                           \
-      serprog_uint##width##_t srcval;                   \
-      if ((width) > 4)                                  \
-        memcpy (&srcval, tsrc, (width));                \
-      else                                              \
-        srcval = *tsrc;                                 \
-      tsrc++;                                           \
-      *tdst++ = bswap##width##u (srcval);               \
-    }                                                   \
-    src = (const char *) tsrc;                          \
-    dst = (char *) tdst;                                \
+    bswap_copy##width (dst, src, (n));                  \
+    src += width*(n);                                   \
+    dst += width*(n);                                   \
   } while (0)
 #define DESERPROG_EXEC_SINGLE(width) do {               \
     const serprog_uint##width##_t *tsrc;                \
@@ -84,6 +84,8 @@ typedef struct sd_specialAddresses_s {
             c_object base;
             c_object size;
             c_object objectCount;
+            c_object objCache;
+            c_object refMap;
         } type;
         struct structure {
             c_object references;
@@ -130,6 +132,8 @@ typedef struct sd_specialAddresses_s {
 #define SD_BASENAME         "base"
 #define SD_SIZENAME         "size"
 #define SD_COUNTNAME        "objectCount"
+#define SD_OBJCACHENAME     "objCache"
+#define SD_REFMAPNAME       "refMap"
 #define SD_CSTRUCTURENAME   "c_structure"
 #define SD_SCOPENAME        "scope"
 #define SD_REFERENCESNAME   "references"
@@ -176,6 +180,10 @@ sd_getSpecialAddresses(
     SD_CONFIDENCE(result->ignore.type.size);
     result->ignore.type.objectCount = c_metaResolve(metaObject, SD_COUNTNAME);
     SD_CONFIDENCE(result->ignore.type.objectCount);
+    result->ignore.type.objCache = c_metaResolve(metaObject, SD_OBJCACHENAME);
+    SD_CONFIDENCE(result->ignore.type.objCache);
+    result->ignore.type.refMap = c_metaResolve(metaObject, SD_REFMAPNAME);
+    SD_CONFIDENCE(result->ignore.type.refMap);
     c_free(metaObject);
 
     metaObject = (c_metaObject)c_resolve(base, SD_CSTRUCTURENAME);
@@ -314,6 +314,11 @@ v_dataReaderRemoveInstance(
     v_dataReader _this,
     v_dataReaderInstance instance);
 
+void
+v_dataReaderNotReadListInsert(
+    v_dataReader _this,
+    v_dataReaderInstance instance);
+
 void
 v_dataReaderCheckDeadlineMissed(
     v_dataReader _this,
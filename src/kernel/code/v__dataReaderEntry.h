@@ -22,6 +22,7 @@
 #define V__DATAREADERENTRY_H
 
 #include "v_dataReaderEntry.h"
+#include "v__message.h"
 
 /**
  * \brief Set the specified flags in the instanceState of all DataReader
@@ -49,6 +50,17 @@ v_dataReaderEntryUnmarkInstanceStates (
     v_dataReaderEntry _this,
     c_ulong flags);
 
+/* Same as v_dataReaderEntryWrite, but looks up the instance with the key
+ * values the caller already extracted from the message, if they match the
+ * keys of the reader. */
+v_writeResult
+v_dataReaderEntryWriteKeyed(
+    v_dataReaderEntry _this,
+    v_message message,
+    v_messageKeyValues keys,
+    v_instance *instancePtr,
+    v_messageContext context);
+
 v_writeResult
 v_dataReaderEntryWriteHistoricalTransaction(
     v_dataReaderEntry _this,
@@ -84,6 +84,9 @@
 #define v_dataReaderInstanceInNotEmptyList(_this) \
         (v_dataReaderInstance(_this)->inNotEmptyList)
 
+#define v_dataReaderInstanceInNotReadList(_this) \
+        (v_dataReaderInstance(_this)->inNotReadList)
+
 /**
  * This macro determines if the reader contains VALID samples that are available for
  * consumption. Not all valid samples are available for consumption, since some of them
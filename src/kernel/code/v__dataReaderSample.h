@@ -29,6 +29,14 @@ v_dataReaderSampleNew(
     v_dataReaderInstance instance,
     v_message message);
 
+/* Reinitialises a detached, otherwise unreferenced sample for 'message',
+ * so that KEEP_LAST readers can recycle the sample they push out. */
+v_dataReaderSample
+v_dataReaderSampleReuse(
+    v_dataReaderSample _this,
+    v_dataReaderInstance instance,
+    v_message message);
+
 void
 v_dataReaderSampleRemoveFromLifespanAdmin(
     v_dataReaderSample _this);
@@ -33,6 +33,10 @@
 #define v_kernelGetQos(_this) \
         (c_keep(_this->qos))
 
+/* Number of freed objects retained for reuse for each of the per-topic
+ * message and sample types (see c_baseTypeCacheEnable). */
+#define V_KERNEL_TYPECACHE_RETAIN (64)
+
 v_transactionGroupAdmin
 v_kernelTransactionGroupAdmin(
     v_kernel _this);
@@ -78,6 +82,16 @@ v_resolveShare (
     v_kernel _this,
     const c_char *name);
 
+/* Returns the entities in a table keyed by name whose name matches the
+ * partition-style expression. Absolute names are looked up by key, other
+ * expressions are compiled once and matched against every name.
+ * The caller must hold the lock that protects the table.
+ */
+c_iter
+v_resolveEntities (
+    c_table entities,
+    const c_char *expression);
+
 void
 v_checkMaxSamplesPerInstanceWarningLevel(
     v_kernel _this,
@@ -0,0 +1,66 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+#ifndef V__MESSAGE_H
+#define V__MESSAGE_H
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#include "v_message.h"
+
+#define V_MESSAGEKEYVALUES_INLINE (8)
+
+/* The key values of a message, extracted on first use and then shared by
+ * every instance table the message is looked up in during one write: the
+ * group instance table and the index of each local DataReader that uses the
+ * topic keys. The structure lives on the stack of the writing thread and
+ * must be deinitialised to release the extracted (string) values.
+ */
+C_CLASS(v_messageKeyValues);
+
+C_STRUCT(v_messageKeyValues) {
+    v_message message;
+    c_array keyList;   /* ARRAY<c_field> the values are extracted with */
+    c_ulong nrOfKeys;
+    c_value *values;   /* NULL until v_messageKeyValuesGet is called */
+    c_value buffer[V_MESSAGEKEYVALUES_INLINE];
+};
+
+void
+v_messageKeyValuesInit(
+    v_messageKeyValues _this,
+    v_message message,
+    c_array keyList);
+
+c_value *
+v_messageKeyValuesGet(
+    v_messageKeyValues _this);
+
+void
+v_messageKeyValuesDeinit(
+    v_messageKeyValues _this);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* V__MESSAGE_H */
@@ -76,6 +76,14 @@ v_observerSetEventData(
     v_observer _this,
     c_voidp eventData);
 
+/* Tests without locking _this whether notifying _this of event would have
+ * no effect because the event is already pending.
+ */
+c_bool
+v__observerNotifyCoalesced(
+    v_observer _this,
+    v_event event);
+
 c_ulong
 v__observerWait(
     v_observer _this);
@@ -85,6 +93,14 @@ v__observerTimedWait(
     v_observer _this,
     const os_duration time);
 
+/* Like v__observerTimedWait, but first polls for a trigger for at most the
+ * configured Domain/WaitStrategy/SpinTime before blocking.
+ */
+c_ulong
+v__observerTimedSpinWait(
+    v_observer _this,
+    const os_duration time);
+
 c_ulong
 v_observerGetEventFlags(
     v_observer _this);
@@ -77,6 +77,16 @@
 #define v_dataReaderNotEmptyInstanceSet(_this) \
         (v_dataReader(_this)->index->notEmptyList)
 
+#define v_dataReaderNotReadInstanceSet(_this) \
+        (v_dataReader(_this)->index->notReadList)
+
+/* A read or take that only accepts NOT_READ samples only needs to visit the
+ * instances in the notReadList instead of all non-empty instances.
+ */
+#define v_dataReaderUseNotReadList(_this, mask) \
+        ((((mask) & V_MASK_ANY_SAMPLE) == V_MASK_NOT_READ_SAMPLE) && \
+         !v_reader(_this)->qos->userKey.v.enable)
+
 const char*
 v_dataReaderResultString(
     v_dataReaderResult result)
@@ -977,6 +987,7 @@ C_STRUCT(readSampleArg) {
     c_voidp arg;
     c_long count;
     c_iter emptyList;
+    c_iter notReadDoneList;
 };
 C_CLASS(readSampleArg);
 
@@ -1025,6 +1036,96 @@ instanceSampleAction(
     return a->action(sample,a->arg);
 }
 
+static c_bool
+only_if_equal (
+    c_object found,
+    c_object requested,
+    c_voidp arg)
+{
+    *(c_bool *)arg = (found == requested);
+    return *(c_bool *)arg;
+}
+
+/* The notReadList holds every instance that may contain samples that have
+ * not been read yet. Samples only ever enter the NOT_READ state when they
+ * are inserted, so an instance is added whenever data is inserted and it is
+ * removed lazily, by read and take operations that find it has no NOT_READ
+ * samples left, or when the instance itself is removed.
+ */
+static c_bool
+instanceHasNotReadSamples(
+    v_dataReaderInstance instance)
+{
+    v_dataReaderSample sample;
+
+    sample = v_dataReaderInstanceNewest(instance);
+    while (sample != NULL) {
+        if (!v_readerSampleTestStateOr(sample, L_READ | L_LAZYREAD)) {
+            return TRUE;
+        }
+        sample = sample->older;
+    }
+    return FALSE;
+}
+
+static void
+notReadListRemove(
+    v_dataReader _this,
+    v_dataReaderInstance instance)
+{
+    c_bool equal = FALSE;
+
+    if (v_dataReaderInstanceInNotReadList(instance)) {
+        (void)c_remove(v_dataReaderNotReadInstanceSet(_this), instance, only_if_equal, &equal);
+        if (equal) {
+            c_free(instance);
+        }
+        v_dataReaderInstanceInNotReadList(instance) = FALSE;
+    }
+}
+
+void
+v_dataReaderNotReadListInsert(
+    v_dataReader _this,
+    v_dataReaderInstance instance)
+{
+    c_object found;
+
+    assert(C_TYPECHECK(_this, v_dataReader));
+    assert(C_TYPECHECK(instance, v_dataReaderInstance));
+
+    if (!v_dataReaderInstanceInNotReadList(instance) &&
+        !v_reader(_this)->qos->userKey.v.enable)
+    {
+        found = c_tableInsert(v_dataReaderNotReadInstanceSet(_this), instance);
+        if (found != instance) {
+            /* A stale entry with the same key, replace it. */
+            notReadListRemove(_this, v_dataReaderInstance(found));
+            found = c_tableInsert(v_dataReaderNotReadInstanceSet(_this), instance);
+        }
+        assert(found == instance);
+        v_dataReaderInstanceInNotReadList(instance) = TRUE;
+    }
+}
+
+static void
+notReadListPurge(
+    v_dataReader _this,
+    c_iter list)
+{
+    v_dataReaderInstance instance;
+
+    if (list != NULL) {
+        instance = c_iterTakeFirst(list);
+        while (instance != NULL) {
+            notReadListRemove(_this, instance);
+            c_free(instance);
+            instance = c_iterTakeFirst(list);
+        }
+        c_iterFree(list);
+    }
+}
+
 static c_bool
 instanceReadSamples(
     v_dataReaderInstance instance,
@@ -1062,6 +1163,21 @@ instanceReadSamples(
     return proceed;
 }
 
+static c_bool
+instanceReadNotReadSamples(
+    v_dataReaderInstance instance,
+    c_voidp arg)
+{
+    readSampleArg a = (readSampleArg)arg;
+    c_bool proceed;
+
+    proceed = instanceReadSamples(instance, arg);
+    if (!instanceHasNotReadSamples(instance)) {
+        a->notReadDoneList = c_iterInsert(a->notReadDoneList, c_keep(instance));
+    }
+    return proceed;
+}
+
 static void
 resetCommunicationStatusFlags(
     v_dataReader _this)
@@ -1200,7 +1316,7 @@ waitForData(
         c_ulong flags = 0;
         os_timeE time = os_timeEGet();
         v__observerSetEvent(v_observer(_this), V_EVENT_DATA_AVAILABLE);
-        flags = v__observerTimedWait(v_observer(_this), *delay);
+        flags = v__observerTimedSpinWait(v_observer(_this), *delay);
         if (flags & V_EVENT_TIMEOUT) {
             result = V_RESULT_TIMEOUT;
         } else {
@@ -1264,9 +1380,17 @@ v_dataReaderRead(
             while ((argument.count == 0) && (result == V_RESULT_OK))
             {
                 argument.emptyList = NULL;
-                (void)c_tableReadCircular(v_dataReaderNotEmptyInstanceSet(_this),
-                                          (c_action)instanceReadSamples,
-                                          &argument);
+                argument.notReadDoneList = NULL;
+                if (v_dataReaderUseNotReadList(_this, mask)) {
+                    (void)c_tableReadCircular(v_dataReaderNotReadInstanceSet(_this),
+                                              (c_action)instanceReadNotReadSamples,
+                                              &argument);
+                    notReadListPurge(_this, argument.notReadDoneList);
+                } else {
+                    (void)c_tableReadCircular(v_dataReaderNotEmptyInstanceSet(_this),
+                                              (c_action)instanceReadSamples,
+                                              &argument);
+                }
 
                 /* The state of an instance can also change because of a read action
                  * in case of an invalid sample.
@@ -1477,6 +1601,23 @@ v_dataReaderReadNextInstance(
     return result;
 }
 
+static c_bool instanceTakeSamples(v_dataReaderInstance instance, c_voidp arg);
+
+static c_bool
+instanceTakeNotReadSamples(
+    v_dataReaderInstance instance,
+    c_voidp arg)
+{
+    readSampleArg a = (readSampleArg)arg;
+    c_bool proceed;
+
+    proceed = instanceTakeSamples(instance, arg);
+    if (!instanceHasNotReadSamples(instance)) {
+        a->notReadDoneList = c_iterInsert(a->notReadDoneList, c_keep(instance));
+    }
+    return proceed;
+}
+
 static c_bool
 instanceTakeSamples(
     v_dataReaderInstance instance,
@@ -1526,16 +1667,6 @@ instanceTakeSamples(
     return proceed;
 }
 
-static c_bool
-only_if_equal (
-    c_object found,
-    c_object requested,
-    c_voidp arg)
-{
-    *(c_bool *)arg = (found == requested);
-    return *(c_bool *)arg;
-}
-
 void
 v_dataReaderRemoveInstance(
     v_dataReader _this,
@@ -1549,6 +1680,7 @@ v_dataReaderRemoveInstance(
 
     doFree = FALSE;
 
+    notReadListRemove(_this, instance);
     if (v_dataReaderInstanceInNotEmptyList(instance)) {
         instanceSet = v_dataReaderNotEmptyInstanceSet(_this);
         equal = FALSE;
@@ -1658,8 +1790,15 @@ v_dataReaderTake(
             while ((argument.count == 0) && (result == V_RESULT_OK))
             {
                 argument.emptyList = NULL;
-                (void)c_tableReadCircular(v_dataReaderNotEmptyInstanceSet(_this),
-                                          (c_action)instanceTakeSamples, &argument);
+                argument.notReadDoneList = NULL;
+                if (v_dataReaderUseNotReadList(_this, mask)) {
+                    (void)c_tableReadCircular(v_dataReaderNotReadInstanceSet(_this),
+                                              (c_action)instanceTakeNotReadSamples, &argument);
+                    notReadListPurge(_this, argument.notReadDoneList);
+                } else {
+                    (void)c_tableReadCircular(v_dataReaderNotEmptyInstanceSet(_this),
+                                              (c_action)instanceTakeSamples, &argument);
+                }
                 if (argument.emptyList != NULL) {
                     emptyInstance = c_iterTakeFirst(argument.emptyList);
                     while (emptyInstance != NULL) {
@@ -2728,6 +2867,9 @@ flushPending(
         c_tableInsert(v_dataReaderInstanceReader(instance)->index->notEmptyList, instance);
         v_dataReaderInstanceInNotEmptyList(instance) = TRUE;
     }
+    if (v_dataReaderInstanceInNotEmptyList(instance)) {
+        v_dataReaderNotReadListInsert(v_dataReaderInstanceReader(instance), instance);
+    }
 
     return TRUE;
 }
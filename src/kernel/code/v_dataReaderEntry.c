@@ -388,6 +388,9 @@ doWrite(
                         c_tableInsert(_this->index->notEmptyList, found);
                         v_dataReaderInstanceInNotEmptyList(found) = TRUE;
                     }
+                    if (v_dataReaderInstanceInNotEmptyList(found)) {
+                        v_dataReaderNotReadListInsert(reader, found);
+                    }
                     if (v_dataReaderInstanceStateTest(found,L_DISPOSED)) {
                         if (!v_gidIsValid(message->writerGID) &&
                             qos->lifecycle.v.autopurge_dispose_all) {
@@ -478,6 +481,17 @@ v_dataReaderEntryWrite(
     v_message message,
     v_instance *instancePtr,
     v_messageContext context)
+{
+    return v_dataReaderEntryWriteKeyed(_this, message, NULL, instancePtr, context);
+}
+
+v_writeResult
+v_dataReaderEntryWriteKeyed(
+    v_dataReaderEntry _this,
+    v_message message,
+    v_messageKeyValues keys,
+    v_instance *instancePtr,
+    v_messageContext context)
 {
     v_writeResult result = V_WRITE_REJECTED;
     v_dataReader reader;
@@ -553,6 +567,31 @@ v_dataReaderEntryWrite(
             return V_WRITE_SUCCESS;
         }
 
+        /* If the caller already extracted the key values of the message and
+         * the reader uses the same keys, try to find the existing instance
+         * before creating a new one to insert.
+         * c_tableFind returns a kept reference, which is handed over to
+         * *instancePtr or released here.
+         */
+        if ((keys != NULL) && (keys->message == message) &&
+            (keys->keyList == _this->index->messageKeyList) &&
+            (_this->filterInstance == NULL) && !qos->userKey.v.enable)
+        {
+            found = c_tableFind(_this->index->objects, v_messageKeyValuesGet(keys));
+            if (found != NULL) {
+                V_MESSAGE_STAMP(message,readerLookupTime);
+                result = doWrite(_this, found, message, context,
+                                 &a_work_around_for_dispose_all_to_indicate_the_instance_is_deleted);
+                if (instancePtr && !a_work_around_for_dispose_all_to_indicate_the_instance_is_deleted) {
+                    *instancePtr = v_instance(found);
+                } else {
+                    c_free(found);
+                }
+                v_observerUnlock(v_observer(reader));
+                return result;
+            }
+        }
+
         instance = v_dataReaderInstanceNew(v_dataReader(reader),message);
         if (!instance) {
             OS_REPORT(OS_CRITICAL,
@@ -874,12 +874,25 @@ FindHistoryPosition(
 }
 
 static void
+SampleDetach(
+    v_dataReaderInstance _this,
+    v_dataReaderSample sample,
+    c_bool pushedOutByNewer);
+
+/* Pushes out the oldest samples until there is room for a new one in the
+ * KEEP_LAST history. The last sample pushed out is returned instead of freed
+ * if nobody else references it, so that the caller can reuse it for the new
+ * message: for the common depth-1 "last value" case replacing the value then
+ * costs no allocation at all.
+ */
+static v_dataReaderSample
 ClaimHistorySample(
     v_dataReaderInstance _this,
     v_dataReaderSample insertionpoint)
 {
     v_dataReader reader;
     v_readerQos qos;
+    v_dataReaderSample oldest, recycled = NULL;
 
     reader = v_dataReaderInstanceReader(_this);
     qos = v_reader(reader)->qos;
@@ -894,11 +907,20 @@ ClaimHistorySample(
         } else {
             if (!v_dataReaderInstanceNewest(_this)) break;
         }
-        v_dataReaderInstanceSampleRemove(_this, v_dataReaderInstanceOldest(_this), TRUE);
+        c_free(recycled);
+        oldest = v_dataReaderInstanceOldest(_this);
+        SampleDetach(_this, oldest, TRUE);
+        if (c_refCount(oldest) == 1) {
+            recycled = oldest;
+        } else {
+            recycled = NULL;
+            c_free(oldest);
+        }
         if(reader->statistics){
             reader->statistics->numberOfSamplesDiscarded++;
         }
     }
+    return recycled;
 }
 
 static v_dataReaderResult
@@ -913,6 +935,7 @@ InsertHistory(
     os_int32 equality;
     v_dataReaderResult result;
     v_dataReaderSample sample;
+    v_dataReaderSample recycled = NULL;
     v_state messageState;
     os_boolean filteredOut = OS_FALSE;
 
@@ -991,7 +1014,7 @@ InsertHistory(
             qos->history.v.kind == V_HISTORY_KEEPLAST &&
             !filteredOut)
         {
-            ClaimHistorySample(_this, s);
+            recycled = ClaimHistorySample(_this, s);
         }
     }
 
@@ -1000,7 +1023,12 @@ InsertHistory(
         result = v_dataReaderInstanceClaimResource(_this, message, context);
     }
     if (result == V_DATAREADER_INSERTED) {
-        sample = v_dataReaderSampleNew(_this, message);
+        if (recycled) {
+            sample = v_dataReaderSampleReuse(recycled, _this, message);
+            recycled = NULL;
+        } else {
+            sample = v_dataReaderSampleNew(_this, message);
+        }
         if (sample) {
             if (filteredOut) {
                 v_readerSampleSetState(sample,L_INMINSEPTIME);
@@ -1014,6 +1042,8 @@ InsertHistory(
             result = V_DATAREADER_OUT_OF_MEMORY;
         }
     }
+    /* Pushed out sample not needed after all, e.g. out of resources. */
+    c_free(recycled);
 
     if (result == V_DATAREADER_INSERTED) {
         sample->newer = s;
@@ -2046,8 +2076,8 @@ v_dataReaderInstanceWalkSamples(
     return result;
 }
 
-void
-v_dataReaderInstanceSampleRemove(
+static void
+SampleDetach(
     v_dataReaderInstance _this,
     v_dataReaderSample sample,
     c_bool pushedOutByNewer)
@@ -2122,8 +2152,17 @@ v_dataReaderInstanceSampleRemove(
         }
     }
 
-    /* Free the sample itself. */
     v_readerSampleSetState(sample, L_REMOVED);
+}
+
+void
+v_dataReaderInstanceSampleRemove(
+    v_dataReaderInstance _this,
+    v_dataReaderSample sample,
+    c_bool pushedOutByNewer)
+{
+    SampleDetach(_this, sample, pushedOutByNewer);
+    /* Free the sample itself. */
     c_free(sample);
 }
 
@@ -2637,7 +2676,7 @@ InsertPendingSample(
     result = FindHistoryPosition(_this, message, &s);
     if (result == V_DATAREADER_INSERTED) {
         if (v_messageStateTest(message, L_WRITE) && qos->history.v.kind == V_HISTORY_KEEPLAST) {
-            ClaimHistorySample(_this, s);
+            c_free(ClaimHistorySample(_this, s));
         }
         sample->newer = s;
         if (s == NULL) {
@@ -2755,7 +2794,7 @@ v_dataReaderInstanceCheckMinimumSeparation(
                 v_readerQos qos = v_reader(reader)->qos;
                 /* no longer within the window so make sample available, update states. */
                 if (qos->history.v.kind == V_HISTORY_KEEPLAST) {
-                    ClaimHistorySample(_this,NULL); /* Pushes out oldest sample in case of history is full */
+                    c_free(ClaimHistorySample(_this,NULL)); /* Pushes out oldest sample in case of history is full */
                 }
                 v_readerSampleClearState(sample, L_INMINSEPTIME);
                 updateFinalInstanceAndSampleState(_this, msg, sample);
@@ -30,87 +30,123 @@
 #include "v__lifespanAdmin.h"
 #include "os_report.h"
 
-v_dataReaderSample
-v_dataReaderSampleNew(
+static void
+v_dataReaderSampleInit(
+    v_dataReaderSample sample,
     v_dataReaderInstance instance,
     v_message message)
 {
     v_dataReader dataReader;
-    v_dataReaderSample sample;
     v_readerQos readerQos;
     v_index index;
     os_timeE msgEpoch;
 
-    assert(instance != NULL);
-    assert(C_TYPECHECK(message,v_message));
-
     index = v_index(instance->index);
     dataReader = v_dataReader(index->reader);
     readerQos = v_reader(dataReader)->qos;
     assert(readerQos);
 
-    sample = v_dataReaderSample(c_new(dataReader->sampleType));
-    if (sample != NULL) {
-        v_readerSample(sample)->instance = (c_voidp)instance;
-        v_readerSample(sample)->viewSamples = NULL;
-        v_readerSample(sample)->sampleState = 0;
+    v_readerSample(sample)->instance = (c_voidp)instance;
+    v_readerSample(sample)->viewSamples = NULL;
+    v_readerSample(sample)->sampleState = 0;
 
-        sample->insertTime = os_timeWGet();
+    sample->insertTime = os_timeWGet();
 
-        /* The expiry time calculation is dependent on the DestinationOrderQos(readerQos->orderby.v.kind):
-         * In case of the by_reception_timestamp kind the expiry time is determined based on insertion time(sample->insertTime).
-         * In case of the by_source_timestamp kind the expiry time is determined based on source time (message->writeTime).
-         * see OSPL-871
-         */
+    /* The expiry time calculation is dependent on the DestinationOrderQos(readerQos->orderby.v.kind):
+     * In case of the by_reception_timestamp kind the expiry time is determined based on insertion time(sample->insertTime).
+     * In case of the by_source_timestamp kind the expiry time is determined based on source time (message->writeTime).
+     * see OSPL-871
+     */
 
-        msgEpoch = os_timeEGet();
-        if (readerQos->orderby.v.kind == V_ORDERBY_SOURCETIME) {
-            /* assuming wall clocks of source and destination are aligned!
-             * calculate the age of the message and then correct the message epoch.
-             */
-            os_duration message_age = os_timeWDiff(os_timeWGet(), message->writeTime);
-            msgEpoch = os_timeESub(msgEpoch, message_age);
-        }
-        v_dataReaderSampleTemplate(sample)->message = c_keep(message);
-        sample->disposeCount = instance->disposeCount;
-        sample->noWritersCount = instance->noWritersCount;
-        sample->publicationHandle = message->writerGID;
-        sample->readId = 0;
-        sample->newer = NULL;
-         /* When both ReaderLifespanQos(readerQos->lifespan.used) and the inline LifespanQos (v_messageQos_getLifespanPeriod(message->qos))
-          * are set the expiryTime will be set to the earliest time among them.
-          */
-        if (message->qos) {
-            os_duration lifespan = v_messageQos_getLifespanPeriod(message->qos);
-            if (readerQos->lifespan.v.used) {
-                if (os_durationCompare(readerQos->lifespan.v.duration, lifespan) == OS_LESS) {
-                    v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch, readerQos->lifespan.v.duration);
-                } else {
-                    v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch, lifespan);
-                }
-                v_lifespanAdminInsert(v_dataReaderEntry(index->entry)->lifespanAdmin, v_lifespanSample(sample));
+    msgEpoch = os_timeEGet();
+    if (readerQos->orderby.v.kind == V_ORDERBY_SOURCETIME) {
+        /* assuming wall clocks of source and destination are aligned!
+         * calculate the age of the message and then correct the message epoch.
+         */
+        os_duration message_age = os_timeWDiff(os_timeWGet(), message->writeTime);
+        msgEpoch = os_timeESub(msgEpoch, message_age);
+    }
+    v_dataReaderSampleTemplate(sample)->message = c_keep(message);
+    sample->disposeCount = instance->disposeCount;
+    sample->noWritersCount = instance->noWritersCount;
+    sample->publicationHandle = message->writerGID;
+    sample->readId = 0;
+    sample->newer = NULL;
+     /* When both ReaderLifespanQos(readerQos->lifespan.used) and the inline LifespanQos (v_messageQos_getLifespanPeriod(message->qos))
+      * are set the expiryTime will be set to the earliest time among them.
+      */
+    if (message->qos) {
+        os_duration lifespan = v_messageQos_getLifespanPeriod(message->qos);
+        if (readerQos->lifespan.v.used) {
+            if (os_durationCompare(readerQos->lifespan.v.duration, lifespan) == OS_LESS) {
+                v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch, readerQos->lifespan.v.duration);
             } else {
-                if (OS_DURATION_ISINFINITE(lifespan)) {
-                    v_lifespanSample(sample)->expiryTime = OS_TIMEE_INFINITE;
-                } else {
-                    v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch, lifespan);
-                    v_lifespanAdminInsert(v_dataReaderEntry(index->entry)->lifespanAdmin, v_lifespanSample(sample));
-                }
+                v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch, lifespan);
             }
+            v_lifespanAdminInsert(v_dataReaderEntry(index->entry)->lifespanAdmin, v_lifespanSample(sample));
         } else {
-            if (readerQos->lifespan.v.used) {
-                v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch,readerQos->lifespan.v.duration);
-                v_lifespanAdminInsert(v_dataReaderEntry(index->entry)->lifespanAdmin, v_lifespanSample(sample));
-            } else {
+            if (OS_DURATION_ISINFINITE(lifespan)) {
                 v_lifespanSample(sample)->expiryTime = OS_TIMEE_INFINITE;
+            } else {
+                v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch, lifespan);
+                v_lifespanAdminInsert(v_dataReaderEntry(index->entry)->lifespanAdmin, v_lifespanSample(sample));
             }
         }
+    } else {
+        if (readerQos->lifespan.v.used) {
+            v_lifespanSample(sample)->expiryTime = os_timeEAdd(msgEpoch,readerQos->lifespan.v.duration);
+            v_lifespanAdminInsert(v_dataReaderEntry(index->entry)->lifespanAdmin, v_lifespanSample(sample));
+        } else {
+            v_lifespanSample(sample)->expiryTime = OS_TIMEE_INFINITE;
+        }
+    }
+}
+
+v_dataReaderSample
+v_dataReaderSampleNew(
+    v_dataReaderInstance instance,
+    v_message message)
+{
+    v_dataReader dataReader;
+    v_dataReaderSample sample;
+
+    assert(instance != NULL);
+    assert(C_TYPECHECK(message,v_message));
+
+    dataReader = v_dataReader(v_index(instance->index)->reader);
+    sample = v_dataReaderSample(c_new(dataReader->sampleType));
+    if (sample != NULL) {
+        v_dataReaderSampleInit(sample, instance, message);
     } else {
         OS_REPORT(OS_FATAL, OS_FUNCTION, V_RESULT_INTERNAL_ERROR, "Failed to allocate v_dataReaderSample.");
     }
     return sample;
 }
 
+v_dataReaderSample
+v_dataReaderSampleReuse(
+    v_dataReaderSample sample,
+    v_dataReaderInstance instance,
+    v_message message)
+{
+    assert(sample != NULL);
+    assert(C_TYPECHECK(sample, v_dataReaderSample));
+    assert(C_TYPECHECK(message,v_message));
+    /* Only a sample that has been detached from its instance, its views
+     * and the lifespan admin, and that is not referenced by anyone else,
+     * can be reused: it must look exactly like a freshly allocated one.
+     */
+    assert(c_refCount(sample) == 1);
+    assert(sample->older == NULL && sample->newer == NULL);
+    assert(v_readerSample(sample)->viewSamples == NULL);
+    assert(v_lifespanSample(sample)->next == NULL && v_lifespanSample(sample)->prev == NULL);
+
+    c_free(v_dataReaderSampleTemplate(sample)->message);
+    memset(sample, 0, c_typeSize(c_getType(sample)));
+    v_dataReaderSampleInit(sample, instance, message);
+    return sample;
+}
+
 void
 v_dataReaderSampleRemoveFromLifespanAdmin(
     v_dataReaderSample sample)
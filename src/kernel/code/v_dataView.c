@@ -462,7 +462,7 @@ waitForData(
         os_timeE time = os_timeEGet();
         v_observerLock(_this);
         v__observerSetEvent(v_observer(_this), V_EVENT_DATA_AVAILABLE);
-        flags = v__observerTimedWait(v_observer(_this), *delay);
+        flags = v__observerTimedSpinWait(v_observer(_this), *delay);
         v_observerUnlock(_this);
         if (flags & V_EVENT_TIMEOUT) {
             result = V_RESULT_TIMEOUT;
@@ -625,7 +625,7 @@ waitForData(
         c_ulong flags = 0;
         os_timeE time = os_timeEGet();
         v__observerSetEvent(v_observer(_this), V_EVENT_DATA_AVAILABLE);
-        flags = v__observerTimedWait(v_observer(_this), *delay);
+        flags = v__observerTimedSpinWait(v_observer(_this), *delay);
         if (flags & V_EVENT_TIMEOUT) {
             result = V_RESULT_TIMEOUT;
         } else {
@@ -68,6 +68,9 @@ v_entityInit(
 
     if (name == NULL) {
         e->name = NULL;
+    } else if ((v_objectKind(e) == K_DOMAIN) || (v_objectKind(e) == K_TOPIC)) {
+        /* Partitions and topics are looked up by name, see v_resolveEntities. */
+        e->name = c_stringIntern(c_getBase(e),name);
     } else {
         e->name = c_stringNew(c_getBase(e),name);
     }
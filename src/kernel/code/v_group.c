@@ -23,7 +23,7 @@
 #include "v__entry.h"
 #include "v_partition.h"
 #include "v__topic.h"
-#include "v_message.h"
+#include "v__message.h"
 #include "v_messageQos.h"
 #include "v__entity.h"
 #include "v_proxy.h"
@@ -156,6 +156,9 @@ createGroupSampleType(
                                   c_metaObject(sampleType)));
     os_free(name);
     c_free(sampleType);
+    if (foundType != NULL) {
+        (void) c_baseTypeCacheEnable(foundType, V_KERNEL_TYPECACHE_RETAIN);
+    }
 
     return foundType;
 }
@@ -1749,6 +1752,7 @@ C_STRUCT(v_entryWriteArg) {
     c_bool groupRoutingEnabled;
     v_writeResult writeResult;
     v_entry entry;
+    v_messageKeyValues keys; /* may be NULL */
 };
 
 C_CLASS(v_entryWriteArg);
@@ -1889,6 +1893,14 @@ entryWrite(
         /* The message was not addressed to this entry.
          */
         result = V_WRITE_SUCCESS;
+    } else if (writeArg->keys &&
+               v_objectKind(v_entry(proxy->entry)->reader) == K_DATAREADER) {
+        /* Let the DataReader reuse the key values extracted by the group. */
+        result = v_dataReaderEntryWriteKeyed(v_dataReaderEntry(proxy->entry),
+                                             writeArg->message,
+                                             writeArg->keys,
+                                             &instance,
+                                             V_CONTEXT_GROUPWRITE);
     } else {
         result = v_entryWrite(proxy->entry,
                               writeArg->message,
@@ -2155,6 +2167,7 @@ static v_writeResult
 forwardMessage (
     v_groupInstance instance,
     v_message message,
+    v_messageKeyValues keys,
     v_networkId writingNetworkId,
     v_entry entry,
     c_bool bypassCache,
@@ -2187,6 +2200,7 @@ forwardMessage (
         writeArg.networkId = writingNetworkId;
         writeArg.groupRoutingEnabled = group->routingEnabled;
         writeArg.entry = entry;
+        writeArg.keys = keys;
 
         /* If the sample has no valid content, replace the typed sample
          * with an untyped sample to save storage space, but only
@@ -2643,31 +2657,9 @@ v_resendScopeImage (
 static v_groupInstance
 lookupInstanceByMessage(
     v_group group,
-    v_message msg)
+    v_messageKeyValues keys)
 {
-    v_groupInstance instance;
-    c_value _keyValues[32];
-    c_value *keyValues = _keyValues;
-    c_array messageKeyList;
-    c_ulong i, nrOfKeys;
-
-    messageKeyList = v_topicMessageKeyList(v_groupTopic(group));
-    nrOfKeys = c_arraySize(messageKeyList);
-    if (nrOfKeys > 32) {
-        keyValues = os_malloc(sizeof(c_value) * nrOfKeys);
-    }
-    for (i=0;i<nrOfKeys;i++) {
-        keyValues[i] = c_fieldValue(messageKeyList[i], msg);
-    }
-    instance = c_tableFind(group->instances, &keyValues[0]);
-    /* Key values have to be freed again */
-    for (i=0;i<nrOfKeys;i++) {
-        c_valueFreeRef(keyValues[i]);
-    }
-    if (nrOfKeys > 32) {
-        os_free(keyValues);
-    }
-    return instance;
+    return c_tableFind(group->instances, v_messageKeyValuesGet(keys));
 }
 
 /* As part of scarab#2907, the new inout v_resendScope parameter to groupWrite
@@ -2683,9 +2675,10 @@ lookupInstanceByMessage(
  * value to minimize the resends.
  */
 static v_writeResult
-groupWrite (
+groupWriteKeyed (
     v_group group,
     v_message msg,
+    v_messageKeyValues keys,
     v_groupInstance *instancePtr,
     v_networkId writingNetworkId,
     c_bool stream,
@@ -2714,7 +2707,7 @@ groupWrite (
     qos = v_topicQosRef(group->topic);
 
     if ((instancePtr == NULL) || (*instancePtr == NULL)) {
-        instance = lookupInstanceByMessage(group, msg);
+        instance = lookupInstanceByMessage(group, keys);
         if (instance == NULL) {
             if(v_messageStateTest(msg, L_UNREGISTER)){
                 /* The instance doesn't exist, meaning no writer has it currently
@@ -2840,13 +2833,13 @@ groupWrite (
      * the work for sending of both V_RESEND_VARIANT and V_RESEND_TOPIC
      * functionality (which may be required independently).
      */
-    result = forwardMessage(instance,msg,writingNetworkId, entry, bypassCache, resendScope);
+    result = forwardMessage(instance, msg, keys, writingNetworkId, entry, bypassCache, resendScope);
     if (result == V_WRITE_REJECTED) {
         rejected = TRUE;
         /* if forwardMessage rejects, it will have already set resendScope itself */
     }
     if (result == V_WRITE_SUCCESS && disposeMsg != NULL) {
-        result = forwardMessage(instance, disposeMsg, V_NETWORKID_LOCAL, NULL, 0, &disposeScope);
+        result = forwardMessage(instance, disposeMsg, NULL, V_NETWORKID_LOCAL, NULL, 0, &disposeScope);
     }
 
     /* In case the message contains non volatile data then check the
@@ -2911,6 +2904,29 @@ groupWrite (
     return result;
 }
 
+static v_writeResult
+groupWrite (
+    v_group group,
+    v_message msg,
+    v_groupInstance *instancePtr,
+    v_networkId writingNetworkId,
+    c_bool stream,
+    v_entry entry,
+    v_resendScope *resendScope)
+{
+    C_STRUCT(v_messageKeyValues) keys;
+    v_writeResult result;
+
+    /* The key values are extracted at most once per write and shared by
+     * the group instance lookup and the DataReaders the message is
+     * delivered to without a cached instance pipeline.
+     */
+    v_messageKeyValuesInit(&keys, msg, v_topicMessageKeyList(v_groupTopic(group)));
+    result = groupWriteKeyed(group, msg, &keys, instancePtr, writingNetworkId, stream, entry, resendScope);
+    v_messageKeyValuesDeinit(&keys);
+    return result;
+}
+
 static v_writeResult
 groupWriteEOT (
     v_group group,
@@ -3318,6 +3334,7 @@ v_groupResend (
         arg.networkId   = writingNetworkId;
         arg.writeResult = V_WRITE_SUCCESS;
         arg.entry       = NULL;
+        arg.keys        = NULL;
         arg.groupRoutingEnabled = group->routingEnabled;
 
         v_groupEntrySetWalk(&group->variantEntrySet,
@@ -3812,6 +3829,150 @@ writeHistoricalData(
     return result;
 }
 
+/* A late-joining reader that orders by source timestamp sorts every sample
+ * it receives into its instances and drops duplicates, so the historical
+ * samples need not be delivered under the group lock. For such readers only
+ * a snapshot of the group is taken while holding the lock: every sample
+ * message is kept together with its group instance and the reader instance
+ * found in the target cache. The snapshot is delivered after the lock is
+ * released, so live writers are not blocked by the alignment of the reader
+ * and concurrent updates are merged by the reader instance itself.
+ */
+typedef struct historicalSnapshotSample_s {
+    v_groupInstance instance;
+    v_dataReaderInstance readerInstance; /* only set for the first sample of an instance */
+    v_message message;
+} historicalSnapshotSample;
+
+struct historicalSnapshot {
+    v_entry entry;
+    historicalSnapshotSample *samples;
+    c_ulong length;
+    c_ulong size;
+    v_groupInstance prevGroupInst;
+};
+
+#define HISTORICAL_SNAPSHOT_INITIAL_SIZE (64)
+
+static c_bool
+groupHistoricalSnapshotEnabled(
+    v_group g,
+    v_entry e)
+{
+    v_reader r = v_reader(e->reader);
+
+    /* Transactions are aligned through the transaction administrations,
+     * which are only consistent with the group instances under the group lock.
+     */
+    return ((v_objectKind(r) == K_DATAREADER) &&
+            (r->qos->orderby.v.kind == V_ORDERBY_SOURCETIME) &&
+            (g->transactionAdmin == NULL));
+}
+
+static c_bool
+collectHistoricalSample(
+    v_groupSample sample,
+    c_voidp arg)
+{
+    struct historicalSnapshot *snapshot = (struct historicalSnapshot *)arg;
+    historicalSnapshotSample *s;
+    v_message msg;
+    v_groupInstance gi;
+
+    msg = v_groupSampleTemplate(sample)->message;
+    gi = v_groupInstance(sample->instance);
+
+    if ((!v_stateTest(v_nodeState(msg),L_REGISTER)) &&
+        (!v_stateTest(v_nodeState(msg),L_UNREGISTER))) {
+        if (snapshot->length == snapshot->size) {
+            snapshot->size = (snapshot->size == 0) ? HISTORICAL_SNAPSHOT_INITIAL_SIZE : 2 * snapshot->size;
+            snapshot->samples = os_realloc(snapshot->samples, snapshot->size * sizeof(*snapshot->samples));
+        }
+        s = &snapshot->samples[snapshot->length++];
+        s->instance = c_keep(gi);
+        s->readerInstance = NULL;
+        s->message = c_keep(msg);
+        if (snapshot->prevGroupInst != gi) {
+            struct lookupReaderIntanceArg lriArg;
+            lriArg.trgtEntry = snapshot->entry;
+            lriArg.prevGroupInst = NULL;
+            lriArg.readerInst = NULL;
+            lriArg.result = V_RESULT_OK;
+            (void)v_groupCacheWalk(gi->targetCache, lookupReaderInstance, &lriArg);
+            s->readerInstance = lriArg.readerInst;
+            snapshot->prevGroupInst = gi;
+        }
+    }
+    return TRUE;
+}
+
+static c_bool
+collectHistoricalData(
+    c_object o,
+    c_voidp arg)
+{
+    return v_groupInstanceWalkSamples(v_groupInstance(o), collectHistoricalSample, arg);
+}
+
+static v_result
+deliverHistoricalSnapshot(
+    struct historicalSnapshot *snapshot)
+{
+    v_result result = V_RESULT_OK;
+    v_dataReaderInstance readerInst = NULL;
+    historicalSnapshotSample *s;
+    v_writeResult writeResult;
+    c_base base;
+    c_ulong i;
+
+    for (i = 0; (i < snapshot->length) && (result == V_RESULT_OK); i++) {
+        s = &snapshot->samples[i];
+        if (s->readerInstance) {
+            c_free(readerInst);
+            readerInst = s->readerInstance;
+            s->readerInstance = NULL;
+        } else if (i > 0 && snapshot->samples[i-1].instance != s->instance) {
+            c_free(readerInst);
+            readerInst = NULL;
+        }
+        base = c_getBase(s->message);
+        if (c_baseMakeMemReservation(base, C_MM_RESERVATION_ZERO)) {
+            if (readerInst == NULL && c_getType(s->message) == v_kernelType(v_objectKernel(s->instance), K_MESSAGE)) {
+                v_message typedMessage = v_groupInstanceCreateTypedInvalidMessage(s->instance, s->message);
+                writeResult = v_entryWrite(snapshot->entry, typedMessage, V_NETWORKID_LOCAL, FALSE, (v_instance *)&readerInst, V_CONTEXT_GETHISTORY);
+                c_free(typedMessage);
+            } else {
+                writeResult = v_entryWrite(snapshot->entry, s->message, V_NETWORKID_LOCAL, FALSE, (v_instance *)&readerInst, V_CONTEXT_GETHISTORY);
+            }
+            c_baseReleaseMemReservation(base, C_MM_RESERVATION_ZERO);
+
+            if (writeResult != V_WRITE_SUCCESS) {
+                 OS_REPORT(OS_CRITICAL,
+                           "v_group::deliverHistoricalSnapshot",writeResult,
+                           "deliverHistoricalSnapshot(0x%"PA_PRIxADDR") failed with result %d.",
+                           (os_address)s->message, writeResult);
+            }
+        } else {
+            result = V_RESULT_OUT_OF_MEMORY;
+            OS_REPORT(OS_CRITICAL,
+                      "v_group::deliverHistoricalSnapshot",result,
+                      "deliverHistoricalSnapshot(0x%"PA_PRIxADDR") failed: out of memory.",
+                      (os_address)s->message);
+        }
+    }
+    c_free(readerInst);
+
+    /* Release the snapshot, including the part that was not delivered. */
+    for (i = 0; i < snapshot->length; i++) {
+        s = &snapshot->samples[i];
+        c_free(s->readerInstance);
+        c_free(s->message);
+        c_free(s->instance);
+    }
+    os_free(snapshot->samples);
+    return result;
+}
+
 
 struct writeTransactionArg {
     v_dataReaderEntry entry;
@@ -3930,20 +4091,34 @@ v_groupGetHistoricalData(
 {
     v_result result = V_RESULT_OK;
     v_topicQos qos;
+    struct historicalSnapshot snapshot;
 
     assert(g != NULL);
     assert(C_TYPECHECK(g,v_group));
     assert(e != NULL);
     assert(C_TYPECHECK(e,v_entry));
 
+    snapshot.samples = NULL;
+    snapshot.length = 0;
+
     c_mutexLock(&g->mutex);
     qos = v_topicQosRef(g->topic);
     if (qos->durability.v.kind != V_DURABILITY_VOLATILE) {
         updatePurgeList(g, os_timeEGet());
-        result = groupGetHistoricalData(g, e, openTransactions);
+        if (groupHistoricalSnapshotEnabled(g, e)) {
+            snapshot.entry = e;
+            snapshot.size = 0;
+            snapshot.prevGroupInst = NULL;
+            (void)c_tableWalk(g->instances, collectHistoricalData, &snapshot);
+        } else {
+            result = groupGetHistoricalData(g, e, openTransactions);
+        }
     }
     c_mutexUnlock(&g->mutex);
 
+    if (snapshot.samples) {
+        result = deliverHistoricalSnapshot(&snapshot);
+    }
     return result;
 }
 
@@ -20,6 +20,7 @@
 #include "v__index.h"
 #include "os_heap.h"
 #include "v__topic.h"
+#include "v__kernel.h"
 #include "v_state.h"
 #include "v_event.h"
 #include "v__dataReader.h"
@@ -106,6 +107,9 @@ sampleTypeNew(
             foundType = c_type(c_metaBind(c_metaObject(base),
                                           name,
                                           c_metaObject(sampleType)));
+            if (foundType != NULL) {
+                (void) c_baseTypeCacheEnable(foundType, V_KERNEL_TYPECACHE_RETAIN);
+            }
             c_free(o);
         } else {
             foundType = NULL;
@@ -347,6 +351,7 @@ v_indexInit(
     index->messageKeyList = c_keep(keyList);    /* keyList is either topic->messageKeyList or a user-defined keylist */
     index->objects = c_tableNew(instanceType,keyExpr);
     index->notEmptyList = c_tableNew(instanceType,keyExpr);
+    index->notReadList = c_tableNew(instanceType,keyExpr);
 
     if(keyExpr){
         os_freea(keyExpr);
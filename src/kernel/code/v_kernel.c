@@ -82,6 +82,7 @@
 #define V_KERNEL_MAX_SAMPLES_PER_INSTANCES_WARN_LEVEL_MIN 1
 #define V_KERNEL_RETENTION_PERIOD_DEF 500u
 #define V_KERNEL_RETENTION_PERIOD_MIN 1u
+#define V_KERNEL_WAIT_SPIN_TIME_MAX 1000000u
 
 static v_result
 v_loadWarningLevels(
@@ -93,6 +94,11 @@ v_loadRetentionPeriod(
     v_kernel kernel,
     v_configuration config);
 
+static v_result
+v_loadWaitStrategy(
+    v_kernel kernel,
+    v_configuration config);
+
 static v_result
 v_loadDurabilitySupport(
     v_kernel kernel);
@@ -873,14 +879,10 @@ v_kernelWaitForDurabilityAvailability(
     return result;
 }
 
-static c_type init_kernel_type (c_base base, const char *module, const char *name)
+static c_type init_kernel_type (c_metaObject module, const char *name)
 {
-    char tmp[256];
     c_type t;
-    int n = snprintf (tmp, sizeof (tmp), "%s::%s", module, name);
-    assert (n > 0 && (size_t)n < sizeof (tmp));
-    (void) n;
-    t = c_resolve (base, tmp);
+    t = c_type (c_metaResolveFixedScope (module, name));
     assert (t != NULL);
     return t;
 }
@@ -998,13 +1000,19 @@ static void init_kernel_type_cache (v_kernel kernel)
         { K_TID,                       "v_tid" }
     };
     c_base const base = c_getBase (kernel);
+    c_metaObject module;
     size_t i;
+    /* Resolve the modules once instead of parsing a scoped name per type. */
+    module = c_metaResolve (c_metaObject (base), "kernelModuleI");
     for (i = 0; i < sizeof (tsi) / sizeof (tsi[0]); i++) {
-        kernel->type[tsi[i].ix] = init_kernel_type (base, "kernelModuleI", tsi[i].n);
+        kernel->type[tsi[i].ix] = init_kernel_type (module, tsi[i].n);
     }
+    c_free (module);
+    module = c_metaResolve (c_metaObject (base), "kernelModule");
     for (i = 0; i < sizeof (tsx) / sizeof (tsx[0]); i++) {
-        kernel->type[tsx[i].ix] = init_kernel_type (base, "kernelModule", tsx[i].n);
+        kernel->type[tsx[i].ix] = init_kernel_type (module, tsx[i].n);
     }
+    c_free (module);
 }
 
 
@@ -1111,6 +1119,8 @@ v_kernelNew(
 
     retPeriod = V_KERNEL_RETENTION_PERIOD_DEF * OS_DURATION_MILLISECOND;
     kernel->retentionPeriod = retPeriod;
+    kernel->waitSpinTime = OS_DURATION_ZERO;
+    kernel->wakeLatencyStatistics = FALSE;
 
     c_mutexInit(c_getBase(kernel), &kernel->sharesMutex);
     kernel->shares = c_tableNew(v_kernelType(kernel,K_SUBSCRIBER), "qos.share.v.name");
@@ -1478,27 +1488,67 @@ v_resolveParticipants(
     return list;
 }
 
+struct resolveEntitiesArg {
+    c_stringMatcher matcher;
+    c_iter list;
+};
+
+static c_bool
+resolveEntity(
+    c_object o,
+    c_voidp arg)
+{
+    struct resolveEntitiesArg *a = (struct resolveEntitiesArg *)arg;
+
+    if (c_stringMatcherMatch(a->matcher, v_entityName(o))) {
+        a->list = c_iterAppend(a->list, c_keep(o));
+    }
+    return TRUE;
+}
+
+c_iter
+v_resolveEntities(
+    c_table entities,
+    const c_char *expression)
+{
+    struct resolveEntitiesArg arg;
+    c_value key;
+    c_object found;
+
+    assert(entities != NULL);
+    assert(expression != NULL);
+
+    arg.list = c_iterNew(NULL);
+    if (v_partitionExpressionIsAbsolute(expression)) {
+        /* A plain lookup key: interning it would add a table entry for
+         * every name ever queried.
+         */
+        key = c_stringValue((c_string)expression);
+        found = c_tableFind(entities, &key);
+        if (found != NULL) {
+            arg.list = c_iterAppend(arg.list, found);
+        }
+    } else {
+        arg.matcher = c_stringMatcherNew(expression);
+        (void)c_walk(entities, resolveEntity, &arg);
+        c_stringMatcherFree(arg.matcher);
+    }
+    return arg.list;
+}
+
 c_iter
 v_resolvePartitions (
     v_kernel kernel,
     const c_char *name)
 {
     c_iter list;
-    c_collection q;
-    q_expr expr;
-    c_value params[1];
 
     assert(kernel != NULL);
     assert(C_TYPECHECK(kernel,v_kernel));
 
-    expr = (q_expr)q_parse("name like %0");
-    params[0] = c_stringValue((char *)name);
-    q = c_queryNew(kernel->partitions,expr,params);
-    q_dispose(expr);
     c_lockRead(&kernel->lock);
-    list = ospl_c_select(q,0);
+    list = v_resolveEntities(kernel->partitions, name);
     c_lockUnlock(&kernel->lock);
-    c_free(q);
     return list;
 }
 
@@ -1508,21 +1558,13 @@ v_resolveTopics(
     const c_char *name)
 {
     c_iter list;
-    c_collection q;
-    q_expr expr;
-    c_value params[1];
 
     assert(kernel != NULL);
     assert(C_TYPECHECK(kernel,v_kernel));
 
-    expr = (q_expr)q_parse("name like %0");
-    params[0] = c_stringValue((char *)name);
-    q = c_queryNew(kernel->topics,expr,params);
-    q_dispose(expr);
     c_lockRead(&kernel->lock);
-    list = ospl_c_select(q,0);
+    list = v_resolveEntities(kernel->topics, name);
     c_lockUnlock(&kernel->lock);
-    c_free(q);
     return list;
 }
 
@@ -1613,6 +1655,9 @@ v_kernelConfigure(
     if (result == V_RESULT_OK) {
         result = v_loadRetentionPeriod(kernel, config);
     }
+    if (result == V_RESULT_OK) {
+        result = v_loadWaitStrategy(kernel, config);
+    }
     if (result == V_RESULT_OK) {
         result = v_loadDurabilitySupport(kernel);
     }
@@ -1833,6 +1878,62 @@ v_loadRetentionPeriod(
 }
 #undef MILLION
 
+static v_result
+v_loadWaitStrategy(
+    v_kernel kernel,
+    v_configuration config)
+{
+    c_iter iter;
+    v_cfData elementData = NULL;
+    c_value value;
+    v_cfElement root;
+    c_ulong spinTime;
+
+    assert(kernel != NULL);
+    assert(C_TYPECHECK(kernel,v_kernel));
+    assert(config != NULL);
+    assert(C_TYPECHECK(config,v_configuration));
+
+    root = v_configurationGetRoot(config);
+    /* load the time waiting threads poll before they block */
+    iter = v_cfElementXPath(root, "Domain/WaitStrategy/SpinTime/#text");
+    while(c_iterLength(iter) > 0)
+    {
+        elementData = v_cfData(c_iterTakeFirst(iter));
+    }
+    if(iter)
+    {
+        c_iterFree(iter);
+    }
+    if(elementData)/* aka the last one from the previous while loop */
+    {
+        value = v_cfDataValue(elementData);
+        if (sscanf(value.is.String, "%u", &spinTime) == 1) {
+            if (spinTime > V_KERNEL_WAIT_SPIN_TIME_MAX) {
+                spinTime = V_KERNEL_WAIT_SPIN_TIME_MAX;
+            }
+            kernel->waitSpinTime = spinTime * OS_DURATION_MICROSECOND;
+        }
+    }
+    elementData = NULL;
+    /* load whether wake latencies are recorded */
+    iter = v_cfElementXPath(root, "Domain/WaitStrategy/WakeLatencyStatistics/#text");
+    while(c_iterLength(iter) > 0)
+    {
+        elementData = v_cfData(c_iterTakeFirst(iter));
+    }
+    if(iter)
+    {
+        c_iterFree(iter);
+    }
+    if(elementData)
+    {
+        value = v_cfDataValue(elementData);
+        kernel->wakeLatencyStatistics = (os_strcasecmp(value.is.String, "true") == 0);
+    }
+    return V_RESULT_OK;
+}
+
 void
 v_checkMaxInstancesWarningLevel(
     v_kernel _this,
@@ -2419,17 +2520,24 @@ v_kernel_load_xml_descriptor (
 
     base = c_getBase(c_object(_this));
     if ( base ) {
-        serializer = sd_serializerXMLTypeinfoNew(base, TRUE);
-        serData = sd_serializerFromString(serializer, xml_descriptor);
-        type = c_metaObject(sd_serializerDeserialize(serializer, serData));
-        if (type != NULL) {
-            c_free(type);
+        /* Every participant registers its types, skip parsing descriptors
+         * that have been loaded by this or another process already. */
+        if (c_baseLookupTypeDescriptor(base, xml_descriptor)) {
             result = V_RESULT_OK;
         } else {
-            result = V_RESULT_ILL_PARAM;
+            serializer = sd_serializerXMLTypeinfoNew(base, TRUE);
+            serData = sd_serializerFromString(serializer, xml_descriptor);
+            type = c_metaObject(sd_serializerDeserialize(serializer, serData));
+            if (type != NULL) {
+                c_baseRegisterTypeDescriptor(base, xml_descriptor);
+                c_free(type);
+                result = V_RESULT_OK;
+            } else {
+                result = V_RESULT_ILL_PARAM;
+            }
+            sd_serializedDataFree(serData);
+            sd_serializerFree(serializer);
         }
-        sd_serializedDataFree(serData);
-        sd_serializerFree(serializer);
     } else {
         result = V_RESULT_ILL_PARAM;
     }
@@ -21,6 +21,7 @@
 #include "v_statistics.h"
 #include "v_kernelStatistics.h"
 #include "v_maxValue.h"
+#include "os_atomics.h"
 
 v_kernelStatistics v_kernelStatisticsNew(v_kernel k)
 {
@@ -51,6 +52,10 @@ void v_kernelStatisticsInit(v_kernelStatistics ks)
     ks->shmClaims = 0;
     ks->shmClaimFails = 0;
     ks->shmGarbage = 0;
+    pa_st32(&ks->spinWakeups, 0);
+    pa_st32(&ks->blockWakeups, 0);
+    memset(ks->spinWakeLatency, 0, sizeof(ks->spinWakeLatency));
+    memset(ks->blockWakeLatency, 0, sizeof(ks->blockWakeLatency));
 }
 
 void v_kernelStatisticsDeinit(v_kernelStatistics ks)
@@ -69,4 +74,24 @@ void v_kernelStatisticsFree(v_kernelStatistics ks)
     c_free(ks);
 }
 
+void v_kernelStatisticsWakeup(v_kernelStatistics ks, os_duration latency, c_bool spinning)
+{
+    os_int64 us;
+    c_ulong bin = 0;
 
+    assert(ks != NULL);
+    assert(C_TYPECHECK(ks, v_kernelStatistics));
+
+    us = latency / OS_DURATION_MICROSECOND;
+    while ((us > 0) && (bin < V_WAKE_LATENCY_BINS - 1)) {
+        us >>= 1;
+        bin++;
+    }
+    if (spinning) {
+        pa_inc32(&ks->spinWakeups);
+        pa_inc32(&ks->spinWakeLatency[bin]);
+    } else {
+        pa_inc32(&ks->blockWakeups);
+        pa_inc32(&ks->blockWakeLatency[bin]);
+    }
+}
@@ -18,8 +18,10 @@
  *
  */
 #include "v_kernel.h"
-#include "v_message.h"
+#include "v__message.h"
 #include "v_public.h"
+#include "c_field.h"
+#include "os_heap.h"
 
 /**
  * Compares two sequence-/serial numbers according to RFC 1982.
@@ -123,3 +125,58 @@ v_messageCheckDuplicate (
     return FALSE;
 }
 
+void
+v_messageKeyValuesInit(
+    v_messageKeyValues _this,
+    v_message message,
+    c_array keyList)
+{
+    assert(_this != NULL);
+    assert(C_TYPECHECK(message,v_message));
+
+    _this->message = message;
+    _this->keyList = keyList;
+    _this->nrOfKeys = c_arraySize(keyList);
+    _this->values = NULL;
+}
+
+c_value *
+v_messageKeyValuesGet(
+    v_messageKeyValues _this)
+{
+    c_ulong i;
+
+    assert(_this != NULL);
+
+    if (_this->values == NULL) {
+        if (_this->nrOfKeys > V_MESSAGEKEYVALUES_INLINE) {
+            _this->values = os_malloc(sizeof(c_value) * _this->nrOfKeys);
+        } else {
+            _this->values = _this->buffer;
+        }
+        for (i = 0; i < _this->nrOfKeys; i++) {
+            _this->values[i] = c_fieldValue(_this->keyList[i], _this->message);
+        }
+    }
+    return _this->values;
+}
+
+void
+v_messageKeyValuesDeinit(
+    v_messageKeyValues _this)
+{
+    c_ulong i;
+
+    assert(_this != NULL);
+
+    if (_this->values != NULL) {
+        /* Key values have to be freed again */
+        for (i = 0; i < _this->nrOfKeys; i++) {
+            c_valueFreeRef(_this->values[i]);
+        }
+        if (_this->values != _this->buffer) {
+            os_free(_this->values);
+        }
+        _this->values = NULL;
+    }
+}
@@ -19,7 +19,7 @@
  */
 #include "v__observable.h"
 #include "v__entity.h"
-#include "v_observer.h"
+#include "v__observer.h"
 #include "v_proxy.h"
 #include "v_public.h"
 #include "v_event.h"
@@ -165,6 +165,8 @@ v_observableNotify(
 #endif
             if (v_observable(ob) == o) {
                 v_observerNotify(ob,event,proxy->userData);
+            } else if (v__observerNotifyCoalesced(ob,event)) {
+                /* Already pending, skip locking the observer. */
             } else {
                 v_observerLock(ob);
                 v_observerNotify(ob,event, proxy->userData);
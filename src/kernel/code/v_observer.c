@@ -33,6 +33,7 @@
 #include "v__writer.h"
 #include "v__processInfo.h"
 #include "v__kernel.h"
+#include "v_kernelStatistics.h"
 
 #include "v_public.h"
 #include "v_event.h"
@@ -40,6 +41,7 @@
 #include "vortex_os.h"
 #include "os_report.h"
 #include "os_process.h"
+#include "os_atomics.h"
 
 void
 v_observerInit(
@@ -51,6 +53,8 @@ v_observerInit(
     c_mutexInit(c_getBase(o), &o->mutex);  /* mutex to protect attributes */
     c_condInit(c_getBase(o), &o->cv, &o->mutex); /* condition variable */
     o->waitCount = 0;                     /* number of waiting threads */
+    o->spinCount = 0;                     /* number of polling threads */
+    o->triggerTime = OS_TIMEM_INVALID;    /* time of last trigger, for wake latency statistics */
     o->eventMask = 0;                     /* specifies, interested events */
     o->eventFlags = 0;                    /* ocurred events */
     o->eventData = NULL;                  /* general post box for derived classes */
@@ -211,9 +215,14 @@ v_observerNotify(
                 assert(FALSE);
             break;
             }
+            if (notify && ((_this->waitCount > 0) || (_this->spinCount > 0)) &&
+                v_objectKernel(_this)->wakeLatencyStatistics) {
+                _this->triggerTime = os_timeMGet();
+            }
             /*
             * Only trigger condition variable if at least
             * one thread is waiting AND the event is seen for the first time.
+            * Threads that are polling the event flags see the event without it.
             */
             if ((_this->waitCount > 0) && notify)
             {
@@ -229,6 +238,34 @@ v_observerNotify(
     }
 }
 
+c_bool
+v__observerNotifyCoalesced(
+    v_observer _this,
+    v_event event)
+{
+    c_ulong trigger;
+
+    assert(_this != NULL);
+    assert(C_TYPECHECK(_this,v_observer));
+
+    /* A waitset that does not log events only holds trigger bits, so
+     * notifying it of an event that is already pending only repeats
+     * storing those bits: v_observerNotify neither signals the waiting
+     * threads nor does v_waitsetNotify record anything.
+     * The waiting thread clears the bits under the waitset lock before it
+     * evaluates its conditions, so if it cleared them after this test it
+     * is still going to see the change that caused the event.
+     */
+    if ((event == NULL) ||
+        (v_objectKind(_this) != K_WAITSET) ||
+        (v_waitset(_this)->waitsetEventEnabled)) {
+        return FALSE;
+    }
+    pa_fence();
+    trigger = event->kind & _this->eventMask;
+    return ((_this->eventFlags & trigger) == trigger);
+}
+
 c_ulong
 v__observerWait(
     v_observer o)
@@ -263,7 +300,7 @@ v__observerWait(
     /* Reset events but remember destruction event.
      * To avoid any further use of this observer in case of destruction.
      */
-    if (o->waitCount == 0)
+    if ((o->waitCount == 0) && (o->spinCount == 0))
     {
         o->eventFlags &= V_EVENT_OBJECT_DESTROYED;
     }
@@ -286,25 +323,99 @@ v_observerWait(
     return flags;
 }
 
-c_ulong
-v__observerTimedWait(
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+#define V_OBSERVER_SPIN_PAUSE() __asm__ __volatile__ ("pause")
+#else
+#define V_OBSERVER_SPIN_PAUSE() pa_fence()
+#endif
+
+/* Number of pauses between two reads of the clock while spinning. */
+#define V_OBSERVER_SPIN_CHECK_INTERVAL (32)
+
+/* Polls the event flags with the observer unlocked for at most spinTime and
+ * returns the time spent. The thread is accounted in spinCount instead of
+ * waitCount, so v_observerNotify does not broadcast the condition variable
+ * for it and a trigger costs neither side a system call.
+ */
+static os_duration
+observerSpin(
     v_observer o,
-    const os_duration time)
+    os_duration spinTime)
+{
+    volatile c_ulong *eventFlags = &o->eventFlags;
+    os_timeM start = os_timeMGet();
+    os_duration spent = 0;
+    c_ulong i;
+
+    o->spinCount++;
+    c_mutexUnlock(&o->mutex);
+    while ((*eventFlags == 0) && (spent < spinTime)) {
+        for (i = 0; i < V_OBSERVER_SPIN_CHECK_INTERVAL; i++) {
+            V_OBSERVER_SPIN_PAUSE();
+        }
+        spent = os_timeMDiff(os_timeMGet(), start);
+    }
+    (void)c_mutexLock(&o->mutex);
+    o->spinCount--;
+
+    return spent;
+}
+
+static void
+observerWakeup(
+    v_observer o,
+    c_bool spinning)
+{
+    v_kernel kernel = v_objectKernel(o);
+
+    if (kernel->wakeLatencyStatistics && !OS_TIMEM_ISINVALID(o->triggerTime)) {
+        v_kernelStatisticsWakeup(kernel->statistics,
+                                 os_timeMDiff(os_timeMGet(), o->triggerTime),
+                                 spinning);
+    }
+}
+
+static c_ulong
+observerTimedWait(
+    v_observer o,
+    const os_duration time,
+    c_bool spin)
 {
     v_result result = V_RESULT_OK;
     c_ulong flags = 0;
-
-    assert(o != NULL);
-    assert(C_TYPECHECK(o,v_observer));
+    os_duration remaining = time;
+    os_duration spinTime, spent;
+
+    if ((o->eventFlags == 0) && spin) {
+        spinTime = v_objectKernel(o)->waitSpinTime;
+        if (spinTime > 0) {
+            if (time < spinTime) {
+                spinTime = time;
+            }
+            spent = observerSpin(o, spinTime);
+            if (o->eventFlags != 0) {
+                observerWakeup(o, TRUE);
+                flags = o->eventFlags;
+            } else if (!OS_DURATION_ISINFINITE(time)) {
+                remaining = time - spent;
+                if (remaining <= 0) {
+                    o->eventFlags |= V_EVENT_TIMEOUT;
+                    flags = o->eventFlags;
+                }
+            }
+        }
+    }
 
     if (o->eventFlags == 0) {
         o->waitCount++;
         EVENT_TRACE("v__observerTimedWait Block %s(0x%x) eventFlags(0x%x)\n",
                      v_objectKindImage(o), o, o->eventFlags);
-        result = v_condWait(&o->cv,&o->mutex, time);
+        result = v_condWait(&o->cv,&o->mutex, remaining);
         o->waitCount--;
         if (result == V_RESULT_TIMEOUT) {
             o->eventFlags |= V_EVENT_TIMEOUT;
+        } else {
+            observerWakeup(o, FALSE);
         }
         flags = o->eventFlags;
         EVENT_TRACE("v__observerTimedWait: WakeUp %s(0x%x) eventFlags(0x%x)\n",
@@ -319,12 +430,34 @@ v__observerTimedWait(
     /* Reset events but remember destruction event.
      * To avoid any further use of this observer in case of destruction.
      */
-    if (o->waitCount == 0) {
+    if ((o->waitCount == 0) && (o->spinCount == 0)) {
         o->eventFlags &= V_EVENT_OBJECT_DESTROYED;
     }
     return flags;
 }
 
+c_ulong
+v__observerTimedWait(
+    v_observer o,
+    const os_duration time)
+{
+    assert(o != NULL);
+    assert(C_TYPECHECK(o,v_observer));
+
+    return observerTimedWait(o, time, FALSE);
+}
+
+c_ulong
+v__observerTimedSpinWait(
+    v_observer o,
+    const os_duration time)
+{
+    assert(o != NULL);
+    assert(C_TYPECHECK(o,v_observer));
+
+    return observerTimedWait(o, time, TRUE);
+}
+
 c_ulong
 v_observerTimedWait(
     v_observer o,
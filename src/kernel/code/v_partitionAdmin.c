@@ -20,6 +20,7 @@
 
 #include "v__partitionAdmin.h"
 #include "v_kernel.h"
+#include "v__kernel.h"
 #include "v_entity.h"
 
 #include "v__policy.h"
@@ -476,21 +477,13 @@ v_partitionAdminLookup(
     const c_char *partitionExpr)
 {
     c_iter list;
-    c_collection q;
-    q_expr expr;
-    c_value params[1];
 
     assert(da != NULL);
     assert(C_TYPECHECK(da,v_partitionAdmin));
 
-    expr = (q_expr)q_parse("name like %0");
-    params[0] = c_stringValue((c_char *)partitionExpr);
     c_mutexLock(&da->mutex);
-    q = c_queryNew(da->partitions,expr,params);
-    list = ospl_c_select(q,0);
+    list = v_resolveEntities(da->partitions, partitionExpr);
     c_mutexUnlock(&da->mutex);
-    q_dispose(expr);
-    c_free(q);
 
     return list;
 }
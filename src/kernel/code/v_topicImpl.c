@@ -116,6 +116,9 @@ messageTypeNew(
     foundType = c_type(c_metaBind(c_metaObject(base),name,c_metaObject(type)));
     os_free(name);
     c_free(type);
+    if (foundType != NULL) {
+        (void) c_baseTypeCacheEnable(foundType, V_KERNEL_TYPECACHE_RETAIN);
+    }
 
     return foundType;
 }
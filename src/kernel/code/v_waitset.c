@@ -361,7 +361,7 @@ v_waitsetWait2(
             }
             if (!(triggered) && (v_observerGetEventFlags(v_observer(_this)) == 0)) {
                 EVENT_TRACE("v_waitsetWait: Enter Timed Wait waitset(0x%x)\n", _this);
-                wait_flags = v__observerTimedWait(v_observer(_this),time);
+                wait_flags = v__observerTimedSpinWait(v_observer(_this),time);
                 v__observerClearEventFlags(_this);
                 if (wait_flags & V_EVENT_OBJECT_DESTROYED) {
                     result = V_RESULT_DETACHING;
@@ -440,7 +440,7 @@ v_waitsetWait(
            (!(wait_flags & (V_EVENT_OBJECT_DESTROYED | V_EVENT_TIMEOUT))))
     {
         EVENT_TRACE("v_waitsetWait: -- waitset(0x%x) No events => block!\n", _this);
-        wait_flags = v__observerTimedWait(v_observer(_this),time);
+        wait_flags = v__observerTimedSpinWait(v_observer(_this),time);
         EVENT_TRACE("v_waitsetWait: -- waitset(0x%x) Trigger! => unblock! result flags = 0x%x\n", _this, wait_flags);
         eventList = v_waitsetEvent(v_waitsetEventList(_this));
     }
@@ -1381,6 +1381,9 @@ createWriterSampleType(
                                   c_metaObject(sampleType)));
     os_free(name);
     c_free(sampleType);
+    if (foundType != NULL) {
+        (void) c_baseTypeCacheEnable(foundType, V_KERNEL_TYPECACHE_RETAIN);
+    }
 
     return foundType;
 }
@@ -54,6 +54,15 @@ OS_API void
 v_kernelStatisticsFree(
     v_kernelStatistics _this);
 
+/* Records the time it took a waiting thread to observe a trigger, spinning
+ * tells whether the thread was polling or blocked on its condition variable.
+ */
+OS_API void
+v_kernelStatisticsWakeup(
+    v_kernelStatistics _this,
+    os_duration latency,
+    c_bool spinning);
+
 #undef OS_API
 
 #endif
@@ -249,6 +249,12 @@ void ddsi_serstate_release (serstate_t st)
   if (pa_dec32_nv (&st->refcount) == 0)
   {
     serstatepool_t pool = st->pool;
+    serdata_t compressed = pa_ldvoidp (&st->compressed);
+    if (compressed != NULL && compressed != st->data)
+    {
+      ddsi_serdata_unref (compressed);
+    }
+    pa_stvoidp (&st->compressed, NULL);
 #if USE_ATOMIC_LIFO
     if (pa_inc32_nv(&pool->approx_nfree) <= MAX_POOL_SIZE)
       os_atomic_lifo_push (&pool->freelist, st, offsetof (struct serstate, next));
@@ -50,11 +50,19 @@
 #if PLATFORM_IS_LITTLE_ENDIAN
 #define CDR_BE 0x0000
 #define CDR_LE 0x0100
+#define CDR_COMPRESSED 0x00c0
 #else
 #define CDR_BE 0x0000
 #define CDR_LE 0x0001
+#define CDR_COMPRESSED 0xc000
 #endif
 
+/* CDR_COMPRESSED is a vendor-specific encapsulation (wire bytes c0 00)
+   only ever sent to OpenSplice readers: the options field holds the
+   compression algorithm (big-endian, see q_compress.h), followed by a
+   big-endian 32-bit length and the compressed CDRHeader + payload of
+   the original sample. */
+
 typedef struct serstatepool * serstatepool_t;
 typedef struct serstate * serstate_t;
 typedef struct serdata * serdata_t;
@@ -96,6 +104,7 @@ struct serstate
   enum serstate_kind kind;
   serstatepool_t pool;
   struct serstate *next; /* in pool->freelist */
+  pa_voidp_t compressed; /* serdata_t: compressed form of data, data itself if incompressible, or NULL if not yet known (see q_compress.c) */
 };
 
 struct serstatepool
@@ -0,0 +1,736 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "os_heap.h"
+#include "os_mutex.h"
+#include "os_rwlock.h"
+#include "os_atomics.h"
+#include "os_socket.h"
+#include "ddsi_tran.h"
+#include "ddsi_shm.h"
+#include "q_nwif.h"
+#include "q_config.h"
+#include "q_globals.h"
+#include "q_time.h"
+#include "q_log.h"
+#include "sysdeps.h"
+
+#if SYSDEPS_HAVE_SHM_FUTEX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+extern void ddsi_factory_conn_init (ddsi_tran_factory_t factory, ddsi_tran_conn_t conn);
+
+#define DDSI_SHM_MAGIC 0x4444534du /* "DDSM" */
+#define DDSI_SHM_VERSION 2u
+#define DDSI_SHM_CACHELINE 64u
+#define DDSI_SHM_SLOTHDR_SIZE 16u
+#define DDSI_SHM_MAX_SLOTS 65536u
+#define DDSI_SHM_MAX_PEERS 64
+
+#define DDSI_SHM_WAIT_TIMEOUT (100 * T_MILLISECOND) /* so the receive thread notices termination */
+#define DDSI_SHM_RECHECK_INTERVAL T_SECOND /* revalidation of attached/absent peer rings */
+#define DDSI_SHM_STALL_TIMEOUT T_SECOND /* for skipping slots claimed by a producer that died */
+#define DDSI_SHM_ORPHAN_TIMEOUT (30 * T_SECOND) /* same, but if it died before recording its pid */
+
+/* A ring is a POSIX shared memory object named after the unicast data
+   port of its owner, containing a header followed by a power-of-two
+   number of fixed-size slots. It is a bounded multi-producer,
+   single-consumer queue: a producer (any transmitting thread of any
+   DDSI2 instance on the host) claims a position with a CAS on tail and
+   publishes it by advancing the slot's sequence number; the consumer
+   (the owner's shm receive thread) keeps its position privately and
+   frees a slot by advancing the sequence number by another lap.
+
+   The consumer only sleeps (on the wakeup futex) after setting
+   "sleeping", and producers only make the wake-up system call when
+   they see it set, so in a busy system no system calls are made at
+   all. Producer state, consumer state and the identification each
+   have their own cache line. */
+struct ddsi_shm_hdr {
+  os_uint32 magic; /* set last by the owner, so a half-initialised ring is never used */
+  os_uint32 version;
+  os_uint32 nslots;
+  os_uint32 slotsize;
+  os_uint32 stride;
+  pa_uint32_t closed;
+  char pad0[DDSI_SHM_CACHELINE - 6 * sizeof (os_uint32)];
+  pa_uint32_t tail;
+  char pad1[DDSI_SHM_CACHELINE - sizeof (os_uint32)];
+  pa_uint32_t wakeup;
+  pa_uint32_t sleeping;
+  char pad2[DDSI_SHM_CACHELINE - 2 * sizeof (os_uint32)];
+};
+
+struct ddsi_shm_slot {
+  pa_uint32_t seq;
+  os_uint32 len;
+  pa_uint32_t pid; /* of the producer that claimed it, 0 once consumed */
+  os_uint32 pad;
+  unsigned char data[DDSI_SHM_CACHELINE - DDSI_SHM_SLOTHDR_SIZE]; /* actually slotsize */
+};
+
+/* Geometry is copied out of the header when mapping the ring, and
+   only these private copies are used for addressing slots */
+struct ddsi_shm_ring {
+  struct ddsi_shm_hdr *hdr;
+  os_size_t size;
+  os_uint32 mask;
+  os_uint32 slotsize;
+  os_uint32 stride;
+};
+
+struct ddsi_shm_peer_ring {
+  pa_uint32_t refc;
+  struct ddsi_shm_ring ring;
+  dev_t dev;
+  ino_t ino;
+};
+
+struct ddsi_shm_peer {
+  os_uint32 port;
+  nn_mtime_t tcheck;
+  struct ddsi_shm_peer_ring *pr; /* NULL: no ring for this port (as of tcheck) */
+  pa_uint32_t used; /* written to since the last eviction scan */
+};
+
+typedef struct ddsi_shm_conn
+{
+  struct ddsi_tran_conn m_base;
+  struct ddsi_shm_ring m_ring;
+  os_uint32 m_head;
+  nn_mtime_t m_tstall;
+  char m_name[32];
+}
+* ddsi_shm_conn_t;
+
+static struct ddsi_tran_factory ddsi_shm_factory_g;
+
+/* Looked up for every unicast datagram to a local address, so the
+   common case of a known peer only takes the lock for reading; adding
+   and revalidating entries requires it for writing. */
+static struct {
+  os_rwlock lock;
+  unsigned npeers;
+  struct ddsi_shm_peer peers[DDSI_SHM_MAX_PEERS];
+} ddsi_shm_peers_g;
+
+static os_uint32 ddsi_shm_pid;
+
+static void ddsi_shm_name (char *buf, size_t bufsz, os_uint32 port)
+{
+  snprintf (buf, bufsz, "/ospl-ddsi2-%s-%u", config.useIpv6 ? "u6" : "u4", (unsigned) port);
+}
+
+static int ddsi_shm_futex_wait (pa_uint32_t *addr, os_uint32 val, os_int64 timeout)
+{
+  struct timespec ts;
+  ts.tv_sec = (time_t) (timeout / T_SECOND);
+  ts.tv_nsec = (long) (timeout % T_SECOND);
+  return (int) syscall (SYS_futex, &addr->v, FUTEX_WAIT, val, &ts, NULL, 0);
+}
+
+static void ddsi_shm_futex_wake (pa_uint32_t *addr)
+{
+  (void) syscall (SYS_futex, &addr->v, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static struct ddsi_shm_slot *ddsi_shm_slot (const struct ddsi_shm_ring *r, os_uint32 pos)
+{
+  return (struct ddsi_shm_slot *) ((char *) r->hdr + sizeof (*r->hdr) + (os_size_t) (pos & r->mask) * r->stride);
+}
+
+static os_size_t ddsi_shm_ring_size (os_uint32 nslots, os_uint32 stride)
+{
+  return sizeof (struct ddsi_shm_hdr) + (os_size_t) nslots * stride;
+}
+
+/* PRODUCER SIDE */
+
+static os_ssize_t ddsi_shm_ring_put (const struct ddsi_shm_ring *r, const struct msghdr *msg, os_size_t len)
+{
+  struct ddsi_shm_hdr *h = r->hdr;
+  struct ddsi_shm_slot *s;
+  os_size_t i, off;
+  os_uint32 pos;
+
+  if (len > r->slotsize || pa_ld32 (&h->closed))
+    return -1;
+
+  pos = pa_ld32 (&h->tail);
+  for (;;)
+  {
+    os_int32 diff;
+    s = ddsi_shm_slot (r, pos);
+    diff = (os_int32) (pa_ld32 (&s->seq) - pos);
+    if (diff == 0 && pa_cas32 (&h->tail, pos, pos + 1))
+      break;
+    else if (diff < 0)
+      return -1; /* full: the consumer hasn't freed it yet */
+    pos = pa_ld32 (&h->tail);
+  }
+  pa_st32 (&s->pid, ddsi_shm_pid);
+
+  for (i = 0, off = 0; i < (os_size_t) msg->msg_iovlen; i++)
+  {
+    memcpy (s->data + off, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+    off += msg->msg_iov[i].iov_len;
+  }
+  assert (off == len);
+  s->len = (os_uint32) len;
+  pa_fence_rel ();
+  if (! pa_cas32 (&s->seq, pos, pos + 1))
+  {
+    /* The consumer gave up on this slot, can only happen if the pid
+       wasn't recorded for a very long time */
+    return -1;
+  }
+
+  pa_fence ();
+  if (pa_ld32 (&h->sleeping))
+  {
+    pa_inc32 (&h->wakeup);
+    ddsi_shm_futex_wake (&h->wakeup);
+  }
+  return (os_ssize_t) len;
+}
+
+static struct ddsi_shm_peer_ring *ddsi_shm_peer_attach (os_uint32 port)
+{
+  struct ddsi_shm_peer_ring *pr;
+  struct ddsi_shm_hdr *h;
+  struct stat st;
+  char name[32];
+  void *p;
+  int fd;
+
+  ddsi_shm_name (name, sizeof (name), port);
+  if ((fd = shm_open (name, O_RDWR, 0)) == -1)
+    return NULL;
+  if (fstat (fd, &st) == -1 || (os_size_t) st.st_size < sizeof (*h))
+  {
+    close (fd);
+    return NULL;
+  }
+  p = mmap (NULL, (os_size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (p == MAP_FAILED)
+    return NULL;
+
+  h = p;
+  if (h->magic != DDSI_SHM_MAGIC || h->version != DDSI_SHM_VERSION ||
+      h->nslots == 0 || h->nslots > DDSI_SHM_MAX_SLOTS || (h->nslots & (h->nslots - 1)) != 0 ||
+      h->stride < h->slotsize + DDSI_SHM_SLOTHDR_SIZE ||
+      ddsi_shm_ring_size (h->nslots, h->stride) > (os_size_t) st.st_size ||
+      pa_ld32 (&h->closed))
+  {
+    munmap (p, (os_size_t) st.st_size);
+    return NULL;
+  }
+  pa_fence_acq ();
+
+  pr = os_malloc (sizeof (*pr));
+  pa_st32 (&pr->refc, 1);
+  pr->ring.hdr = h;
+  pr->ring.size = (os_size_t) st.st_size;
+  pr->ring.mask = h->nslots - 1;
+  pr->ring.slotsize = h->slotsize;
+  pr->ring.stride = h->stride;
+  pr->dev = st.st_dev;
+  pr->ino = st.st_ino;
+  nn_log (LC_INFO, "ddsi_shm: attached to %s (%u slots of %u bytes)\n", name, h->nslots, h->slotsize);
+  return pr;
+}
+
+static void ddsi_shm_peer_unref (struct ddsi_shm_peer_ring *pr)
+{
+  if (pa_dec32_nv (&pr->refc) == 0)
+  {
+    munmap ((void *) pr->ring.hdr, pr->ring.size);
+    os_free (pr);
+  }
+}
+
+static int ddsi_shm_peer_valid (const struct ddsi_shm_peer_ring *pr, os_uint32 port)
+{
+  /* Still the ring currently registered under the name? The owner
+     unlinks it when it terminates, and a new owner of the port creates
+     a new one. */
+  struct stat st;
+  char name[32];
+  int fd, ok;
+  if (pa_ld32 (&pr->ring.hdr->closed))
+    return 0;
+  ddsi_shm_name (name, sizeof (name), port);
+  if ((fd = shm_open (name, O_RDONLY, 0)) == -1)
+    return 0;
+  ok = (fstat (fd, &st) == 0 && st.st_dev == pr->dev && st.st_ino == pr->ino);
+  close (fd);
+  return ok;
+}
+
+static struct ddsi_shm_peer_ring *ddsi_shm_peer_evict (void)
+{
+  /* Makes room in the full peer table (write lock held) by removing an
+     entry for a port without a ring, else one whose ring was closed,
+     else one that hasn't been written to since the previous scan.
+     Returns the ring reference held by the evicted entry, if any, for
+     the caller to drop once it has released the lock. */
+  struct ddsi_shm_peer_ring *pr;
+  unsigned i, victim = ddsi_shm_peers_g.npeers;
+  int prio = 0;
+  for (i = 0; i < ddsi_shm_peers_g.npeers && prio < 3; i++)
+  {
+    const struct ddsi_shm_peer *p = &ddsi_shm_peers_g.peers[i];
+    if (p->pr == NULL)
+    {
+      victim = i;
+      prio = 3;
+    }
+    else if (prio < 2 && pa_ld32 (&p->pr->ring.hdr->closed))
+    {
+      victim = i;
+      prio = 2;
+    }
+    else if (prio < 1 && ! pa_ld32 (&p->used))
+    {
+      victim = i;
+      prio = 1;
+    }
+  }
+  for (i = 0; i < ddsi_shm_peers_g.npeers; i++)
+    pa_st32 (&ddsi_shm_peers_g.peers[i].used, 0);
+  if (victim == ddsi_shm_peers_g.npeers)
+    return NULL;
+  pr = ddsi_shm_peers_g.peers[victim].pr;
+  ddsi_shm_peers_g.peers[victim] = ddsi_shm_peers_g.peers[--ddsi_shm_peers_g.npeers];
+  return pr;
+}
+
+static struct ddsi_shm_peer *ddsi_shm_peer_lookup (os_uint32 port)
+{
+  unsigned i;
+  for (i = 0; i < ddsi_shm_peers_g.npeers; i++)
+  {
+    if (ddsi_shm_peers_g.peers[i].port == port)
+      return &ddsi_shm_peers_g.peers[i];
+  }
+  return NULL;
+}
+
+static struct ddsi_shm_peer_ring *ddsi_shm_peer_ref (os_uint32 port)
+{
+  const nn_mtime_t tnow = now_mt ();
+  struct ddsi_shm_peer *p;
+  struct ddsi_shm_peer_ring *pr = NULL, *old = NULL, *evicted = NULL;
+
+  os_rwlockRead (&ddsi_shm_peers_g.lock);
+  if ((p = ddsi_shm_peer_lookup (port)) != NULL && tnow.v < p->tcheck.v)
+  {
+    if (! pa_ld32 (&p->used))
+      pa_st32 (&p->used, 1);
+    if ((pr = p->pr) != NULL)
+      pa_inc32 (&pr->refc);
+    os_rwlockUnlock (&ddsi_shm_peers_g.lock);
+    return pr;
+  }
+  os_rwlockUnlock (&ddsi_shm_peers_g.lock);
+
+  /* New port or due for revalidation */
+  os_rwlockWrite (&ddsi_shm_peers_g.lock);
+  if ((p = ddsi_shm_peer_lookup (port)) == NULL)
+  {
+    if (ddsi_shm_peers_g.npeers == DDSI_SHM_MAX_PEERS)
+      evicted = ddsi_shm_peer_evict ();
+    if (ddsi_shm_peers_g.npeers < DDSI_SHM_MAX_PEERS)
+    {
+      p = &ddsi_shm_peers_g.peers[ddsi_shm_peers_g.npeers++];
+      p->port = port;
+      p->pr = NULL;
+      p->tcheck.v = 0;
+    }
+  }
+  if (p != NULL)
+  {
+    if (tnow.v >= p->tcheck.v)
+    {
+      if (p->pr == NULL || ! ddsi_shm_peer_valid (p->pr, port))
+      {
+        old = p->pr;
+        p->pr = ddsi_shm_peer_attach (port);
+      }
+      p->tcheck = add_duration_to_mtime (tnow, DDSI_SHM_RECHECK_INTERVAL);
+    }
+    pa_st32 (&p->used, 1);
+    if ((pr = p->pr) != NULL)
+      pa_inc32 (&pr->refc);
+  }
+  os_rwlockUnlock (&ddsi_shm_peers_g.lock);
+
+  if (old)
+    ddsi_shm_peer_unref (old);
+  if (evicted)
+    ddsi_shm_peer_unref (evicted);
+  return pr;
+}
+
+static int ddsi_shm_is_local_address (const os_sockaddr_storage *addr)
+{
+  int i;
+  if (os_sockaddrIsLoopback ((const os_sockaddr *) addr))
+    return 1;
+  if (os_sockaddrIPAddressEqual ((const os_sockaddr *) addr, (const os_sockaddr *) &gv.ownip))
+    return 1;
+  for (i = 0; i < gv.n_interfaces; i++)
+  {
+    if (os_sockaddrIPAddressEqual ((const os_sockaddr *) addr, (const os_sockaddr *) &gv.interfaces[i].addr))
+      return 1;
+  }
+  return 0;
+}
+
+os_ssize_t ddsi_shm_write (const struct msghdr * msg, os_size_t len)
+{
+  const os_sockaddr_storage *dst = msg->msg_name;
+  struct ddsi_shm_peer_ring *pr;
+  os_ssize_t ret;
+
+  if (dst == NULL || ! ddsi_shm_is_local_address (dst))
+    return -1;
+  if ((pr = ddsi_shm_peer_ref (sockaddr_get_port (dst))) == NULL)
+    return -1;
+  ret = ddsi_shm_ring_put (&pr->ring, msg, len);
+  ddsi_shm_peer_unref (pr);
+
+  /* Datagrams for a co-located instance that end up going via UDP
+     anyway (ring full, too large) are counted as errors */
+  ddsi_factory_count_write (&ddsi_shm_factory_g, ret);
+  return ret;
+}
+
+/* CONSUMER SIDE */
+
+static int ddsi_shm_producer_dead (const struct ddsi_shm_slot *s, os_int64 stalled)
+{
+  /* A producer that is merely slow (descheduled, stopped) still copies
+     its data into the slot later on, by which time a producer on the
+     next lap could be using it, so a slot may only be skipped if its
+     producer no longer exists. If it died after claiming the slot but
+     before recording its pid, the owner is unknown and only a very
+     long stall is taken as evidence. */
+  const os_uint32 pid = pa_ld32 (&s->pid);
+  if (pid == 0)
+    return stalled >= DDSI_SHM_ORPHAN_TIMEOUT;
+  else
+    return kill ((pid_t) pid, 0) == -1 && errno == ESRCH;
+}
+
+static os_ssize_t ddsi_shm_conn_read (ddsi_tran_conn_t conn, unsigned char * buf, os_size_t len)
+{
+  ddsi_shm_conn_t sc = (ddsi_shm_conn_t) conn;
+  struct ddsi_shm_hdr *h = sc->m_ring.hdr;
+
+  while (gv.rtps_keepgoing)
+  {
+    struct ddsi_shm_slot *s = ddsi_shm_slot (&sc->m_ring, sc->m_head);
+    os_uint32 seq = pa_ld32 (&s->seq);
+
+    if (seq == sc->m_head + 1)
+    {
+      os_size_t n;
+      pa_fence_acq ();
+      n = s->len;
+      if (n > len)
+      {
+        NN_WARNING3 ("%s => %d truncated to %d\n", sc->m_name, (int) n, (int) len);
+        n = len;
+      }
+      memcpy (buf, s->data, n);
+      pa_st32 (&s->pid, 0);
+      pa_fence ();
+      pa_st32 (&s->seq, sc->m_head + sc->m_ring.mask + 1);
+      sc->m_head++;
+      sc->m_tstall.v = 0;
+      return (os_ssize_t) n;
+    }
+    else if (pa_ld32 (&h->tail) != sc->m_head)
+    {
+      /* Claimed but not yet published: normally a matter of a memcpy,
+         but if the producer died in between, it will never be */
+      nn_mtime_t tnow = now_mt ();
+      if (sc->m_tstall.v == 0)
+        sc->m_tstall = tnow;
+      else if (tnow.v - sc->m_tstall.v >= DDSI_SHM_STALL_TIMEOUT &&
+               ddsi_shm_producer_dead (s, tnow.v - sc->m_tstall.v))
+      {
+        pa_st32 (&s->pid, 0);
+        if (pa_cas32 (&s->seq, sc->m_head, sc->m_head + sc->m_ring.mask + 1))
+        {
+          NN_WARNING1 ("%s: skipping slot abandoned by producer\n", sc->m_name);
+          sc->m_head++;
+          sc->m_tstall.v = 0;
+          continue;
+        }
+      }
+    }
+
+    {
+      os_uint32 w = pa_ld32 (&h->wakeup);
+      pa_st32 (&h->sleeping, 1);
+      pa_fence ();
+      if (pa_ld32 (&s->seq) == seq && gv.rtps_keepgoing)
+      {
+        /* no need to check the result: spurious wakeups, timeouts and
+           EAGAIN all mean: look again */
+        (void) ddsi_shm_futex_wait (&h->wakeup, w, DDSI_SHM_WAIT_TIMEOUT);
+      }
+      pa_st32 (&h->sleeping, 0);
+    }
+  }
+  return -1;
+}
+
+static os_ssize_t ddsi_shm_conn_write (ddsi_tran_conn_t conn, const struct msghdr * msg, os_size_t len, os_uint32 flags)
+{
+  /* Outgoing traffic goes through ddsi_shm_write, never through a
+     connection of this factory */
+  (void) conn;
+  (void) msg;
+  (void) len;
+  (void) flags;
+  return -1;
+}
+
+static os_handle ddsi_shm_conn_handle (ddsi_tran_base_t base)
+{
+  (void) base;
+  return Q_INVALID_SOCKET;
+}
+
+static int ddsi_shm_conn_locator (ddsi_tran_base_t base, nn_locator_t *loc)
+{
+  /* The ring stands in for the unicast data socket */
+  (void) base;
+  return ddsi_conn_locator (gv.data_conn_uc, loc);
+}
+
+static c_bool ddsi_shm_supports (os_int32 kind)
+{
+  (void) kind;
+  return FALSE;
+}
+
+static ddsi_tran_conn_t ddsi_shm_create_conn (os_uint32 port, ddsi_tran_qos_t qos)
+{
+  ddsi_shm_conn_t sc;
+  struct ddsi_shm_hdr *h;
+  os_uint32 nslots, slotsize, stride, i;
+  os_size_t size;
+  char name[32];
+  void *p;
+  int fd;
+
+  (void) qos;
+
+  /* Slot size is limited by the receive buffer size, as it is used to
+     read datagrams (see do_packet) */
+  slotsize = config.shm_loopback_slotsize;
+  if (slotsize > config.rmsg_chunk_size)
+    slotsize = config.rmsg_chunk_size;
+  if (slotsize > 65536)
+    slotsize = 65536;
+  stride = (slotsize + DDSI_SHM_SLOTHDR_SIZE + DDSI_SHM_CACHELINE - 1) & ~(DDSI_SHM_CACHELINE - 1);
+  for (nslots = 2; nslots < config.shm_loopback_slots && nslots < DDSI_SHM_MAX_SLOTS; nslots *= 2)
+    ;
+  size = ddsi_shm_ring_size (nslots, stride);
+
+  /* A ring left behind by a previous owner of the port that didn't
+     get to clean up is of no use to anyone */
+  ddsi_shm_name (name, sizeof (name), port);
+  (void) shm_unlink (name);
+  if ((fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, 0600)) == -1)
+  {
+    NN_WARNING2 ("ddsi_shm: shm_open %s failed: errno %d\n", name, errno);
+    return NULL;
+  }
+  if (ftruncate (fd, (off_t) size) == -1 ||
+      (p = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+  {
+    NN_WARNING2 ("ddsi_shm: allocating %s failed: errno %d\n", name, errno);
+    close (fd);
+    shm_unlink (name);
+    return NULL;
+  }
+  close (fd);
+
+  sc = os_malloc (sizeof (*sc));
+  memset (sc, 0, sizeof (*sc));
+  h = p;
+  sc->m_ring.hdr = h;
+  sc->m_ring.size = size;
+  sc->m_ring.mask = nslots - 1;
+  sc->m_ring.slotsize = slotsize;
+  sc->m_ring.stride = stride;
+  strcpy (sc->m_name, name);
+
+  h->version = DDSI_SHM_VERSION;
+  h->nslots = nslots;
+  h->slotsize = slotsize;
+  h->stride = stride;
+  pa_st32 (&h->closed, 0);
+  pa_st32 (&h->tail, 0);
+  pa_st32 (&h->wakeup, 0);
+  pa_st32 (&h->sleeping, 0);
+  for (i = 0; i < nslots; i++)
+  {
+    pa_st32 (&ddsi_shm_slot (&sc->m_ring, i)->seq, i);
+    pa_st32 (&ddsi_shm_slot (&sc->m_ring, i)->pid, 0);
+  }
+  pa_fence ();
+  h->magic = DDSI_SHM_MAGIC;
+
+  ddsi_factory_conn_init (&ddsi_shm_factory_g, &sc->m_base);
+  sc->m_base.m_base.m_port = port;
+  sc->m_base.m_base.m_trantype = DDSI_TRAN_CONN;
+  sc->m_base.m_base.m_multicast = FALSE;
+  sc->m_base.m_base.m_handle_fn = ddsi_shm_conn_handle;
+  sc->m_base.m_base.m_locator_fn = ddsi_shm_conn_locator;
+  sc->m_base.m_read_fn = ddsi_shm_conn_read;
+  sc->m_base.m_write_fn = ddsi_shm_conn_write;
+
+  nn_log (LC_INFO | LC_CONFIG, "ddsi_shm_create_conn %s port %u: %u slots of %u bytes\n", name, (unsigned) port, nslots, slotsize);
+  return &sc->m_base;
+}
+
+static void ddsi_shm_close_conn (ddsi_tran_conn_t conn)
+{
+  /* Stop producers from adding more and make sure no-one attaches
+     to it anymore */
+  ddsi_shm_conn_t sc = (ddsi_shm_conn_t) conn;
+  pa_st32 (&sc->m_ring.hdr->closed, 1);
+  shm_unlink (sc->m_name);
+}
+
+static void ddsi_shm_release_conn (ddsi_tran_conn_t conn)
+{
+  ddsi_shm_conn_t sc = (ddsi_shm_conn_t) conn;
+  nn_log (LC_INFO, "ddsi_shm_release_conn %s\n", sc->m_name);
+  munmap ((void *) sc->m_ring.hdr, sc->m_ring.size);
+  os_free (sc);
+}
+
+int ddsi_shm_init (void)
+{
+  static c_bool init = FALSE;
+  gv.shm_conn = NULL;
+  if (! config.shm_loopback_enable || ! gv.m_factory->m_connless)
+    return 0;
+  if (! init)
+  {
+    init = TRUE;
+    memset (&ddsi_shm_factory_g, 0, sizeof (ddsi_shm_factory_g));
+    ddsi_shm_factory_g.m_kind = gv.m_factory->m_kind;
+    ddsi_shm_factory_g.m_typename = "shm";
+    ddsi_shm_factory_g.m_connless = TRUE;
+    ddsi_shm_factory_g.m_supports_fn = ddsi_shm_supports;
+    ddsi_shm_factory_g.m_create_conn_fn = ddsi_shm_create_conn;
+    ddsi_shm_factory_g.m_close_conn_fn = ddsi_shm_close_conn;
+    ddsi_shm_factory_g.m_release_conn_fn = ddsi_shm_release_conn;
+    ddsi_factory_add (&ddsi_shm_factory_g);
+    nn_log (LC_INFO | LC_CONFIG, "shm initialized\n");
+  }
+  os_rwlockInit (&ddsi_shm_peers_g.lock, NULL);
+  ddsi_shm_peers_g.npeers = 0;
+  ddsi_shm_pid = (os_uint32) getpid ();
+  gv.shm_conn = ddsi_factory_create_conn (&ddsi_shm_factory_g, ddsi_tran_port (gv.data_conn_uc), NULL);
+  if (gv.shm_conn == NULL)
+  {
+    os_rwlockDestroy (&ddsi_shm_peers_g.lock);
+    NN_WARNING0 ("ddsi_shm: shared-memory loopback disabled\n");
+  }
+  return 0;
+}
+
+void ddsi_shm_fini (void)
+{
+  unsigned i;
+  if (gv.shm_conn == NULL)
+    return;
+  for (i = 0; i < ddsi_shm_peers_g.npeers; i++)
+  {
+    if (ddsi_shm_peers_g.peers[i].pr)
+      ddsi_shm_peer_unref (ddsi_shm_peers_g.peers[i].pr);
+  }
+  ddsi_shm_peers_g.npeers = 0;
+  os_rwlockDestroy (&ddsi_shm_peers_g.lock);
+  ddsi_conn_free (gv.shm_conn);
+  gv.shm_conn = NULL;
+}
+
+void ddsi_shm_unblock (void)
+{
+  if (gv.shm_conn)
+  {
+    struct ddsi_shm_hdr *h = ((ddsi_shm_conn_t) gv.shm_conn)->m_ring.hdr;
+    pa_inc32 (&h->wakeup);
+    ddsi_shm_futex_wake (&h->wakeup);
+  }
+}
+
+#else /* SYSDEPS_HAVE_SHM_FUTEX */
+
+int ddsi_shm_init (void)
+{
+  gv.shm_conn = NULL;
+  if (config.shm_loopback_enable)
+    NN_WARNING0 ("ddsi_shm: shared-memory loopback not supported on this platform\n");
+  return 0;
+}
+
+void ddsi_shm_fini (void)
+{
+}
+
+void ddsi_shm_unblock (void)
+{
+}
+
+os_ssize_t ddsi_shm_write (const struct msghdr * msg, os_size_t len)
+{
+  (void) msg;
+  (void) len;
+  return -1;
+}
+
+#endif /* SYSDEPS_HAVE_SHM_FUTEX */
+
+/* SHA1 not available (unoffical build.) */
@@ -0,0 +1,46 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#ifndef _DDSI_SHM_H_
+#define _DDSI_SHM_H_
+
+/* Shared-memory loopback: unicast datagrams for another DDSI2 instance
+   on the same host are put in the receive ring that instance has
+   created in shared memory for its unicast data port, rather than
+   going through the UDP stack. It is an accelerator for the UDP
+   transport, not a transport in its own right: anything that can't be
+   passed through shared memory is simply sent using UDP. */
+
+#include "ddsi_tran.h"
+
+/* Creates the receive ring for gv.data_conn_uc and sets gv.shm_conn
+   when enabled and supported; returns 0 also when it is not. */
+int ddsi_shm_init (void);
+void ddsi_shm_fini (void);
+
+/* Wakes up the thread blocked in reading gv.shm_conn */
+void ddsi_shm_unblock (void);
+
+/* Returns len if the datagram was delivered via shared memory, -1 if
+   the caller must send it via UDP */
+os_ssize_t ddsi_shm_write (const struct msghdr * msg, os_size_t len);
+
+#endif
+
+/* SHA1 not available (unoffical build.) */
@@ -27,11 +27,28 @@
 #include "q_config.h"
 #include "q_log.h"
 #include "q_entity.h"
+#include "q_thread.h"
+#include "q_time.h"
 #include "os_atomics.h"
 #include "os_errno.h"
 
+#if SYSDEPS_HAVE_EPOLL
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
 #define INVALID_PORT (~0u)
 
+/* Size of the per-connection read buffer, which allows reading multiple
+   DDSI messages in a single system call */
+#define DDSI_TCP_RBUF_SIZE 65536u
+
+/* Maximum number of queued messages written in one system call by
+   the asynchronous write thread */
+#define DDSI_TCP_TX_MAX_IOV 64
+#define DDSI_TCP_TX_MAX_EVENTS 32
+
 typedef struct ddsi_tran_factory * ddsi_tcp_factory_g_t;
 
 #ifdef DDSI_INCLUDE_SSL
@@ -54,8 +71,22 @@ static struct ddsi_tran_conn ddsi_tcp_conn_client;
   is not removed from cache but simply flagged as failed (may be subsequently
   replaced). Similarly server side sockets are not closed as are also used in socket
   wait set that manages their lifecycle.
+
+  With asynchronous writes, whatever can't be written immediately is
+  appended to the connection's outbound queue (protected by the mutex)
+  and the connection is "armed": registered with the tcp.tx thread,
+  which holds a reference until the queue has been written out, the
+  connection fails or no progress is made for WriteTimeout.
 */
 
+struct ddsi_tcp_qelem
+{
+  struct ddsi_tcp_qelem * m_next;
+  os_size_t m_len;
+  os_size_t m_off; /* bytes already written */
+  unsigned char m_data[1]; /* actually m_len */
+};
+
 typedef struct ddsi_tcp_conn
 {
   struct ddsi_tran_conn m_base;
@@ -66,6 +97,15 @@ typedef struct ddsi_tcp_conn
 #ifdef DDSI_INCLUDE_SSL
   SSL * m_ssl;
 #endif
+  c_bool m_async;
+  c_bool m_xq_armed;
+  struct ddsi_tcp_qelem * m_xq_head;
+  struct ddsi_tcp_qelem * m_xq_tail;
+  os_size_t m_xq_bytes;
+  nn_mtime_t m_xq_tprogress;
+  unsigned char * m_rbuf;
+  os_size_t m_rbuf_pos;
+  os_size_t m_rbuf_len;
 }
 * ddsi_tcp_conn_t;
 
@@ -137,6 +177,28 @@ static os_mutex ddsi_tcp_cache_lock_g;
 static ut_avlTree_t ddsi_tcp_cache_g;
 static struct ddsi_tran_factory ddsi_tcp_factory_g;
 
+static struct ddsi_tcp_tx
+{
+  pa_uint32_t m_running;
+#if SYSDEPS_HAVE_EPOLL
+  int m_epfd;
+  int m_evfd;
+  struct thread_state1 * m_ts;
+  os_mutex m_lock; /* protects m_armed */
+  ddsi_tcp_conn_t * m_armed;
+  unsigned m_narmed;
+  unsigned m_armed_size;
+#endif
+  pa_uint32_t m_stat_direct;
+  pa_uint32_t m_stat_queued;
+  pa_uint32_t m_stat_dropped;
+  pa_uint32_t m_stat_writev;
+  pa_uint32_t m_stat_coalesced;
+  pa_uint32_t m_stat_timeouts;
+  pa_uint32_t m_stat_max_queued_bytes;
+}
+ddsi_tcp_tx_g;
+
 static ddsi_tcp_conn_t ddsi_tcp_new_conn (os_socket, c_bool, os_sockaddr_storage *);
 extern void ddsi_factory_conn_init (ddsi_tran_factory_t, ddsi_tran_conn_t);
 
@@ -336,6 +398,7 @@ static ddsi_tcp_conn_t ddsi_tcp_cache_find (const struct msghdr * msg)
   if (ret == NULL)
   {
     ret = ddsi_tcp_new_conn (Q_INVALID_SOCKET, FALSE, &key.m_peer_addr);
+    ret->m_async = TRUE;
     ddsi_tcp_cache_add (ret, &path);
   }
   os_mutexUnlock (&ddsi_tcp_cache_lock_g);
@@ -406,7 +469,46 @@ static os_ssize_t ddsi_tcp_conn_read (ddsi_tran_conn_t conn, unsigned char * buf
 
   while (TRUE)
   {
-    n = rd (tcp, (char *) buf + pos, len - pos, &err);
+    /* Serve from what was read ahead first */
+
+    if (tcp->m_rbuf_pos < tcp->m_rbuf_len)
+    {
+      os_size_t m = tcp->m_rbuf_len - tcp->m_rbuf_pos;
+      if (m > len - pos)
+      {
+        m = len - pos;
+      }
+      memcpy ((char *) buf + pos, tcp->m_rbuf + tcp->m_rbuf_pos, m);
+      tcp->m_rbuf_pos += m;
+      pos += m;
+      if (pos == len)
+      {
+        return (os_ssize_t) pos;
+      }
+    }
+
+    /* Small reads go through the read buffer, so that a single recv
+       typically picks up several messages; large ones go direct */
+
+    if (rd == ddsi_tcp_conn_read_plain && len - pos < DDSI_TCP_RBUF_SIZE)
+    {
+      if (tcp->m_rbuf == NULL)
+      {
+        tcp->m_rbuf = os_malloc (DDSI_TCP_RBUF_SIZE);
+      }
+      n = rd (tcp, tcp->m_rbuf, DDSI_TCP_RBUF_SIZE, &err);
+      if (n > 0)
+      {
+        tcp->m_rbuf_pos = 0;
+        tcp->m_rbuf_len = (os_size_t) n;
+        continue;
+      }
+    }
+    else
+    {
+      n = rd (tcp, (char *) buf + pos, len - pos, &err);
+    }
+
     if (n > 0)
     {
       pos += (os_size_t) n;
@@ -444,6 +546,12 @@ static os_ssize_t ddsi_tcp_conn_read (ddsi_tran_conn_t conn, unsigned char * buf
   return -1;
 }
 
+static c_bool ddsi_tcp_conn_buffered (ddsi_tran_conn_t conn)
+{
+  ddsi_tcp_conn_t tcp = (ddsi_tcp_conn_t) conn;
+  return tcp->m_rbuf_pos < tcp->m_rbuf_len;
+}
+
 static os_ssize_t ddsi_tcp_conn_write_plain (ddsi_tcp_conn_t conn, const void * buf, os_size_t len, int * err)
 {
   os_ssize_t ret;
@@ -510,6 +618,461 @@ static os_ssize_t ddsi_tcp_block_write
   return (pos == sz) ? (os_ssize_t) pos : -1;
 }
 
+#if SYSDEPS_HAVE_EPOLL
+
+static void ddsi_tcp_xq_discard (ddsi_tcp_conn_t conn)
+{
+  struct ddsi_tcp_qelem * e;
+  while ((e = conn->m_xq_head) != NULL)
+  {
+    conn->m_xq_head = e->m_next;
+    os_free (e);
+  }
+  conn->m_xq_tail = NULL;
+  conn->m_xq_bytes = 0;
+}
+
+static void ddsi_tcp_tx_arm (ddsi_tcp_conn_t conn)
+{
+  /* Called with conn->m_mutex held; reference is dropped by the tcp.tx
+     thread once it disarms the connection */
+  struct epoll_event ev;
+
+  ddsi_conn_add_ref (&conn->m_base);
+  conn->m_xq_armed = TRUE;
+  conn->m_xq_tprogress = now_mt ();
+
+  os_mutexLock (&ddsi_tcp_tx_g.m_lock);
+  if (ddsi_tcp_tx_g.m_narmed == ddsi_tcp_tx_g.m_armed_size)
+  {
+    ddsi_tcp_tx_g.m_armed_size = ddsi_tcp_tx_g.m_armed_size ? 2 * ddsi_tcp_tx_g.m_armed_size : 8;
+    ddsi_tcp_tx_g.m_armed = os_realloc (ddsi_tcp_tx_g.m_armed, ddsi_tcp_tx_g.m_armed_size * sizeof (*ddsi_tcp_tx_g.m_armed));
+  }
+  ddsi_tcp_tx_g.m_armed[ddsi_tcp_tx_g.m_narmed++] = conn;
+  os_mutexUnlock (&ddsi_tcp_tx_g.m_lock);
+
+  /* If this fails, the write timeout will take care of it */
+  memset (&ev, 0, sizeof (ev));
+  ev.events = EPOLLOUT | EPOLLONESHOT;
+  ev.data.ptr = conn;
+  if (epoll_ctl (ddsi_tcp_tx_g.m_epfd, EPOLL_CTL_ADD, conn->m_sock, &ev) == -1)
+  {
+    nn_log (LC_WARNING, "%s failed to register socket %d for writing, errno %d\n", ddsi_name, (int) conn->m_sock, os_getErrno ());
+  }
+}
+
+static void ddsi_tcp_tx_disarm (ddsi_tcp_conn_t conn)
+{
+  /* Called with conn->m_mutex held; caller must drop the reference
+     after unlocking */
+  struct epoll_event ev;
+  unsigned i;
+
+  memset (&ev, 0, sizeof (ev));
+  (void) epoll_ctl (ddsi_tcp_tx_g.m_epfd, EPOLL_CTL_DEL, conn->m_sock, &ev);
+  conn->m_xq_armed = FALSE;
+
+  os_mutexLock (&ddsi_tcp_tx_g.m_lock);
+  for (i = 0; i < ddsi_tcp_tx_g.m_narmed; i++)
+  {
+    if (ddsi_tcp_tx_g.m_armed[i] == conn)
+    {
+      ddsi_tcp_tx_g.m_armed[i] = ddsi_tcp_tx_g.m_armed[--ddsi_tcp_tx_g.m_narmed];
+      break;
+    }
+  }
+  os_mutexUnlock (&ddsi_tcp_tx_g.m_lock);
+}
+
+static os_ssize_t ddsi_tcp_conn_write_async (ddsi_tcp_conn_t conn, const struct msghdr * msg, os_size_t len, c_bool * failed)
+{
+  /* Called with conn->m_mutex held. Never blocks: writes directly if
+     nothing is queued yet, and queues whatever remains. Returns -1 both
+     when the message was dropped and when the connection failed, the
+     latter is signalled by setting *failed. */
+
+  struct ddsi_tcp_qelem * e;
+  os_size_t n = 0, skip, pos;
+  os_uint32 qmax;
+  int i;
+
+  *failed = FALSE;
+
+  if (conn->m_xq_head == NULL)
+  {
+    struct msghdr msgcopy = *msg;
+    int sendflags = 0;
+    os_ssize_t ret;
+    int err;
+#ifdef MSG_NOSIGNAL
+    sendflags |= MSG_NOSIGNAL;
+#endif
+    msgcopy.msg_name = NULL;
+    msgcopy.msg_namelen = 0;
+    do
+    {
+      ret = sendmsg (conn->m_sock, &msgcopy, sendflags);
+      err = (ret == -1) ? os_getErrno () : 0;
+    }
+    while ((ret == -1) && (err == os_sockEINTR));
+
+    if (ret == -1)
+    {
+      if (err != os_sockEAGAIN && err != os_sockEWOULDBLOCK)
+      {
+        TRACE_TCP (("%s write: sock %d error %d\n", ddsi_name, (int) conn->m_sock, err));
+        *failed = TRUE;
+        return -1;
+      }
+    }
+    else if ((os_size_t) ret == len)
+    {
+      pa_inc32 (&ddsi_tcp_tx_g.m_stat_direct);
+      return (os_ssize_t) len;
+    }
+    else
+    {
+      n = (os_size_t) ret;
+    }
+  }
+
+  /* A message of which nothing has been written yet can be dropped
+     without corrupting the stream, and must be if the queue is full.
+     It is reported as a failed write: only the reliable protocol will
+     recover it, exactly as for a datagram lost by the network. */
+
+  if (n == 0 && (conn->m_xq_bytes + len > config.tcp_write_queue_size || ! pa_ld32 (&ddsi_tcp_tx_g.m_running)))
+  {
+    TRACE_TCP (("%s write: sock %d queue full (%"PA_PRIuSIZE" bytes), message dropped\n", ddsi_name, (int) conn->m_sock, conn->m_xq_bytes));
+    pa_inc32 (&ddsi_tcp_tx_g.m_stat_dropped);
+    return -1;
+  }
+
+  e = os_malloc (offsetof (struct ddsi_tcp_qelem, m_data) + (len - n));
+  e->m_next = NULL;
+  e->m_len = len - n;
+  e->m_off = 0;
+  for (i = 0, pos = 0, skip = n; i < (int) msg->msg_iovlen; i++)
+  {
+    const char * base = msg->msg_iov[i].iov_base;
+    os_size_t sz = msg->msg_iov[i].iov_len;
+    if (skip >= sz)
+    {
+      skip -= sz;
+    }
+    else
+    {
+      memcpy (e->m_data + pos, base + skip, sz - skip);
+      pos += sz - skip;
+      skip = 0;
+    }
+  }
+  assert (pos == e->m_len);
+
+  if (conn->m_xq_tail)
+    conn->m_xq_tail->m_next = e;
+  else
+    conn->m_xq_head = e;
+  conn->m_xq_tail = e;
+  conn->m_xq_bytes += e->m_len;
+  pa_inc32 (&ddsi_tcp_tx_g.m_stat_queued);
+  do
+  {
+    qmax = pa_ld32 (&ddsi_tcp_tx_g.m_stat_max_queued_bytes);
+  }
+  while (conn->m_xq_bytes > qmax && ! pa_cas32 (&ddsi_tcp_tx_g.m_stat_max_queued_bytes, qmax, (os_uint32) conn->m_xq_bytes));
+
+  if (! conn->m_xq_armed && pa_ld32 (&ddsi_tcp_tx_g.m_running))
+  {
+    ddsi_tcp_tx_arm (conn);
+  }
+  return (os_ssize_t) len;
+}
+
+static void ddsi_tcp_tx_flush (ddsi_tcp_conn_t conn, const nn_mtime_t * tcheck)
+{
+  /* Writes as much of the queue as the socket accepts, coalescing
+     queued messages into a single sendmsg. If tcheck is set, only
+     checks whether the connection has made progress recently enough. */
+
+  struct iovec iov[DDSI_TCP_TX_MAX_IOV];
+  c_bool done = FALSE, failed = FALSE;
+  int sendflags = 0;
+#ifdef MSG_NOSIGNAL
+  sendflags |= MSG_NOSIGNAL;
+#endif
+
+  os_mutexLock (&conn->m_mutex);
+  if (! conn->m_xq_armed)
+  {
+    os_mutexUnlock (&conn->m_mutex);
+    return;
+  }
+
+  if (conn->m_base.m_closed || conn->m_sock == Q_INVALID_SOCKET)
+  {
+    done = TRUE;
+  }
+  else if (tcheck)
+  {
+    if (tcheck->v - conn->m_xq_tprogress.v < config.tcp_write_timeout)
+    {
+      os_mutexUnlock (&conn->m_mutex);
+      return;
+    }
+    nn_log
+    (
+      LC_WARNING, "%s abandoning write on blocking socket %d with %"PA_PRIuSIZE" bytes queued\n",
+      ddsi_name, (int) conn->m_sock, conn->m_xq_bytes
+    );
+    pa_inc32 (&ddsi_tcp_tx_g.m_stat_timeouts);
+    failed = TRUE;
+  }
+
+  while (! done && ! failed)
+  {
+    struct ddsi_tcp_qelem * e;
+    struct msghdr msg;
+    os_ssize_t ret;
+    int niov = 0;
+    int err;
+
+    for (e = conn->m_xq_head; e && niov < DDSI_TCP_TX_MAX_IOV; e = e->m_next)
+    {
+      iov[niov].iov_base = e->m_data + e->m_off;
+      iov[niov].iov_len = e->m_len - e->m_off;
+      niov++;
+    }
+    memset (&msg, 0, sizeof (msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = (os_size_t) niov;
+    do
+    {
+      ret = sendmsg (conn->m_sock, &msg, sendflags);
+      err = (ret == -1) ? os_getErrno () : 0;
+    }
+    while ((ret == -1) && (err == os_sockEINTR));
+
+    if (ret > 0)
+    {
+      os_size_t n = (os_size_t) ret;
+      pa_inc32 (&ddsi_tcp_tx_g.m_stat_writev);
+      conn->m_xq_tprogress = now_mt ();
+      conn->m_xq_bytes -= n;
+      while (n > 0)
+      {
+        e = conn->m_xq_head;
+        if (n >= e->m_len - e->m_off)
+        {
+          n -= e->m_len - e->m_off;
+          conn->m_xq_head = e->m_next;
+          os_free (e);
+          pa_inc32 (&ddsi_tcp_tx_g.m_stat_coalesced);
+        }
+        else
+        {
+          e->m_off += n;
+          n = 0;
+        }
+      }
+      if (conn->m_xq_head == NULL)
+      {
+        conn->m_xq_tail = NULL;
+        done = TRUE;
+      }
+    }
+    else if (ret == -1 && (err == os_sockEAGAIN || err == os_sockEWOULDBLOCK))
+    {
+      struct epoll_event ev;
+      memset (&ev, 0, sizeof (ev));
+      ev.events = EPOLLOUT | EPOLLONESHOT;
+      ev.data.ptr = conn;
+      (void) epoll_ctl (ddsi_tcp_tx_g.m_epfd, EPOLL_CTL_MOD, conn->m_sock, &ev);
+      break;
+    }
+    else
+    {
+      TRACE_TCP (("%s write: sock %d error %d\n", ddsi_name, (int) conn->m_sock, err));
+      failed = TRUE;
+    }
+  }
+
+  if (done || failed)
+  {
+    ddsi_tcp_xq_discard (conn);
+    ddsi_tcp_tx_disarm (conn);
+  }
+  os_mutexUnlock (&conn->m_mutex);
+
+  if (failed)
+  {
+    ddsi_tcp_cache_remove (conn);
+  }
+  if (done || failed)
+  {
+    ddsi_conn_remove_ref (&conn->m_base);
+  }
+}
+
+static void ddsi_tcp_tx_check_timeouts (void)
+{
+  const nn_mtime_t tnow = now_mt ();
+  ddsi_tcp_conn_t * conns;
+  unsigned i, n;
+
+  os_mutexLock (&ddsi_tcp_tx_g.m_lock);
+  n = ddsi_tcp_tx_g.m_narmed;
+  conns = os_malloc ((n ? n : 1) * sizeof (*conns));
+  for (i = 0; i < n; i++)
+  {
+    conns[i] = ddsi_tcp_tx_g.m_armed[i];
+    ddsi_conn_add_ref (&conns[i]->m_base);
+  }
+  os_mutexUnlock (&ddsi_tcp_tx_g.m_lock);
+
+  for (i = 0; i < n; i++)
+  {
+    ddsi_tcp_tx_flush (conns[i], &tnow);
+    ddsi_conn_remove_ref (&conns[i]->m_base);
+  }
+  os_free (conns);
+}
+
+static void * ddsi_tcp_tx_thread (void * varg)
+{
+  struct epoll_event evs[DDSI_TCP_TX_MAX_EVENTS];
+  nn_mtime_t tcheck = add_duration_to_mtime (now_mt (), T_SECOND);
+  ddsi_tcp_conn_t conn;
+
+  (void) varg;
+  while (pa_ld32 (&ddsi_tcp_tx_g.m_running))
+  {
+    int i, n = epoll_wait (ddsi_tcp_tx_g.m_epfd, evs, DDSI_TCP_TX_MAX_EVENTS, 1000);
+    for (i = 0; i < n; i++)
+    {
+      if (evs[i].data.ptr == NULL)
+      {
+        os_uint64 dummy;
+        (void) read (ddsi_tcp_tx_g.m_evfd, &dummy, sizeof (dummy));
+      }
+      else
+      {
+        ddsi_tcp_tx_flush (evs[i].data.ptr, NULL);
+      }
+    }
+    if (now_mt ().v >= tcheck.v)
+    {
+      ddsi_tcp_tx_check_timeouts ();
+      tcheck = add_duration_to_mtime (now_mt (), T_SECOND);
+    }
+  }
+
+  /* Whatever is still queued is lost */
+  os_mutexLock (&ddsi_tcp_tx_g.m_lock);
+  while (ddsi_tcp_tx_g.m_narmed > 0)
+  {
+    conn = ddsi_tcp_tx_g.m_armed[0];
+    os_mutexUnlock (&ddsi_tcp_tx_g.m_lock);
+    os_mutexLock (&conn->m_mutex);
+    ddsi_tcp_xq_discard (conn);
+    ddsi_tcp_tx_disarm (conn);
+    os_mutexUnlock (&conn->m_mutex);
+    ddsi_conn_remove_ref (&conn->m_base);
+    os_mutexLock (&ddsi_tcp_tx_g.m_lock);
+  }
+  os_mutexUnlock (&ddsi_tcp_tx_g.m_lock);
+  return NULL;
+}
+
+int ddsi_tcp_tx_start (void)
+{
+  struct epoll_event ev;
+
+  if (! config.tcp_async_write)
+  {
+    return 0;
+  }
+#ifdef DDSI_INCLUDE_SSL
+  if (ddsi_tcp_ssl_plugin.write)
+  {
+    NN_WARNING1 ("%s: asynchronous writes not supported with SSL\n", ddsi_name);
+    return 0;
+  }
+#endif
+  if ((ddsi_tcp_tx_g.m_epfd = epoll_create (DDSI_TCP_TX_MAX_EVENTS)) == -1)
+  {
+    NN_ERROR2 ("%s: epoll_create failed: errno %d\n", ddsi_name, os_getErrno ());
+    return -1;
+  }
+  if ((ddsi_tcp_tx_g.m_evfd = eventfd (0, 0)) == -1)
+  {
+    NN_ERROR2 ("%s: eventfd failed: errno %d\n", ddsi_name, os_getErrno ());
+    close (ddsi_tcp_tx_g.m_epfd);
+    return -1;
+  }
+  memset (&ev, 0, sizeof (ev));
+  ev.events = EPOLLIN;
+  ev.data.ptr = NULL;
+  (void) epoll_ctl (ddsi_tcp_tx_g.m_epfd, EPOLL_CTL_ADD, ddsi_tcp_tx_g.m_evfd, &ev);
+
+  os_mutexInit (&ddsi_tcp_tx_g.m_lock, NULL);
+  ddsi_tcp_tx_g.m_armed = NULL;
+  ddsi_tcp_tx_g.m_narmed = 0;
+  ddsi_tcp_tx_g.m_armed_size = 0;
+  pa_st32 (&ddsi_tcp_tx_g.m_running, 1);
+  ddsi_tcp_tx_g.m_ts = create_thread ("tcp.tx", ddsi_tcp_tx_thread, NULL);
+
+  nn_log (LC_CONFIG, "%s asynchronous writes, at most %u bytes queued per connection\n", ddsi_name, config.tcp_write_queue_size);
+  return 0;
+}
+
+void ddsi_tcp_tx_stop (void)
+{
+  const os_uint64 one = 1;
+
+  if (! pa_ld32 (&ddsi_tcp_tx_g.m_running))
+  {
+    return;
+  }
+  pa_st32 (&ddsi_tcp_tx_g.m_running, 0);
+  (void) write (ddsi_tcp_tx_g.m_evfd, &one, sizeof (one));
+  join_thread (ddsi_tcp_tx_g.m_ts, NULL);
+
+  close (ddsi_tcp_tx_g.m_evfd);
+  close (ddsi_tcp_tx_g.m_epfd);
+  os_free (ddsi_tcp_tx_g.m_armed);
+  os_mutexDestroy (&ddsi_tcp_tx_g.m_lock);
+}
+
+#else /* SYSDEPS_HAVE_EPOLL */
+
+int ddsi_tcp_tx_start (void)
+{
+  if (config.tcp_async_write)
+  {
+    NN_WARNING1 ("%s: asynchronous writes not supported on this platform\n", ddsi_name);
+  }
+  return 0;
+}
+
+void ddsi_tcp_tx_stop (void)
+{
+}
+
+#endif /* SYSDEPS_HAVE_EPOLL */
+
+c_bool ddsi_tcp_getstats (struct ddsi_tcp_stats *st)
+{
+  st->n_direct = pa_ld32 (&ddsi_tcp_tx_g.m_stat_direct);
+  st->n_queued = pa_ld32 (&ddsi_tcp_tx_g.m_stat_queued);
+  st->n_dropped = pa_ld32 (&ddsi_tcp_tx_g.m_stat_dropped);
+  st->n_writev = pa_ld32 (&ddsi_tcp_tx_g.m_stat_writev);
+  st->n_coalesced = pa_ld32 (&ddsi_tcp_tx_g.m_stat_coalesced);
+  st->n_timeouts = pa_ld32 (&ddsi_tcp_tx_g.m_stat_timeouts);
+  st->max_queued_bytes = pa_ld32 (&ddsi_tcp_tx_g.m_stat_max_queued_bytes);
+  return pa_ld32 (&ddsi_tcp_tx_g.m_running) ? TRUE : FALSE;
+}
+
 static os_ssize_t ddsi_tcp_conn_write (ddsi_tran_conn_t base, const struct msghdr * msg, os_size_t len, os_uint32 flags)
 {
 #ifdef DDSI_INCLUDE_SSL
@@ -554,6 +1117,22 @@ static os_ssize_t ddsi_tcp_conn_write (ddsi_tran_conn_t base, const struct msghd
     return (os_ssize_t) len;
   }
 
+#if SYSDEPS_HAVE_EPOLL
+  /* Once anything is queued, everything must be to preserve ordering */
+
+  if (conn->m_async && (conn->m_xq_head || pa_ld32 (&ddsi_tcp_tx_g.m_running)))
+  {
+    c_bool failed;
+    ret = ddsi_tcp_conn_write_async (conn, msg, len, &failed);
+    os_mutexUnlock (&conn->m_mutex);
+    if (failed)
+    {
+      ddsi_tcp_cache_remove (conn);
+    }
+    return ret;
+  }
+#endif
+
 #ifdef DDSI_INCLUDE_SSL
   if (config.ssl_enable)
   {
@@ -777,6 +1356,10 @@ static ddsi_tran_conn_t ddsi_tcp_accept (ddsi_tran_listener_t listener)
     tcp->m_ssl = ssl;
 #endif
     tcp->m_base.m_listener = listener;
+
+    /* Only DDSI connections write asynchronously, not those of the
+       debug monitor, which are closed as soon as written to */
+    tcp->m_async = (listener == gv.listener);
     tcp->m_base.m_conn = listener->m_connections;
     listener->m_connections = &tcp->m_base;
 
@@ -836,6 +1419,7 @@ static ddsi_tcp_conn_t ddsi_tcp_new_conn (os_socket sock, c_bool server, os_sock
   conn->m_peer_port = sockaddr_get_port (peer);
   conn->m_base.m_server = server;
   conn->m_base.m_base.m_port = INVALID_PORT;
+  conn->m_base.m_buffered_fn = ddsi_tcp_conn_buffered;
   ddsi_tcp_conn_set_socket (conn, sock);
 
   return conn;
@@ -900,6 +1484,13 @@ static void ddsi_tcp_conn_delete (ddsi_tcp_conn_t conn)
   {
     ddsi_tcp_sock_free (conn->m_sock, "connection");
   }
+  while (conn->m_xq_head)
+  {
+    struct ddsi_tcp_qelem * e = conn->m_xq_head;
+    conn->m_xq_head = e->m_next;
+    os_free (e);
+  }
+  os_free (conn->m_rbuf);
   os_mutexDestroy (&conn->m_mutex);
   os_free (conn);
 }
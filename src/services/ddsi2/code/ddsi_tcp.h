@@ -44,8 +44,27 @@ struct ddsi_ssl_plugins ddsi_tcp_ssl_plugin;
 
 #endif
 
+/* Statistics of asynchronous writes (TCP/AsyncWrite), all counts are
+   since startup */
+struct ddsi_tcp_stats
+{
+  os_uint32 n_direct;       /* messages written without queueing */
+  os_uint32 n_queued;       /* messages (partially) queued */
+  os_uint32 n_dropped;      /* messages dropped because the queue was full */
+  os_uint32 n_writev;       /* system calls writing queued data */
+  os_uint32 n_coalesced;    /* queued messages completed by those */
+  os_uint32 n_timeouts;     /* connections closed for lack of progress */
+  os_uint32 max_queued_bytes;
+};
+
 int ddsi_tcp_init (void);
 
+/* Start/stop the thread performing asynchronous writes, writes are
+   synchronous when it is not running */
+int ddsi_tcp_tx_start (void);
+void ddsi_tcp_tx_stop (void);
+c_bool ddsi_tcp_getstats (struct ddsi_tcp_stats *st);
+
 #endif
 
 /* SHA1 not available (unoffical build.) */
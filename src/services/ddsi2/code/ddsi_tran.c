@@ -20,13 +20,17 @@
 #include "os_heap.h"
 #include "os_atomics.h"
 #include "ddsi_tran.h"
+#include "ddsi_shm.h"
 #include "q_config.h"
 #include "q_log.h"
+#include "q_thread.h"
 
 static ddsi_tran_factory_t ddsi_tran_factories = NULL;
 
 void ddsi_factory_add (ddsi_tran_factory_t factory)
 {
+  int idx = ddsi_tran_factories ? ddsi_tran_factories->m_stat_idx + 1 : 0;
+  factory->m_stat_idx = (idx >= 0 && idx < THREAD_TRAN_STATS_MAX) ? idx : -1;
   factory->m_factory = ddsi_tran_factories;
   ddsi_tran_factories = factory;
 }
@@ -47,6 +51,89 @@ ddsi_tran_factory_t ddsi_factory_find (const char * type)
   return factory;
 }
 
+ddsi_tran_factory_t ddsi_factory_first (void)
+{
+  /* Others follow via m_factory */
+  return ddsi_tran_factories;
+}
+
+static struct thread_tran_stats *ddsi_factory_stats_self (ddsi_tran_factory_t factory)
+{
+  struct thread_state1 *self;
+  if (factory->m_stat_idx < 0 || (self = lookup_thread_state ()) == NULL)
+    return NULL;
+  return &self->tran_stats[factory->m_stat_idx];
+}
+
+void ddsi_factory_count_read (ddsi_tran_factory_t factory, os_ssize_t ret)
+{
+  struct thread_tran_stats *st;
+  if (ret <= 0)
+    return;
+  if ((st = ddsi_factory_stats_self (factory)) != NULL)
+  {
+    st->packets_in++;
+    st->bytes_in += (os_uint64) ret;
+  }
+  else
+  {
+    pa_inc32 (&factory->m_stat_packets_in);
+    pa_add32 (&factory->m_stat_bytes_in, (os_uint32) ret);
+  }
+}
+
+void ddsi_factory_count_write (ddsi_tran_factory_t factory, os_ssize_t ret)
+{
+  struct thread_tran_stats *st;
+  if ((st = ddsi_factory_stats_self (factory)) != NULL)
+  {
+    if (ret > 0)
+    {
+      st->packets_out++;
+      st->bytes_out += (os_uint64) ret;
+    }
+    else
+    {
+      st->errors_out++;
+    }
+  }
+  else if (ret > 0)
+  {
+    pa_inc32 (&factory->m_stat_packets_out);
+    pa_add32 (&factory->m_stat_bytes_out, (os_uint32) ret);
+  }
+  else
+  {
+    pa_inc32 (&factory->m_stat_errors_out);
+  }
+}
+
+void ddsi_factory_getstats (ddsi_tran_factory_t factory, struct thread_tran_stats *st)
+{
+  /* The per-thread counters are read without synchronisation, so the
+     result is not an exact snapshot; slots of threads that have
+     terminated keep their counts and are included */
+  unsigned i;
+  st->packets_in = pa_ld32 (&factory->m_stat_packets_in);
+  st->bytes_in = pa_ld32 (&factory->m_stat_bytes_in);
+  st->packets_out = pa_ld32 (&factory->m_stat_packets_out);
+  st->bytes_out = pa_ld32 (&factory->m_stat_bytes_out);
+  st->errors_out = pa_ld32 (&factory->m_stat_errors_out);
+  if (factory->m_stat_idx < 0)
+    return;
+  os_mutexLock (&thread_states.lock);
+  for (i = 0; i < thread_states.nthreads; i++)
+  {
+    const struct thread_tran_stats *ts = &thread_states.ts[i].tran_stats[factory->m_stat_idx];
+    st->packets_in += ts->packets_in;
+    st->bytes_in += ts->bytes_in;
+    st->packets_out += ts->packets_out;
+    st->bytes_out += ts->bytes_out;
+    st->errors_out += ts->errors_out;
+  }
+  os_mutexUnlock (&thread_states.lock);
+}
+
 void ddsi_factory_free (ddsi_tran_factory_t factory)
 {
   if (factory && factory->m_free_fn)
@@ -79,6 +166,16 @@ void ddsi_conn_add_ref (ddsi_tran_conn_t conn)
   pa_inc32 (&conn->m_count);
 }
 
+void ddsi_conn_remove_ref (ddsi_tran_conn_t conn)
+{
+  /* Drops a reference without closing the connection, unlike
+     ddsi_conn_free */
+  if (pa_dec32_nv (&conn->m_count) == 0)
+  {
+    (conn->m_factory->m_release_conn_fn) (conn);
+  }
+}
+
 extern void ddsi_factory_conn_init (ddsi_tran_factory_t factory, ddsi_tran_conn_t conn)
 {
   pa_st32 (&conn->m_count, 1);
@@ -89,7 +186,9 @@ extern void ddsi_factory_conn_init (ddsi_tran_factory_t factory, ddsi_tran_conn_
 
 os_ssize_t ddsi_conn_read (ddsi_tran_conn_t conn, unsigned char * buf, os_size_t len)
 {
-  return (conn->m_closed) ? -1 : (conn->m_read_fn) (conn, buf, len);
+  os_ssize_t ret = (conn->m_closed) ? -1 : (conn->m_read_fn) (conn, buf, len);
+  ddsi_factory_count_read (conn->m_factory, ret);
+  return ret;
 }
 
 os_ssize_t ddsi_conn_write (ddsi_tran_conn_t conn, const struct msghdr * msg, os_size_t len, os_uint32 flags)
@@ -97,8 +196,15 @@ os_ssize_t ddsi_conn_write (ddsi_tran_conn_t conn, const struct msghdr * msg, os
   os_ssize_t ret = -1;
   if (! conn->m_closed)
   {
+    /* Datagrams for co-located DDSI2 instances bypass the network stack
+       if possible, ddsi_shm_write maintains the statistics for those */
+    if (gv.shm_conn && conn->m_connless && (ret = ddsi_shm_write (msg, len)) > 0)
+    {
+      return ret;
+    }
     ret = (conn->m_write_fn) (conn, msg, len, flags);
   }
+  ddsi_factory_count_write (conn->m_factory, ret);
 
   /* Check that write function is atomic (all or nothing) */
 
@@ -106,6 +212,13 @@ os_ssize_t ddsi_conn_write (ddsi_tran_conn_t conn, const struct msghdr * msg, os
   return ret;
 }
 
+c_bool ddsi_conn_buffered (ddsi_tran_conn_t conn)
+{
+  /* Whether data has been read from the socket but not yet returned by
+     ddsi_conn_read, so the socket waitset won't signal it */
+  return conn->m_buffered_fn ? (conn->m_buffered_fn) (conn) : FALSE;
+}
+
 c_bool ddsi_conn_peer_locator (ddsi_tran_conn_t conn, nn_locator_t * loc)
 {
   if (conn->m_peer_locator_fn)
@@ -58,6 +58,7 @@ typedef os_handle (*ddsi_tran_handle_fn_t) (ddsi_tran_base_t);
 typedef int (*ddsi_tran_listen_fn_t) (ddsi_tran_listener_t);
 typedef void (*ddsi_tran_free_fn_t) (void);
 typedef void (*ddsi_tran_peer_locator_fn_t) (ddsi_tran_conn_t, nn_locator_t *);
+typedef c_bool (*ddsi_tran_buffered_fn_t) (ddsi_tran_conn_t);
 typedef ddsi_tran_conn_t (*ddsi_tran_accept_fn_t) (ddsi_tran_listener_t);
 typedef ddsi_tran_conn_t (*ddsi_tran_create_conn_fn_t) (os_uint32 , ddsi_tran_qos_t);
 typedef ddsi_tran_listener_t (*ddsi_tran_create_listener_fn_t) (int port, ddsi_tran_qos_t);
@@ -93,6 +94,7 @@ struct ddsi_tran_conn
   ddsi_tran_read_fn_t m_read_fn;
   ddsi_tran_write_fn_t m_write_fn;
   ddsi_tran_peer_locator_fn_t m_peer_locator_fn;
+  ddsi_tran_buffered_fn_t m_buffered_fn;
 
   /* Data */
 
@@ -147,6 +149,19 @@ struct ddsi_tran_factory
   c_bool m_connless;
   c_bool m_stream;
 
+  /* Statistics, maintained by ddsi_conn_read/write in the per-thread
+     thread_tran_stats slot m_stat_idx (-1 if there are too many
+     factories); the atomic counters below are only used by threads not
+     known to DDSI2 and are 32-bit, so their byte counts wrap around at
+     4GB. ddsi_factory_getstats combines them. */
+
+  int m_stat_idx;
+  pa_uint32_t m_stat_packets_in;
+  pa_uint32_t m_stat_bytes_in;
+  pa_uint32_t m_stat_packets_out;
+  pa_uint32_t m_stat_bytes_out;
+  pa_uint32_t m_stat_errors_out;
+
   /* Relationships */
 
   ddsi_tran_factory_t m_factory;
@@ -179,9 +194,15 @@ ddsi_tran_conn_t ddsi_factory_create_conn
   os_uint32 port,
   ddsi_tran_qos_t qos
 );
+struct thread_tran_stats;
+
 void ddsi_factory_add (ddsi_tran_factory_t factory);
 void ddsi_factory_free (ddsi_tran_factory_t factory);
 ddsi_tran_factory_t ddsi_factory_find (const char * type);
+ddsi_tran_factory_t ddsi_factory_first (void);
+void ddsi_factory_count_read (ddsi_tran_factory_t factory, os_ssize_t ret);
+void ddsi_factory_count_write (ddsi_tran_factory_t factory, os_ssize_t ret);
+void ddsi_factory_getstats (ddsi_tran_factory_t factory, struct thread_tran_stats *st);
 void ddsi_factory_conn_init (ddsi_tran_factory_t factory, ddsi_tran_conn_t conn);
 
 #define ddsi_conn_handle(c) (ddsi_tran_handle (&(c)->m_base))
@@ -189,7 +210,9 @@ void ddsi_factory_conn_init (ddsi_tran_factory_t factory, ddsi_tran_conn_t conn)
 OS_API os_ssize_t ddsi_conn_write (ddsi_tran_conn_t conn, const struct msghdr * msg, os_size_t len, os_uint32 flags);
 os_ssize_t ddsi_conn_read (ddsi_tran_conn_t conn, unsigned char * buf, os_size_t len);
 c_bool ddsi_conn_peer_locator (ddsi_tran_conn_t conn, nn_locator_t * loc);
+c_bool ddsi_conn_buffered (ddsi_tran_conn_t conn);
 void ddsi_conn_add_ref (ddsi_tran_conn_t conn);
+void ddsi_conn_remove_ref (ddsi_tran_conn_t conn);
 void ddsi_conn_free (ddsi_tran_conn_t conn);
 
 int ddsi_conn_join_mc (ddsi_tran_conn_t conn, const nn_locator_t *srcip, const nn_locator_t *mcip);
@@ -34,6 +34,10 @@ extern "C" {
 int nn_bitset_isset (unsigned numbits, const unsigned *bits, unsigned idx);
 void nn_bitset_set (unsigned numbits, unsigned *bits, unsigned idx);
 void nn_bitset_clear (unsigned numbits, unsigned *bits, unsigned idx);
+void nn_bitset_set_range (unsigned numbits, unsigned *bits, unsigned lo, unsigned hi);
+unsigned nn_bitset_first_in_word (unsigned w);
+unsigned nn_bitset_find_set (unsigned numbits, const unsigned *bits, unsigned idx);
+unsigned nn_bitset_find_clear (unsigned numbits, const unsigned *bits, unsigned idx);
 void nn_bitset_zero (unsigned numbits, unsigned *bits);
 void nn_bitset_one (unsigned numbits, unsigned *bits);
 #if defined (__cplusplus)
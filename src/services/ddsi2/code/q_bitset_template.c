@@ -43,6 +43,81 @@ NN_C99_INLINE void nn_bitset_clear (UNUSED_ARG_NDEBUG (unsigned numbits), unsign
   bits[idx/32] &= ~(1u << (31 - (idx%32)));
 }
 
+NN_C99_INLINE void nn_bitset_set_range (UNUSED_ARG_NDEBUG (unsigned numbits), unsigned *bits, unsigned lo, unsigned hi)
+{
+  /* sets bits [lo,hi), a word at a time */
+  const unsigned klo = lo / 32, khi = hi / 32;
+  assert (lo <= hi && hi <= numbits);
+  if (lo == hi)
+    return;
+  if (klo == khi)
+    bits[klo] |= (~0u >> (lo % 32)) & ~(~0u >> (hi % 32));
+  else
+  {
+    unsigned k;
+    bits[klo] |= ~0u >> (lo % 32);
+    for (k = klo + 1; k < khi; k++)
+      bits[k] = ~0u;
+    if (hi % 32)
+      bits[khi] |= ~(~0u >> (hi % 32));
+  }
+}
+
+NN_C99_INLINE unsigned nn_bitset_first_in_word (unsigned w)
+{
+  /* index (counting from the most significant bit, as in the DDSI
+     bitmaps) of the first bit set in w != 0 */
+#if defined __GNUC__
+  return (unsigned) __builtin_clz (w);
+#else
+  unsigned n = 0;
+  if (!(w & 0xffff0000u)) { n += 16; w <<= 16; }
+  if (!(w & 0xff000000u)) { n += 8; w <<= 8; }
+  if (!(w & 0xf0000000u)) { n += 4; w <<= 4; }
+  if (!(w & 0xc0000000u)) { n += 2; w <<= 2; }
+  if (!(w & 0x80000000u)) { n += 1; }
+  return n;
+#endif
+}
+
+NN_C99_INLINE unsigned nn_bitset_find_set (unsigned numbits, const unsigned *bits, unsigned idx)
+{
+  /* smallest i in [idx,numbits) with bit i set, numbits if none; bits
+     beyond numbits in the last word are ignored, they need not be 0
+     in a received bitmap */
+  const unsigned nwords = (numbits + 31) / 32;
+  unsigned k = idx / 32, w;
+  if (idx >= numbits)
+    return numbits;
+  w = bits[k] & (~0u >> (idx % 32));
+  while (w == 0)
+  {
+    if (++k == nwords)
+      return numbits;
+    w = bits[k];
+  }
+  idx = 32 * k + nn_bitset_first_in_word (w);
+  return (idx < numbits) ? idx : numbits;
+}
+
+NN_C99_INLINE unsigned nn_bitset_find_clear (unsigned numbits, const unsigned *bits, unsigned idx)
+{
+  /* smallest i in [idx,numbits) with bit i clear, numbits if none */
+  const unsigned nwords = (numbits + 31) / 32;
+  unsigned k = idx / 32, w;
+  if (idx >= numbits)
+    return numbits;
+  w = ~bits[k] & (~0u >> (idx % 32));
+  while (w == 0)
+  {
+    if (++k == nwords)
+      return numbits;
+    w = ~bits[k];
+  }
+  idx = 32 * k + nn_bitset_first_in_word (w);
+  return (idx < numbits) ? idx : numbits;
+}
+
 NN_C99_INLINE void nn_bitset_zero (unsigned numbits, unsigned *bits)
 {
   memset (bits, 0, 4 * ((numbits + 31) / 32));
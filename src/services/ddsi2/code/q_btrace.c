@@ -0,0 +1,262 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "os_heap.h"
+#include "os_mutex.h"
+#include "os_cond.h"
+#include "os_atomics.h"
+#include "os_stdlib.h"
+
+#include "q_log.h"
+#include "q_time.h"
+#include "q_config.h"
+#include "q_globals.h"
+#include "q_thread.h"
+#include "q_error.h"
+#include "q_btrace.h"
+#include "sysdeps.h"
+
+#define BTRACE_FLUSH_INTERVAL (100 * OS_DURATION_MILLISECOND)
+#define BTRACE_MIN_RECORDS 64u
+
+/* Single-producer (the thread owning the slot), single-consumer (the
+   btrace thread) ring; the indices run freely and are reduced modulo
+   the (power-of-two) size when accessing the records. */
+struct nn_btrace_ring {
+  pa_uint32_t wridx;
+  pa_uint32_t rdidx;
+  pa_uint32_t ndropped;
+  os_uint32 ndropped_reported; /* btrace thread only */
+  os_uint32 mask;
+  struct nn_btrace_record *recs;
+};
+
+struct nn_btrace {
+  FILE *fp;
+  unsigned nrings;
+  struct nn_btrace_ring *rings; /* one per thread slot */
+  os_mutex io_lock; /* serialises consuming rings and writing to fp */
+  os_mutex lock;
+  os_cond cond;
+  int stop;
+  struct thread_state1 *ts;
+};
+
+void nn_btrace (enum nn_btrace_event ev, const nn_guid_t *guid, os_int64 seq, os_uint32 arg)
+{
+  struct thread_state1 *self = lookup_thread_state ();
+  struct nn_btrace_ring *r;
+  struct nn_btrace_record *rec;
+  os_uint32 wr;
+  if (self == NULL || (r = self->btr) == NULL)
+    return;
+  wr = pa_ld32 (&r->wridx);
+  if (wr - pa_ld32 (&r->rdidx) > r->mask)
+  {
+    pa_inc32 (&r->ndropped);
+    return;
+  }
+  /* btrace thread must be done with this record before we overwrite it */
+  pa_fence_acq ();
+  rec = &r->recs[wr & r->mask];
+  rec->tstamp = now ().v;
+  rec->seq = seq;
+  rec->guid = *guid;
+  rec->event = (os_uint32) ev;
+  rec->arg = arg;
+  pa_fence_rel ();
+  pa_st32 (&r->wridx, wr + 1);
+}
+
+static int btrace_write_ring (struct nn_btrace *bt, unsigned slot)
+{
+  struct nn_btrace_ring * const r = &bt->rings[slot];
+  struct nn_btrace_chunk_header hdr;
+  os_uint32 rd, wr, nd, start;
+  size_t n1, n;
+
+  rd = pa_ld32 (&r->rdidx);
+  wr = pa_ld32 (&r->wridx);
+  nd = pa_ld32 (&r->ndropped);
+  if (rd == wr && nd == r->ndropped_reported)
+    return 0;
+  pa_fence_acq ();
+
+  memset (&hdr, 0, sizeof (hdr));
+  hdr.slot = slot;
+  hdr.nrecords = wr - rd;
+  hdr.ndropped = nd - r->ndropped_reported;
+  r->ndropped_reported = nd;
+  /* the name is freed and cleared with the lock held when the thread
+     is reaped, after its ring has been written out */
+  os_mutexLock (&thread_states.lock);
+  if (thread_states.ts[slot].state != THREAD_STATE_ZERO && thread_states.ts[slot].name)
+    os_strncpy (hdr.tname, thread_states.ts[slot].name, sizeof (hdr.tname) - 1);
+  os_mutexUnlock (&thread_states.lock);
+
+  n = hdr.nrecords;
+  start = rd & r->mask;
+  n1 = (start + n > r->mask + 1) ? r->mask + 1 - start : n;
+  fwrite (&hdr, sizeof (hdr), 1, bt->fp);
+  fwrite (&r->recs[start], sizeof (*r->recs), n1, bt->fp);
+  if (n1 < n)
+    fwrite (&r->recs[0], sizeof (*r->recs), n - n1, bt->fp);
+
+  /* all reads of the records must complete before releasing them */
+  pa_fence ();
+  pa_st32 (&r->rdidx, wr);
+  return 1;
+}
+
+static void btrace_flush (struct nn_btrace *bt)
+{
+  unsigned i;
+  int any = 0;
+  os_mutexLock (&bt->io_lock);
+  for (i = 0; i < bt->nrings; i++)
+    any |= btrace_write_ring (bt, i);
+  if (any)
+    fflush (bt->fp);
+  os_mutexUnlock (&bt->io_lock);
+}
+
+void nn_btrace_thread_exit (const struct thread_state1 *ts1)
+{
+  /* Writes out what remains in the ring of a thread that has stopped,
+     while the slot still carries its name, so that none of its records
+     get attributed to the next thread to use the slot */
+  struct nn_btrace *bt = gv.btrace;
+  if (bt == NULL)
+    return;
+  os_mutexLock (&bt->io_lock);
+  if (btrace_write_ring (bt, (unsigned) (ts1 - thread_states.ts)))
+    fflush (bt->fp);
+  os_mutexUnlock (&bt->io_lock);
+}
+
+static void *btrace_thread (struct nn_btrace *bt)
+{
+  os_mutexLock (&bt->lock);
+  while (!bt->stop)
+  {
+    os_condTimedWait (&bt->cond, &bt->lock, BTRACE_FLUSH_INTERVAL);
+    os_mutexUnlock (&bt->lock);
+    btrace_flush (bt);
+    os_mutexLock (&bt->lock);
+  }
+  os_mutexUnlock (&bt->lock);
+  btrace_flush (bt);
+  return NULL;
+}
+
+int nn_btrace_init (void)
+{
+  struct nn_btrace *bt;
+  struct nn_btrace_file_header fhdr;
+  os_uint32 nrecs;
+  unsigned i;
+
+  gv.btrace_enabled = 0;
+  gv.btrace = NULL;
+  if (config.btrace_file == NULL || *config.btrace_file == 0)
+    return 0;
+
+  bt = os_malloc (sizeof (*bt));
+  if ((bt->fp = fopen (config.btrace_file, "wb")) == NULL)
+  {
+    NN_ERROR1 ("binary trace file %s could not be opened\n", config.btrace_file);
+    os_free (bt);
+    return ERR_UNSPECIFIED;
+  }
+  fhdr.magic = NN_BTRACE_MAGIC;
+  fhdr.version = NN_BTRACE_VERSION;
+  fhdr.endian = 0x01020304;
+  fhdr.record_size = (os_uint32) sizeof (struct nn_btrace_record);
+  fwrite (&fhdr, sizeof (fhdr), 1, bt->fp);
+
+  /* largest power of two number of records that fits in the buffer */
+  nrecs = BTRACE_MIN_RECORDS;
+  while (2 * nrecs * sizeof (struct nn_btrace_record) <= config.btrace_bufsize)
+    nrecs *= 2;
+
+  bt->nrings = thread_states.nthreads;
+  bt->rings = os_malloc (bt->nrings * sizeof (*bt->rings));
+  for (i = 0; i < bt->nrings; i++)
+  {
+    struct nn_btrace_ring *r = &bt->rings[i];
+    pa_st32 (&r->wridx, 0);
+    pa_st32 (&r->rdidx, 0);
+    pa_st32 (&r->ndropped, 0);
+    r->ndropped_reported = 0;
+    r->mask = nrecs - 1;
+    r->recs = os_malloc (nrecs * sizeof (*r->recs));
+  }
+  os_mutexInit (&bt->io_lock, NULL);
+  os_mutexInit (&bt->lock, NULL);
+  os_condInit (&bt->cond, &bt->lock, NULL);
+  bt->stop = 0;
+  bt->ts = create_thread ("btrace", (void * (*) (void *)) btrace_thread, bt);
+
+  /* rings must be fully initialised before any thread can see them */
+  pa_fence ();
+  for (i = 0; i < bt->nrings; i++)
+    thread_states.ts[i].btr = &bt->rings[i];
+  gv.btrace = bt;
+  pa_fence ();
+  gv.btrace_enabled = 1;
+  nn_log (LC_CONFIG, "binary tracing to %s, %u records per thread\n", config.btrace_file, (unsigned) nrecs);
+  return 0;
+}
+
+void nn_btrace_fini (void)
+{
+  struct nn_btrace *bt = gv.btrace;
+  unsigned i;
+  if (bt == NULL)
+    return;
+
+  /* Only called once all other threads have stopped, so no-one can
+     be writing into a ring anymore once the main thread is done */
+  gv.btrace_enabled = 0;
+  for (i = 0; i < bt->nrings; i++)
+    thread_states.ts[i].btr = NULL;
+  pa_fence ();
+
+  os_mutexLock (&bt->lock);
+  bt->stop = 1;
+  os_condBroadcast (&bt->cond);
+  os_mutexUnlock (&bt->lock);
+  join_thread (bt->ts, NULL);
+
+  for (i = 0; i < bt->nrings; i++)
+    os_free (bt->rings[i].recs);
+  os_free (bt->rings);
+  os_condDestroy (&bt->cond);
+  os_mutexDestroy (&bt->lock);
+  os_mutexDestroy (&bt->io_lock);
+  fclose (bt->fp);
+  os_free (bt);
+  gv.btrace = NULL;
+}
+
+/* SHA1 not available (unoffical build.) */
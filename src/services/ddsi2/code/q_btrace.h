@@ -0,0 +1,105 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#ifndef Q_BTRACE_H
+#define Q_BTRACE_H
+
+#include "os_defs.h"
+#include "q_rtps.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* Binary event tracing: trace points on the hot paths append a
+   fixed-size record to a ring buffer owned by the calling thread,
+   without taking any locks or formatting anything, and a background
+   thread ("btrace") periodically moves the contents of all rings to
+   Tracing/BinaryOutputFile. Formatting is left to an offline tool,
+   src/tools/btracedump.
+   If a ring is full, records are dropped and counted rather than
+   having the thread wait.
+
+   File format (native byte order, see the "endian" field):
+
+     struct nn_btrace_file_header
+     repeat {
+       struct nn_btrace_chunk_header
+       struct nn_btrace_record[chunk_header.nrecords]
+     }
+
+   Each chunk contains records from a single thread slot, in order;
+   records from different chunks can be merged on their timestamps. */
+
+enum nn_btrace_event {
+  NN_BTE_WRITE,          /* local writer: seq, arg = serialized size */
+  NN_BTE_SEND_HEARTBEAT, /* local writer: seq = max seq, arg = count */
+  NN_BTE_RECV_ACKNACK,   /* local writer: seq = base, arg = numbits */
+  NN_BTE_REXMIT,         /* local writer: seq retransmitted, arg = fragment or ~0 */
+  NN_BTE_THROTTLE,       /* local writer: seq = last seq, arg = unacked bytes */
+  NN_BTE_RECV_DATA,      /* proxy writer: seq, arg = fragment or ~0 */
+  NN_BTE_RECV_HEARTBEAT, /* proxy writer: seq = last seq, arg = count */
+  NN_BTE_RECV_GAP,       /* proxy writer: seq = gap start, arg = bitmap base - gap start */
+  NN_BTE_SEND_ACKNACK,   /* proxy writer: seq = base, arg = numbits, bit 31 set if NACK */
+  NN_BTE_DELIVER         /* proxy writer: seq delivered to the kernel */
+};
+
+#define NN_BTRACE_MAGIC 0x42543244u /* "D2TB" in little-endian */
+#define NN_BTRACE_VERSION 1u
+
+struct nn_btrace_file_header {
+  os_uint32 magic;
+  os_uint32 version;
+  os_uint32 endian;      /* 0x01020304 */
+  os_uint32 record_size; /* sizeof (struct nn_btrace_record) */
+};
+
+struct nn_btrace_chunk_header {
+  os_uint32 slot;        /* thread slot index */
+  os_uint32 nrecords;
+  os_uint32 ndropped;    /* records dropped since previous chunk of this slot */
+  char tname[20];        /* name of thread at time of writing, may be truncated */
+};
+
+struct nn_btrace_record {
+  os_int64 tstamp;       /* wall-clock time in ns (nn_wctime_t) */
+  os_int64 seq;
+  nn_guid_t guid;
+  os_uint32 event;       /* enum nn_btrace_event */
+  os_uint32 arg;
+};
+
+int nn_btrace_init (void);
+void nn_btrace_fini (void);
+void nn_btrace (enum nn_btrace_event ev, const nn_guid_t *guid, os_int64 seq, os_uint32 arg);
+
+/* Called for a thread that has stopped, before its slot is released */
+struct thread_state1;
+void nn_btrace_thread_exit (const struct thread_state1 *ts1);
+
+/* Like TRACE, requires q_globals.h */
+#define NN_BTRACE(ev, guid, seq, arg) (gv.btrace_enabled ? nn_btrace ((ev), (guid), (seq), (arg)) : (void) 0)
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* Q_BTRACE_H */
+
+/* SHA1 not available (unoffical build.) */
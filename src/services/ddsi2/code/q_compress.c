@@ -0,0 +1,359 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include <assert.h>
+#include <string.h>
+
+#include "os_defs.h"
+#include "os_heap.h"
+#include "os_mutex.h"
+#include "os_stdlib.h"
+#include "os_atomics.h"
+
+#include "ut_compressor.h"
+
+#include "q_compress.h"
+#include "q_config.h"
+#include "q_log.h"
+#include "q_misc.h"
+#include "q_xqos.h"
+#include "q_bswap.h"
+#include "q_stats.h"
+#include "q_entity.h"
+#include "ddsi_ser.h"
+
+#include "sysdeps.h"
+
+#define N_COMPRESSORS (NN_COMPRESS_ZLIB + 1)
+
+struct compress_pattern {
+  char *partition;
+  char *topic;
+};
+
+static struct {
+  unsigned algorithm; /* NN_COMPRESS_..., 0 if not compressing */
+  pa_voidp_t compressors[N_COMPRESSORS]; /* ut_compressor, indexed by NN_COMPRESS_..., created on first use */
+  pa_uint32_t unavailable; /* bitmask of compressors that failed to initialise */
+  unsigned npatterns;
+  struct compress_pattern *patterns;
+  pa_uint32_t n_compressed;
+  pa_uint32_t n_incompressible;
+  pa_uint32_t n_decompressed;
+  pa_uint32_t n_errors;
+  os_mutex lock; /* protects bytes_in, bytes_out */
+  os_uint64 bytes_in;
+  os_uint64 bytes_out;
+  struct nn_stat_hist compress_cpu_hist;
+  struct nn_stat_hist decompress_cpu_hist;
+} compress;
+
+static const char *compressor_names[N_COMPRESSORS] = {
+  "none", "lzf", "snappy", "zlib"
+};
+
+static void parse_patterns (const char *spec)
+{
+  /* Comma-separated list of PARTITION.TOPIC expressions; topic names
+     can't contain a '.', partition names can, so split at the last
+     one. An expression without a '.' is taken to be a topic name in
+     any partition. */
+  char *copy = os_strdup (spec), *cursor = copy, *tok;
+  unsigned n = 0;
+  while ((tok = os_strsep (&cursor, ",")) != NULL)
+  {
+    if (*tok)
+      n++;
+  }
+  os_free (copy);
+  compress.npatterns = 0;
+  compress.patterns = (n == 0) ? NULL : os_malloc (n * sizeof (*compress.patterns));
+  copy = os_strdup (spec);
+  cursor = copy;
+  while ((tok = os_strsep (&cursor, ",")) != NULL)
+  {
+    struct compress_pattern *p;
+    char *dot;
+    if (*tok == 0)
+      continue;
+    p = &compress.patterns[compress.npatterns++];
+    if ((dot = strrchr (tok, '.')) == NULL)
+    {
+      p->partition = os_strdup ("*");
+      p->topic = os_strdup (tok);
+    }
+    else
+    {
+      *dot = 0;
+      p->partition = os_strdup (tok);
+      p->topic = os_strdup (dot + 1);
+    }
+  }
+  os_free (copy);
+  assert (compress.npatterns == n);
+}
+
+static ut_compressor get_compressor (unsigned alg)
+{
+  /* Receiving requires whatever compressor the sender chose, so they
+     are instantiated on first use, which also avoids loading any
+     compression library when compression is not used at all */
+  ut_compressor c;
+  assert (alg > 0 && alg < N_COMPRESSORS);
+  if ((c = pa_ldvoidp (&compress.compressors[alg])) != NULL)
+    return c;
+  if (pa_ld32 (&compress.unavailable) & (1u << alg))
+    return NULL;
+  if ((c = ut_compressorNew (NULL, compressor_names[alg], NULL)) == NULL)
+  {
+    if (!(pa_or32_ov (&compress.unavailable, 1u << alg) & (1u << alg)))
+      NN_WARNING1 ("compression: %s compressor not available\n", compressor_names[alg]);
+    return NULL;
+  }
+  if (!pa_casvoidp (&compress.compressors[alg], NULL, c))
+  {
+    ut_compressorFree (c);
+    c = pa_ldvoidp (&compress.compressors[alg]);
+  }
+  return c;
+}
+
+void nn_compress_init (void)
+{
+  memset (&compress, 0, sizeof (compress));
+  os_mutexInit (&compress.lock, NULL);
+  nn_stat_hist_init (&compress.compress_cpu_hist);
+  nn_stat_hist_init (&compress.decompress_cpu_hist);
+
+  switch (config.compression_algorithm)
+  {
+    case COMPRESSION_NONE: compress.algorithm = 0; break;
+    case COMPRESSION_LZF: compress.algorithm = NN_COMPRESS_LZF; break;
+    case COMPRESSION_SNAPPY: compress.algorithm = NN_COMPRESS_SNAPPY; break;
+    case COMPRESSION_ZLIB: compress.algorithm = NN_COMPRESS_ZLIB; break;
+  }
+  if (compress.algorithm != 0)
+  {
+    parse_patterns (config.compression_topics);
+    if (compress.npatterns == 0 || get_compressor (compress.algorithm) == NULL)
+      compress.algorithm = 0;
+  }
+  nn_log (LC_CONFIG, "compression: %s (threshold %u bytes)\n", compressor_names[compress.algorithm], config.compression_threshold);
+}
+
+void nn_compress_fini (void)
+{
+  unsigned i;
+  for (i = 0; i < compress.npatterns; i++)
+  {
+    os_free (compress.patterns[i].partition);
+    os_free (compress.patterns[i].topic);
+  }
+  os_free (compress.patterns);
+  for (i = 1; i < N_COMPRESSORS; i++)
+  {
+    ut_compressor c = pa_ldvoidp (&compress.compressors[i]);
+    if (c)
+      ut_compressorFree (c);
+  }
+  os_mutexDestroy (&compress.lock);
+}
+
+int nn_compress_writer_enabled (const struct nn_xqos *xqos, const struct sertopic *topic)
+{
+  unsigned i, j;
+  if (compress.algorithm == 0 || topic == NULL)
+    return 0;
+  for (i = 0; i < compress.npatterns; i++)
+  {
+    const struct compress_pattern *p = &compress.patterns[i];
+    if (!ddsi2_patmatch (p->topic, topic->name))
+      continue;
+    if (!(xqos->present & QP_PARTITION) || xqos->partition.n == 0)
+    {
+      if (ddsi2_patmatch (p->partition, ""))
+        return 1;
+    }
+    else
+    {
+      for (j = 0; j < xqos->partition.n; j++)
+        if (ddsi2_patmatch (p->partition, xqos->partition.strs[j]))
+          return 1;
+    }
+  }
+  return 0;
+}
+
+static struct serdata *compress_serdata (struct serdata *d)
+{
+  /* Returns a new serdata holding the compressed form of D, or D itself
+     if D can't be compressed or doesn't shrink */
+  serstate_t st = d->v.st, cst;
+  const os_size_t size = ddsi_serdata_size (d);
+  ut_compressor c;
+  void *buf = NULL;
+  os_size_t buflen = 0, clen;
+  os_int64 t0;
+  ut_result res;
+  os_uint32 lenBE;
+
+  /* Key references into the payload would be invalid in the compressed
+     form, and only full samples are worth the trouble */
+  if (compress.algorithm == 0 || st->kind != STK_DATA || d->v.isstringref || size < config.compression_threshold)
+    return d;
+  c = pa_ldvoidp (&compress.compressors[compress.algorithm]);
+
+  t0 = get_thread_cputime ();
+  res = ut_compressorCompress (c, &d->hdr, size, &buf, &buflen, &clen);
+  nn_stat_hist_add (&compress.compress_cpu_hist, get_thread_cputime () - t0);
+  if (res != UT_RESULT_OK)
+  {
+    pa_inc32 (&compress.n_errors);
+    return d;
+  }
+  if (sizeof (struct CDRHeader) + sizeof (os_uint32) + clen >= size)
+  {
+    pa_inc32 (&compress.n_incompressible);
+    os_free (buf);
+    return d;
+  }
+
+  cst = ddsi_serstate_new (st->pool, st->topic);
+  cst->twrite = st->twrite;
+  cst->data->v.msginfo = d->v.msginfo;
+  cst->data->v.hash_valid = d->v.hash_valid;
+  cst->data->v.hash = d->v.hash;
+  memcpy (cst->data->v.key, d->v.key, sizeof (cst->data->v.key));
+  cst->data->hdr.identifier = CDR_COMPRESSED;
+  cst->data->hdr.options = toBE2u ((unsigned short) compress.algorithm);
+  lenBE = toBE4u ((os_uint32) clen);
+  ddsi_serstate_append_blob (cst, 4, sizeof (lenBE), &lenBE);
+  ddsi_serstate_append_blob (cst, 1, clen, buf);
+  os_free (buf);
+
+  pa_inc32 (&compress.n_compressed);
+  os_mutexLock (&compress.lock);
+  compress.bytes_in += size;
+  compress.bytes_out += sizeof (struct CDRHeader) + cst->pos;
+  os_mutexUnlock (&compress.lock);
+  return ddsi_serstate_fix (cst);
+}
+
+int nn_compress_wanted (const struct writer *wr, const struct proxy_reader *prd)
+{
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+  if (!wr->compress)
+    return 0;
+  else if (prd)
+    return prd->c.proxypp->supports_compression;
+  else
+    return wr->num_nocompress_readers == 0;
+}
+
+struct serdata *nn_compress_form (struct serdata *d)
+{
+  serstate_t st = d->v.st;
+  struct serdata *cd;
+
+  /* Retransmits and other destinations reuse the compressed form; if
+     two threads race to create it, the loser discards its copy */
+  if ((cd = pa_ldvoidp (&st->compressed)) != NULL)
+    return cd;
+  cd = compress_serdata (d);
+  if (!pa_casvoidp (&st->compressed, NULL, cd))
+  {
+    if (cd != d)
+      ddsi_serdata_unref (cd);
+    cd = pa_ldvoidp (&st->compressed);
+  }
+  return cd;
+}
+
+int nn_compress_wanted_repair (const struct writer *wr, const struct proxy_reader *prd, int sent_compressed)
+{
+  return sent_compressed && nn_compress_wanted (wr, prd);
+}
+
+int nn_decompress_payload (void **dst, size_t *dstsize, const void *src, size_t srcsize)
+{
+  const struct CDRHeader *hdr = src;
+  const char *blob = (const char *) (hdr + 1) + sizeof (os_uint32);
+  unsigned alg;
+  os_uint32 clen;
+  os_size_t maxlen, buflen = 0, ulen;
+  ut_compressor c;
+  os_int64 t0;
+  ut_result res;
+
+  assert (hdr->identifier == CDR_COMPRESSED);
+  *dst = NULL;
+  if (srcsize < sizeof (*hdr) + sizeof (clen))
+    goto err;
+  alg = fromBE2u (hdr->options);
+  memcpy (&clen, hdr + 1, sizeof (clen));
+  clen = fromBE4u (clen);
+  if (alg == 0 || alg >= N_COMPRESSORS || (c = get_compressor (alg)) == NULL)
+    goto err;
+  if (clen > srcsize - sizeof (*hdr) - sizeof (clen))
+    goto err;
+  /* Don't let a bogus length in the compressed data trigger a huge
+     allocation: anything larger than MaxSampleSize gets dropped
+     anyway */
+  if (ut_compressorUncompressMaxLen (c, blob, clen, &maxlen) == UT_RESULT_OK &&
+      maxlen > (os_size_t) config.max_sample_size + sizeof (struct CDRHeader))
+    goto err;
+
+  t0 = get_thread_cputime ();
+  res = ut_compressorUncompress (c, blob, clen, dst, &buflen, &ulen);
+  nn_stat_hist_add (&compress.decompress_cpu_hist, get_thread_cputime () - t0);
+  if (res != UT_RESULT_OK)
+  {
+    *dst = NULL;
+    goto err;
+  }
+  if (ulen < sizeof (struct CDRHeader) || ((const struct CDRHeader *) *dst)->identifier == CDR_COMPRESSED)
+  {
+    os_free (*dst);
+    *dst = NULL;
+    goto err;
+  }
+  *dstsize = ulen;
+  pa_inc32 (&compress.n_decompressed);
+  return 1;
+ err:
+  pa_inc32 (&compress.n_errors);
+  return 0;
+}
+
+void nn_compress_getstats (struct nn_compress_stats *st)
+{
+  st->algorithm = compressor_names[compress.algorithm];
+  st->n_compressed = pa_ld32 (&compress.n_compressed);
+  st->n_incompressible = pa_ld32 (&compress.n_incompressible);
+  st->n_decompressed = pa_ld32 (&compress.n_decompressed);
+  st->n_errors = pa_ld32 (&compress.n_errors);
+  os_mutexLock (&compress.lock);
+  st->bytes_in = compress.bytes_in;
+  st->bytes_out = compress.bytes_out;
+  os_mutexUnlock (&compress.lock);
+  st->compress_cpu_hist = &compress.compress_cpu_hist;
+  st->decompress_cpu_hist = &compress.decompress_cpu_hist;
+}
+
+/* SHA1 not available (unoffical build.) */
@@ -0,0 +1,94 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#ifndef NN_COMPRESS_H
+#define NN_COMPRESS_H
+
+#include "os_defs.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+struct nn_xqos;
+struct sertopic;
+struct serdata;
+struct writer;
+struct proxy_reader;
+struct nn_stat_hist;
+
+/* Algorithm identifiers as carried (big-endian) in the options field
+   of a CDR_COMPRESSED payload; these are part of the wire format. */
+#define NN_COMPRESS_LZF 1
+#define NN_COMPRESS_SNAPPY 2
+#define NN_COMPRESS_ZLIB 3
+
+struct nn_compress_stats {
+  const char *algorithm;
+  os_uint32 n_compressed;       /* samples sent compressed */
+  os_uint32 n_incompressible;   /* samples that did not shrink */
+  os_uint32 n_decompressed;     /* samples received compressed */
+  os_uint32 n_errors;           /* (de)compression failures */
+  os_uint64 bytes_in;           /* uncompressed size of compressed samples */
+  os_uint64 bytes_out;          /* compressed size of compressed samples */
+  const struct nn_stat_hist *compress_cpu_hist;   /* thread CPU time per compression (ns) */
+  const struct nn_stat_hist *decompress_cpu_hist; /* thread CPU time per decompression (ns) */
+};
+
+void nn_compress_init (void);
+void nn_compress_fini (void);
+
+/* Whether a writer with QoS XQOS for TOPIC is configured to compress
+   its samples (Internal/Compression/Topics). */
+int nn_compress_writer_enabled (const struct nn_xqos *xqos, const struct sertopic *topic);
+
+/* Whether WR should send compressed payloads to PRD, or to all its
+   readers if PRD is NULL: only if WR is configured to compress and the
+   destination has advertised it accepts them. WR->e.lock must be
+   held. */
+int nn_compress_wanted (const struct writer *wr, const struct proxy_reader *prd);
+
+/* Returns the compressed form of D, computed on first use and cached
+   with D, or D itself if it can't be compressed or doesn't shrink. The
+   result remains valid for as long as D does. */
+struct serdata *nn_compress_form (struct serdata *d);
+
+/* Whether a repair of a sample whose first transmission was
+   compressed iff SENT_COMPRESSED should be sent compressed to PRD (all
+   readers if NULL). Readers may be holding fragments of the first
+   transmission and fragment numbers refer to that form, so a repair
+   uses the same form unless the destination can't accept it. A reader
+   that can't has discarded the compressed fragments anyway. WR->e.lock
+   must be held. */
+int nn_compress_wanted_repair (const struct writer *wr, const struct proxy_reader *prd, int sent_compressed);
+
+/* Decompresses the CDR_COMPRESSED payload SRC, returning an os_malloc'd
+   buffer holding the original CDRHeader + payload in *DST and its size
+   in *DSTSIZE. Returns 0 on failure. */
+int nn_decompress_payload (void **dst, size_t *dstsize, const void *src, size_t srcsize);
+
+void nn_compress_getstats (struct nn_compress_stats *st);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* NN_COMPRESS_H */
+
+/* SHA1 not available (unoffical build.) */
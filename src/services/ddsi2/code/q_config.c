@@ -155,6 +155,7 @@ DU (uf_duration_ms_1s);
 DU (uf_duration_us_1s);
 DU (uf_standards_conformance);
 DU (uf_besmode);
+DU (uf_compression_algorithm);
 DU (uf_retransmit_merging);
 DU (uf_sched_prio_class);
 DU (uf_sched_class);
@@ -195,6 +196,7 @@ PF (pf_negated_boolean);
 PF (pf_logcat);
 PF (pf_standards_conformance);
 PF (pf_besmode);
+PF (pf_compression_algorithm);
 PF (pf_retransmit_merging);
 PF (pf_sched_prio_class);
 PF (pf_sched_class);
@@ -341,6 +343,8 @@ static const struct cfgelem compatibility_cfgelems[] = {
 static const struct cfgelem unsupp_test_cfgelems[] = {
   { LEAF ("XmitLossiness"), 1, "0", ABSOFF (xmit_lossiness), 0, uf_int, 0, pf_int,
     "<p>This element controls the fraction of outgoing packets to drop, specified as samples per thousand.</p>" },
+  { LEAF ("NoCompressionSupport"), 1, "false", ABSOFF (test_no_compression), 0, uf_boolean, 0, pf_boolean,
+    "<p>This element makes DDSI2 behave as a peer that does not accept compressed payloads: it does not advertise support for them and drops any it receives.</p>" },
   END_MARKER
 };
 
@@ -374,11 +378,33 @@ static const struct cfgelem rediscovery_blacklist_duration_attrs[] = {
   END_MARKER
 };
 
+static const struct cfgelem unsupp_compression_cfgelems[] = {
+  { LEAF ("Algorithm"), 1, "none", ABSOFF (compression_algorithm), 0, uf_compression_algorithm, 0, pf_compression_algorithm,
+    "<p>This element selects the algorithm used for compressing the serialised payload of application samples. Valid values are <i>none</i>, <i>lzf</i>, <i>snappy</i> and <i>zlib</i>. Compressed samples are marked with a vendor-specific encoding that only OpenSplice can interpret, and therefore writers stop compressing as soon as they match a reader of another vendor.</p>" },
+  { LEAF ("Threshold"), 1, "1 KiB", ABSOFF (compression_threshold), 0, uf_memsize, 0, pf_memsize,
+    "<p>This element sets the minimum serialised size of a sample for it to be considered for compression. Samples that do not shrink when compressed are always sent uncompressed.</p>" },
+  { LEAF ("Topics"), 1, "", ABSOFF (compression_topics), 0, uf_string, ff_free, pf_string,
+    "<p>This element specifies the writers for which payload compression is enabled, as a comma-separated list of <i>partition.topic</i> expressions (with ? and * wildcards). A writer compresses its samples if its topic and any of its partitions match one of the expressions.</p>" },
+  END_MARKER
+};
+
+static const struct cfgelem unsupp_shm_loopback_cfgelems[] = {
+  { LEAF ("Enable"), 1, "false", ABSOFF (shm_loopback_enable), 0, uf_boolean, 0, pf_boolean,
+    "<p>This element enables the shared-memory loopback transport, which passes unicast datagrams addressed to another DDSI2 instance on the same host through a ring buffer in shared memory instead of through the kernel's UDP stack. It is only available on Linux, and only between instances running as the same user; all other traffic continues to use UDP.</p>" },
+  { LEAF ("Slots"), 1, "256", ABSOFF (shm_loopback_slots), 0, uf_uint, 0, pf_uint,
+    "<p>This element sets the number of datagrams the receive ring of this instance can hold, it is rounded up to a power of two. Datagrams that do not fit in the ring are sent using UDP instead.</p>" },
+  { LEAF ("SlotSize"), 1, "16 KiB", ABSOFF (shm_loopback_slotsize), 0, uf_memsize, 0, pf_memsize,
+    "<p>This element sets the maximum size of a datagram passed through shared memory. Larger datagrams are sent using UDP.</p>" },
+  END_MARKER
+};
+
 static const struct cfgelem unsupp_cfgelems[] = {
   { MOVED ("MaxMessageSize", "General/MaxMessageSize") },
   { MOVED ("FragmentSize", "General/FragmentSize") },
   { LEAF ("DeliveryQueueMaxSamples"), 1, "256", ABSOFF (delivery_queue_maxsamples), 0, uf_uint, 0, pf_uint,
     "<p>This element controls the Maximum size of a delivery queue, expressed in samples. Once a delivery queue is full, incoming samples destined for that queue are dropped until space becomes available again.</p>" },
+  { LEAF ("DeliveryQueueThreads"), 1, "1", ABSOFF (delivery_queue_threads), 0, uf_uint, 0, pf_uint,
+    "<p>This element sets the number of delivery queues (and hence threads) used for delivering application data to the local readers. Each proxy writer is assigned to one of these queues, so that all data from a single remote writer is delivered in order, while data from different remote writers can be deserialised and delivered concurrently. Writers using group-coherent presentation are assigned by participant, so that the coherent sets of a single publisher remain ordered. All delivery threads share the thread name \"dq.user\".</p>" },
   { LEAF ("PrimaryReorderMaxSamples"), 1, "64", ABSOFF (primary_reorder_maxsamples), 0, uf_uint, 0, pf_uint,
     "<p>This element sets the maximum size in samples of a primary re-order administration. Each proxy writer has one primary re-order administration to buffer the packet flow in case some packets arrive out of order. Old samples are forwarded to secondary re-order administrations associated with readers in need of historical data.</p>" },
   { LEAF ("SecondaryReorderMaxSamples"), 1, "16", ABSOFF (secondary_reorder_maxsamples), 0, uf_uint, 0, pf_uint,
@@ -481,6 +507,10 @@ static const struct cfgelem unsupp_cfgelems[] = {
     "<p>This element controls for how long a remote participant that was previously deleted will remain on a blacklist to prevent rediscovery, giving the software on a node time to perform any cleanup actions it needs to do. To some extent this delay is required internally by DDSI2, but in the default configuration with the 'enforce' attribute set to false, DDSI2 will reallow rediscovery as soon as it has cleared its internal administration. Setting it to too small a value may result in the entry being pruned from the blacklist before DDSI2 is ready, it is therefore recommended to set it to at least several seconds.</p>" },
   { MGROUP ("ControlTopic", control_topic_cfgelems, control_topic_cfgattrs), 1, 0, 0, 0, 0, 0, 0, 0,
     "<p>The ControlTopic element allows configured whether DDSI2 provides a special control interface via a predefined topic or not.<p>" },
+  { GROUP ("Compression", unsupp_compression_cfgelems),
+    "<p>The Compression element controls compression of the payload of application samples exchanged between OpenSplice nodes.</p>" },
+  { GROUP ("SharedMemoryLoopback", unsupp_shm_loopback_cfgelems),
+    "<p>The SharedMemoryLoopback element controls the use of shared memory for exchanging datagrams with other DDSI2 instances on the same host.</p>" },
   { GROUP ("Test", unsupp_test_cfgelems),
     "<p>Testing options.</p>" },
   { GROUP ("Watermarks", unsupp_watermarks_cfgelems),
@@ -494,6 +524,12 @@ static const struct cfgelem sizing_cfgelems[] =
     "<p>This element sets the size of a single receive buffer. Many receive buffers may be needed. Their size must be greater than ReceiveBufferChunkSize by a modest amount.</p>" },
   { LEAF ("ReceiveBufferChunkSize"), 1, "128 KiB", ABSOFF (rmsg_chunk_size), 0, uf_memsize, 0, pf_memsize,
     "<p>This element specifies the size of one allocation unit in the receive buffer. Must be greater than the maximum packet size by a modest amount (too large packets are dropped). Each allocation is shrunk immediately after processing a message, or freed straightaway.</p>" },
+  { LEAF ("ReceiveBufferHugePages"), 1, "false", ABSOFF (rbuf_hugepages), 0, uf_boolean, 0, pf_boolean,
+    "<p>This element controls whether DDSI2 attempts to allocate receive buffers from huge pages (Linux only). The size of a receive buffer is then rounded up to a multiple of the huge page size. If no huge pages are available, ordinary memory is used instead.</p>" },
+  { LEAF ("ReceiveBufferCache"), 1, "4", ABSOFF (rbuf_cache), 0, uf_uint32, 0, pf_uint32,
+    "<p>This element specifies the number of receive buffers that are retained for reuse once all data in them has been delivered, rather than being returned to the system.</p>" },
+  { LEAF ("ReceiveBufferCopyOutThreshold"), 1, "32 MiB", ABSOFF (rbuf_copyout_threshold), 0, uf_memsize, 0, pf_memsize,
+    "<p>This element specifies the amount of memory in receive buffers that can be held only because some of the data in them has not yet been delivered. Beyond this amount, samples queued for delivery are copied out of the receive buffers so these can be released. 0 disables copying.</p>" },
   { LEAF ("LocalEndpoints"), 1, "1000", ABSOFF (gid_hash_softlimit), 0, uf_uint32, 0, pf_uint32,
     "<p>This element specifies the expected maximum number of endpoints local to one DDSI2 service. Underestimating this number will have a significant performance impact, but will not affect correctness; signficantly overestimating it will cause more memory to be used than necessary.</p>" },
   { LEAF ("EndpointsInSystem"), 1, "20000", ABSOFF (guid_hash_softlimit), 0, uf_uint32, 0, pf_uint32,
@@ -524,12 +560,16 @@ static const struct cfgelem discovery_ports_cfgelems[] = {
 static const struct cfgelem tcp_cfgelems[] = {
   { LEAF ("Enable"), 1, "false", ABSOFF (tcp_enable), 0, uf_boolean, 0, pf_boolean,
     "<p>This element enables the optional TCP transport.</p>" },
+  { LEAF ("AsyncWrite"), 1, "false", ABSOFF (tcp_async_write), 0, uf_boolean, 0, pf_boolean,
+    "<p>This element makes writes on TCP connections asynchronous. Data that cannot be written immediately is queued per connection and written by a single event-driven thread, which coalesces the queued messages into as few system calls as possible. A slow peer therefore no longer blocks the threads sending data to other peers. This is only supported on Linux and not in combination with SSL.</p>" },
   { LEAF ("NoDelay"), 1, "true", ABSOFF (tcp_nodelay), 0, uf_boolean, 0, pf_boolean,
     "<p>This element enables the TCP_NODELAY socket option, preventing multiple DDSI messages being sent in the same TCP request. Setting this option typically optimises latency over throughput.</p>" },
   { LEAF ("Port"), 1, "-1", ABSOFF (tcp_port), 0, uf_dyn_port, 0, pf_int,
     "<p>This element specifies the TCP port number on which DDSI2 accepts connections. If the port is set it is used in entity locators, published with DDSI discovery. Dynamically allocated if zero. Disabled if -1 or not configured. If disabled other DDSI services will not be able to establish connections with the service, the service can only communicate by establishing connections to other services.</p>" },
   { LEAF ("ReadTimeout"), 1, "2 s", ABSOFF (tcp_read_timeout), 0, uf_duration_ms_1hr, 0, pf_duration,
     "<p>This element specifies the timeout for blocking TCP read operations. If this timeout expires then the connection is closed.</p>" },
+  { LEAF ("WriteQueueSize"), 1, "1 MiB", ABSOFF (tcp_write_queue_size), 0, uf_memsize, 0, pf_memsize,
+    "<p>This element sets the maximum number of bytes queued for a single connection when TCP/AsyncWrite is enabled. Messages that do not fit are dropped, leaving recovery to the DDSI protocol, just as with a full socket buffer on UDP. A connection on which nothing can be written for longer than TCP/WriteTimeout is closed.</p>" },
   { LEAF ("WriteTimeout"), 1, "2 s", ABSOFF (tcp_write_timeout), 0, uf_duration_ms_1hr, 0, pf_duration,
     "<p>This element specifies the timeout for blocking TCP write operations. If this timeout expires then the connection is closed.</p>" },
   END_MARKER
@@ -655,6 +695,10 @@ static const struct cfgelem tracing_cfgelems[] = {
     "<p>This option specifies whether the output is to be appended to an existing log file. The default is to create a new log file each time, which is generally the best option if a detailed log is generated.</p>" },
   { LEAF ("PacketCaptureFile"), 1, "", ABSOFF (pcap_file), 0, uf_string, ff_free, pf_string,
     "<p>This option specifies the file to which received and sent packets will be logged in the \"pcap\" format suitable for analysis using common networking tools, such as WireShark. IP and UDP headers are ficitious, in particular the destination address of received packets. The TTL may be used to distinguish between sent and received packets: it is 255 for sent packets and 128 for received ones. Currently IPv4 only.</p>" },
+  { LEAF ("BinaryOutputFile"), 1, "", ABSOFF (btrace_file), 0, uf_string, ff_free, pf_string,
+    "<p>This option specifies the file to which a binary event trace is written. Trace points on the data path (writing, receiving, delivering, heartbeats, acknowledgements, retransmits) then store fixed-size records in a per-thread ring buffer, which a background thread writes to this file for offline analysis with the btracedump tool. DDSI2 fails to start if the file cannot be created. This is cheap enough to be left enabled in production systems, unlike the Tracing/Verbosity finest level. It is disabled by default.</p>" },
+  { LEAF ("BinaryBufferSize"), 1, "256 kB", ABSOFF (btrace_bufsize), 0, uf_memsize, 0, pf_memsize,
+    "<p>This element sets the size of the per-thread ring buffer used for binary tracing (see Tracing/BinaryOutputFile). Records are dropped (and counted) if a thread generates events faster than they can be written to the file.</p>" },
   END_MARKER
 };
 
@@ -1193,6 +1237,37 @@ static void pf_besmode (struct cfgst *cfgst, void *parent, struct cfgelem const
 }
 
 
+static int uf_compression_algorithm (struct cfgst *cfgst, UNUSED_ARG (void *parent), UNUSED_ARG (struct cfgelem const * const cfgelem), UNUSED_ARG (int first), const char *value)
+{
+  static const char *vs[] = {
+    "none", "lzf", "snappy", "zlib", NULL
+  };
+  static const enum compression_algorithm ms[] = {
+    COMPRESSION_NONE, COMPRESSION_LZF, COMPRESSION_SNAPPY, COMPRESSION_ZLIB, 0,
+  };
+  int idx = list_index (vs, value);
+  enum compression_algorithm *elem = cfg_address (cfgst, parent, cfgelem);
+  assert (sizeof (vs) / sizeof (*vs) == sizeof (ms) / sizeof (*ms));
+  if (idx < 0)
+    return cfg_error (cfgst, "'%s': undefined value", value);
+  *elem = ms[idx];
+  return 1;
+}
+
+static void pf_compression_algorithm (struct cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, int is_default)
+{
+  enum compression_algorithm *p = cfg_address (cfgst, parent, cfgelem);
+  const char *str = "INVALID";
+  switch (*p)
+  {
+    case COMPRESSION_NONE: str = "none"; break;
+    case COMPRESSION_LZF: str = "lzf"; break;
+    case COMPRESSION_SNAPPY: str = "snappy"; break;
+    case COMPRESSION_ZLIB: str = "zlib"; break;
+  }
+  cfg_log (cfgst, "%s%s", str, is_default ? " [def]" : "");
+}
+
 static int uf_retransmit_merging (struct cfgst *cfgst, UNUSED_ARG (void *parent), UNUSED_ARG (struct cfgelem const * const cfgelem), UNUSED_ARG (int first), const char *value)
 {
   static const char *vs[] = {
@@ -61,6 +61,13 @@ enum besmode {
   BESMODE_MINIMAL
 };
 
+enum compression_algorithm {
+  COMPRESSION_NONE,
+  COMPRESSION_LZF,
+  COMPRESSION_SNAPPY,
+  COMPRESSION_ZLIB
+};
+
 enum retransmit_merging {
   REXMIT_MERGE_NEVER,
   REXMIT_MERGE_ADAPTIVE,
@@ -131,6 +138,8 @@ struct config
   logcat_t enabled_logcats;
   char *servicename;
   char *pcap_file;
+  char *btrace_file;
+  os_uint32 btrace_bufsize;
 
   char *networkAddressString;
   char **networkRecvAddressStrings;
@@ -173,6 +182,7 @@ struct config
   unsigned secondary_reorder_maxsamples;
 
   unsigned delivery_queue_maxsamples;
+  unsigned delivery_queue_threads;
 
   float servicelease_expiry_time;
   float servicelease_update_factor;
@@ -198,6 +208,8 @@ struct config
   int tcp_port;
   os_int64 tcp_read_timeout;
   os_int64 tcp_write_timeout;
+  int tcp_async_write;
+  os_uint32 tcp_write_queue_size;
 
 #ifdef DDSI_INCLUDE_SSL
 
@@ -229,8 +241,12 @@ struct config
 
   /* debug/test/undoc features: */
   int xmit_lossiness;           /**<< fraction of packets to drop on xmit, in units of 1e-3 */
+  int test_no_compression;      /**<< behave as a peer that doesn't accept compressed payloads */
   os_uint32 rmsg_chunk_size;          /**<< size of a chunk in the receive buffer */
   os_uint32 rbuf_size;                /* << size of a single receiver buffer */
+  int rbuf_hugepages;                 /* << try to back receive buffers with huge pages */
+  os_uint32 rbuf_cache;               /* << number of drained receive buffers kept for reuse */
+  os_uint32 rbuf_copyout_threshold;   /* << pinned receive buffer bytes beyond which samples get copied out */
   enum besmode besmode;
   int aggressive_keep_last_whc;
   int conservative_builtin_reader_startup;
@@ -268,6 +284,16 @@ struct config
   int generate_keyhash;
   os_uint32 max_sample_size;
 
+  /* payload compression (OpenSplice-to-OpenSplice only) */
+  enum compression_algorithm compression_algorithm;
+  os_uint32 compression_threshold;
+  char *compression_topics;
+
+  /* shared-memory loopback transport (same host, Linux only) */
+  int shm_loopback_enable;
+  unsigned shm_loopback_slots;
+  os_uint32 shm_loopback_slotsize;
+
   /* compability options */
   enum nn_standards_conformance standards_conformance;
   int explicitly_publish_qos_set_to_default;
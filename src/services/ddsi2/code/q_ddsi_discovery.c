@@ -280,6 +280,8 @@ int spdp_write (struct participant *pp)
     ps.prismtech_participant_version_info.flags |=
       NN_PRISMTECH_FL_DISCOVERY_INCLUDES_GID |
       NN_PRISMTECH_FL_KERNEL_SEQUENCE_NUMBER;
+    if (!config.test_no_compression)
+      ps.prismtech_participant_version_info.flags |= NN_PRISMTECH_FL_SUPPORTS_COMPRESSION;
     if (config.besmode == BESMODE_MINIMAL)
       ps.prismtech_participant_version_info.flags |= NN_PRISMTECH_FL_MINIMAL_BES_MODE;
     os_mutexLock (&gv.privileged_pp_lock);
@@ -1088,6 +1090,23 @@ static struct proxy_participant *implicitly_create_proxypp (const nn_guid_t *ppg
   return ephash_lookup_proxy_participant_guid (ppguid);
 }
 
+static struct nn_dqueue *user_dqueue_for_proxy_writer (const nn_guid_t *guid, const nn_xqos_t *xqos)
+{
+  /* All data of a proxy writer must go through a single delivery
+     queue to preserve ordering; spreading proxy writers over the
+     queues is what gives us concurrent delivery.  Group-coherent
+     writers of one participant stay together so their coherent sets
+     reach the kernel in the order in which they were published. */
+  os_uint32 h;
+  if (gv.n_user_dqueues == 1)
+    return gv.user_dqueues[0];
+  h = guid->prefix.u[0] ^ guid->prefix.u[1] ^ guid->prefix.u[2];
+  if (!(xqos->presentation.coherent_access && xqos->presentation.access_scope == NN_GROUP_PRESENTATION_QOS))
+    h ^= guid->entityid.u;
+  h *= 2654435769u;
+  return gv.user_dqueues[(h >> 16) % gv.n_user_dqueues];
+}
+
 static void handle_SEDP_alive (nn_plist_t *datap /* note: potentially modifies datap */, const nn_guid_prefix_t *src_guid_prefix, nn_vendorid_t vendorid)
 {
 #define E(msg, lbl) do { nn_log (LC_TRACE, (msg)); goto lbl; } while (0)
@@ -1242,7 +1261,7 @@ static void handle_SEDP_alive (nn_plist_t *datap /* note: potentially modifies d
       {
         /* not supposed to get here for built-in ones, so can determine the channel based on the transport priority */
         assert (!is_builtin_entityid (datap->endpoint_guid.entityid, vendorid));
-        new_proxy_writer (&ppguid, &datap->endpoint_guid, as, datap, gv.user_dqueue, gv.xevents);
+        new_proxy_writer (&ppguid, &datap->endpoint_guid, as, datap, user_dqueue_for_proxy_writer (&datap->endpoint_guid, xqos), gv.xevents);
       }
     }
     else
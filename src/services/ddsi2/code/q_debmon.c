@@ -45,11 +45,14 @@
 #include "q_globals.h"
 #include "q_addrset.h"
 #include "q_radmin.h"
+#include "q_stats.h"
+#include "q_xevent.h"
 #include "q_ddsi_discovery.h"
 #include "q_protocol.h" /* NN_ENTITYID_... */
 #include "q_unused.h"
 #include "q_error.h"
 #include "q_debmon.h"
+#include "q_compress.h"
 #include "ddsi_ser.h"
 #include "ddsi_tran.h"
 #include "ddsi_tcp.h"
@@ -332,6 +335,155 @@ static int print_proxy_participants (struct thread_state1 *self, ddsi_tran_conn_
   return x;
 }
 
+static int print_rbufpool1 (ddsi_tran_conn_t conn, const char *name, struct nn_rbufpool *rbp)
+{
+  struct nn_rbufpool_stats st;
+  int x = 0;
+  if (rbp == NULL)
+    return 0;
+  nn_rbufpool_getstats (rbp, &st);
+  x += cpf (conn, "%s size %u live %u (hugepage %u) pinned %u (max %u) cached %u\n",
+            name, st.rbuf_size, st.n_live, st.n_hugepage, st.n_pinned, st.n_pinned_max, st.n_cached);
+  x += cpf (conn, "    #alloc %"PA_PRIu64" #recycle %"PA_PRIu64" #copyout %"PA_PRIu64" (%"PA_PRIu64" bytes)\n",
+            st.n_allocated, st.n_recycled, st.n_copyout, st.copyout_bytes);
+  return x;
+}
+
+static int print_rbufpool (ddsi_tran_conn_t conn)
+{
+  int x = 0;
+  x += print_rbufpool1 (conn, "rbufpool", gv.rbufpool);
+  x += print_rbufpool1 (conn, "rbufpool.shm", gv.shm_rbufpool);
+  return x;
+}
+
+/* Statistics are printed one record per line, each line starting with
+   "stats", followed by the kind of object, its name and a list of
+   key=value pairs, so the output can be processed by a script without
+   having to understand the human-readable dump above. Histograms are
+   printed as NAME.n, a few percentiles and NAME.hist=LO:COUNT,... for
+   the non-empty buckets, LO being the smallest value in the bucket. */
+
+static int print_hist (ddsi_tran_conn_t conn, const char *name, const struct nn_stat_hist *h)
+{
+  const char *sep = "";
+  unsigned i;
+  int x = 0;
+  x += cpf (conn, " %s.n=%u %s.p50=%lld %s.p90=%lld %s.p99=%lld %s.max=%lld %s.hist=",
+            name, nn_stat_hist_count (h),
+            name, nn_stat_hist_percentile (h, 50), name, nn_stat_hist_percentile (h, 90),
+            name, nn_stat_hist_percentile (h, 99), name, nn_stat_hist_percentile (h, 100), name);
+  for (i = 0; i < NN_STAT_HIST_NBUCKETS; i++)
+  {
+    os_uint32 c = pa_ld32 ((pa_uint32_t *) &h->bucket[i]);
+    if (c != 0)
+    {
+      x += cpf (conn, "%s%lld:%u", sep, nn_stat_hist_bucket_min (i), c);
+      sep = ",";
+    }
+  }
+  return x;
+}
+
+static int print_stats_dqueue (ddsi_tran_conn_t conn, struct nn_dqueue *q, unsigned idx)
+{
+  struct nn_dqueue_stats st;
+  int x = 0;
+  nn_dqueue_getstats (q, &st);
+  x += cpf (conn, "stats dqueue %s.%u len=%u maxlen=%u delivered=%u",
+            st.name, idx, st.nof_samples, st.max_nof_samples, st.n_delivered);
+  x += print_hist (conn, "delay", st.delay_hist);
+  x += cpf (conn, "\n");
+  return x;
+}
+
+static int print_stats (struct thread_state1 *self, ddsi_tran_conn_t conn)
+{
+  ddsi_tran_factory_t f;
+  int x = 0;
+
+  for (f = ddsi_factory_first (); f; f = f->m_factory)
+  {
+    struct thread_tran_stats st;
+    ddsi_factory_getstats (f, &st);
+    x += cpf (conn, "stats tran %s pkts_in=%"PA_PRIu64" bytes_in=%"PA_PRIu64" pkts_out=%"PA_PRIu64" bytes_out=%"PA_PRIu64" errs_out=%"PA_PRIu64"\n",
+              f->m_typename, st.packets_in, st.bytes_in, st.packets_out, st.bytes_out, st.errors_out);
+  }
+  {
+    struct ddsi_tcp_stats st;
+    if (ddsi_tcp_getstats (&st))
+    {
+      x += cpf (conn, "stats tcp direct=%u queued=%u dropped=%u writev=%u coalesced=%u timeouts=%u max_queued_bytes=%u\n",
+                st.n_direct, st.n_queued, st.n_dropped, st.n_writev, st.n_coalesced, st.n_timeouts, st.max_queued_bytes);
+    }
+  }
+
+  if (gv.builtins_dqueue)
+    x += print_stats_dqueue (conn, gv.builtins_dqueue, 0);
+  {
+    unsigned i;
+    for (i = 0; i < gv.n_user_dqueues; i++)
+      x += print_stats_dqueue (conn, gv.user_dqueues[i], i);
+  }
+
+  if (gv.xevents)
+  {
+    struct xeventq_stats st;
+    xeventq_getstats (gv.xevents, &st);
+    x += cpf (conn, "stats xeventq tev timed=%u nontimed=%u rexmit_dropped=%u rexmit_queued_bytes=%"PA_PRIuSIZE" rexmit_queued_msgs=%"PA_PRIuSIZE" rexmit_queued_bytes_max=%"PA_PRIuSIZE"",
+              st.n_timed_handled, st.n_nontimed_handled, st.n_rexmit_dropped,
+              st.queued_rexmit_bytes, st.queued_rexmit_msgs, st.max_seen_queued_rexmit_bytes);
+    x += print_hist (conn, "lateness", st.lateness_hist);
+    x += cpf (conn, "\n");
+  }
+
+  {
+    struct nn_compress_stats st;
+    nn_compress_getstats (&st);
+    x += cpf (conn, "stats compression %s compressed=%u incompressible=%u decompressed=%u errors=%u bytes_in=%"PA_PRIu64" bytes_out=%"PA_PRIu64" ratio_pct=%u",
+              st.algorithm, st.n_compressed, st.n_incompressible, st.n_decompressed, st.n_errors,
+              st.bytes_in, st.bytes_out, (unsigned) (st.bytes_in ? (100 * st.bytes_out) / st.bytes_in : 100));
+    x += print_hist (conn, "compress_cpu", st.compress_cpu_hist);
+    x += print_hist (conn, "decompress_cpu", st.decompress_cpu_hist);
+    x += cpf (conn, "\n");
+  }
+
+  thread_state_awake (self);
+  {
+    struct ephash_enum_writer ew;
+    struct writer *w;
+    ephash_enum_writer_init (&ew);
+    while ((w = ephash_enum_writer_next (&ew)) != NULL)
+    {
+      os_mutexLock (&w->e.lock);
+      x += cpf (conn, "stats wr %x:%x:%x:%x seq=%lld samples=%u bytes=%"PA_PRIu64" acks=%u nacks=%u rexmit=%u rexmit_lost=%u throttle=%u unacked=%"PA_PRIuSIZE"\n",
+                PGUID (w->e.guid), w->seq, w->num_samples_written, w->num_bytes_written,
+                w->num_acks_received, w->num_nacks_received, w->rexmit_count, w->rexmit_lost_count,
+                w->throttle_count, whc_unacked_bytes (w->whc));
+      os_mutexUnlock (&w->e.lock);
+    }
+    ephash_enum_writer_fini (&ew);
+  }
+  {
+    struct ephash_enum_proxy_writer ew;
+    struct proxy_writer *w;
+    ephash_enum_proxy_writer_init (&ew);
+    while ((w = ephash_enum_proxy_writer_next (&ew)) != NULL)
+    {
+      os_mutexLock (&w->e.lock);
+      x += cpf (conn, "stats pwr %x:%x:%x:%x last_seq=%lld samples=%u bytes=%"PA_PRIu64" heartbeats=%u gaps=%u acks_sent=%u nacks_sent=%u",
+                PGUID (w->e.guid), w->last_seq, w->num_samples_received, w->num_bytes_received,
+                w->num_heartbeats_received, w->num_gaps_received, w->num_acks_sent, w->num_nacks_sent);
+      x += print_hist (conn, "latency", &w->latency_hist);
+      x += cpf (conn, "\n");
+      os_mutexUnlock (&w->e.lock);
+    }
+    ephash_enum_proxy_writer_fini (&ew);
+  }
+  thread_state_asleep (self);
+  return x;
+}
+
 static void *debmon_main (void *vdm)
 {
   struct debug_monitor *dm = vdm;
@@ -347,6 +499,10 @@ static void *debmon_main (void *vdm)
       r += print_participants (dm->servts, conn);
       if (r == 0)
         r += print_proxy_participants (dm->servts, conn);
+      if (r == 0)
+        r += print_rbufpool (conn);
+      if (r == 0)
+        r += print_stats (dm->servts, conn);
 
       /* Note: can only add plugins (at the tail) */
       os_mutexLock (&dm->lock);
@@ -58,6 +58,7 @@
 #include "q_fill_msg_qos.h"
 #include "q_error.h"
 #include "q_builtin_topic.h"
+#include "q_compress.h"
 #include "ddsi_ser.h"
 
 #include "sysdeps.h"
@@ -1139,6 +1140,7 @@ static void writer_drop_connection (const struct nn_guid * wr_guid, const struct
       rebuild_writer_addrset (wr);
       remove_acked_messages (wr);
       wr->num_reliable_readers -= m->is_reliable;
+      wr->num_nocompress_readers -= m->no_compression;
     }
     os_mutexUnlock (&wr->e.lock);
     free_wr_prd_match (m);
@@ -1240,6 +1242,7 @@ static void writer_add_connection (struct writer *wr, struct proxy_reader *prd)
   int pretend_everything_acked;
   m->prd_guid = prd->e.guid;
   m->is_reliable = (prd->c.xqos->reliability.kind > NN_BEST_EFFORT_RELIABILITY_QOS);
+  m->no_compression = !prd->c.proxypp->supports_compression;
   m->assumed_in_sync = (config.retransmit_merging == REXMIT_MERGE_ALWAYS);
   m->has_replied_to_hb = !m->is_reliable;
   m->all_have_replied_to_hb = 0;
@@ -1290,6 +1293,7 @@ static void writer_add_connection (struct writer *wr, struct proxy_reader *prd)
     ut_avlInsertIPath (&wr_readers_treedef, &wr->readers, m, &path);
     rebuild_writer_addrset (wr);
     wr->num_reliable_readers += m->is_reliable;
+    wr->num_nocompress_readers += m->no_compression;
     os_mutexUnlock (&wr->e.lock);
 
     /* for proxy readers using a non-wildcard partition matching a
@@ -2159,11 +2163,14 @@ static struct writer * new_writer_guid
   wr->t_rexmit_end.v = 0;
   wr->t_whc_high_upd.v = 0;
   wr->num_reliable_readers = 0;
+  wr->num_nocompress_readers = 0;
   wr->num_acks_received = 0;
   wr->num_nacks_received = 0;
   wr->throttle_count = 0;
   wr->rexmit_count = 0;
   wr->rexmit_lost_count = 0;
+  wr->num_samples_written = 0;
+  wr->num_bytes_written = 0;
 
 
   /* Copy QoS, merging in defaults */
@@ -2217,6 +2224,7 @@ static struct writer * new_writer_guid
        wr->xqos->reliability.kind != NN_BEST_EFFORT_RELIABILITY_QOS);
   }
   wr->topic = topic;
+  wr->compress = !is_builtin_entityid (wr->e.guid.entityid, ownvendorid) && nn_compress_writer_enabled (wr->xqos, topic);
   wr->as = new_addrset ();
   wr->as_group = NULL;
 
@@ -2716,6 +2724,11 @@ void new_proxy_participant
     proxypp->minimal_bes_mode = 1;
   else
     proxypp->minimal_bes_mode = 0;
+  if ((plist->present & PP_PRISMTECH_PARTICIPANT_VERSION_INFO) &&
+      (plist->prismtech_participant_version_info.flags & NN_PRISMTECH_FL_SUPPORTS_COMPRESSION))
+    proxypp->supports_compression = 1;
+  else
+    proxypp->supports_compression = 0;
 
   {
     struct proxy_participant *privpp;
@@ -3381,6 +3394,13 @@ int new_proxy_writer (const struct nn_guid *ppguid, const struct nn_guid *guid,
   }
   pwr->dqueue = dqueue;
   pwr->evq = evq;
+  pwr->num_samples_received = 0;
+  pwr->num_bytes_received = 0;
+  pwr->num_heartbeats_received = 0;
+  pwr->num_gaps_received = 0;
+  pwr->num_acks_sent = 0;
+  pwr->num_nacks_sent = 0;
+  nn_stat_hist_init (&pwr->latency_hist);
 
 
   ephash_insert_proxy_writer_guid (pwr);
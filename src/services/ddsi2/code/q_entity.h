@@ -31,6 +31,7 @@
 #include "q_rtps.h"
 #include "q_protocol.h"
 #include "q_lat_estim.h"
+#include "q_stats.h"
 #include "q_ephash.h"
 #include "q_hbcontrol.h"
 #include "q_feature_check.h"
@@ -74,6 +75,7 @@ struct wr_prd_match {
   unsigned has_replied_to_hb: 1; /* we must keep sending HBs until all readers have this set */
   unsigned all_have_replied_to_hb: 1; /* true iff 'has_replied_to_hb' for all readers in subtree */
   unsigned is_reliable: 1; /* true iff reliable proxy reader */
+  unsigned no_compression: 1; /* true iff proxy reader can't handle compressed payloads */
   os_int64 min_seq; /* smallest ack'd seq nr in subtree */
   os_int64 max_seq; /* sort-of highest ack'd seq nr in subtree (see augment function) */
   os_int64 seq; /* highest acknowledged seq nr */
@@ -195,6 +197,7 @@ struct writer
   unsigned startup_mode: 1; /* causes data to be treated as T-L for a while */
   unsigned include_keyhash: 1;
   unsigned retransmitting: 1;
+  unsigned compress: 1; /* payload compression configured for this writer */
   const struct sertopic * topic;
   struct addrset *as; /* set of addresses to publish to */
   struct addrset *as_group;
@@ -205,12 +208,15 @@ struct writer
   nn_etime_t t_rexmit_end;
   nn_etime_t t_whc_high_upd;
   int num_reliable_readers;
+  int num_nocompress_readers; /* matched readers that can't handle compressed payloads */
   ut_avlTree_t readers;
   os_uint32 num_acks_received;
   os_uint32 num_nacks_received;
   os_uint32 throttle_count;
   os_uint32 rexmit_count;
   os_uint32 rexmit_lost_count;
+  os_uint32 num_samples_written;
+  os_uint64 num_bytes_written;
   struct xeventq *evq;
 };
 
@@ -246,6 +252,7 @@ struct proxy_participant
   unsigned implicitly_created : 1;
   unsigned is_ddsi2_pp: 1;
   unsigned minimal_bes_mode: 1;
+  unsigned supports_compression: 1; /* accepts CDR_COMPRESSED payloads */
   unsigned lease_expired: 1;
   unsigned proxypp_have_spdp: 1;
   unsigned proxypp_have_cm: 1;
@@ -310,6 +317,16 @@ struct proxy_writer {
   struct nn_reorder *reorder;
   struct nn_dqueue *dqueue;
   struct xeventq *evq;
+  /* Statistics, protected by e.lock; the histogram of the latency
+     from the source timestamp to reception (ns, so assuming
+     synchronised clocks) can be read without */
+  os_uint32 num_samples_received;
+  os_uint64 num_bytes_received;
+  os_uint32 num_heartbeats_received;
+  os_uint32 num_gaps_received;
+  os_uint32 num_acks_sent;
+  os_uint32 num_nacks_sent;
+  struct nn_stat_hist latency_hist;
 };
 
 struct proxy_reader {
@@ -53,6 +53,7 @@ extern "C" {
 struct nn_xmsgpool;
 struct serstatepool;
 struct nn_dqueue;
+struct nn_btrace;
 struct nn_reorder;
 struct nn_defrag;
 struct addrset;
@@ -217,6 +218,12 @@ struct q_globals {
   /* Listener thread for connection based transports */
   struct thread_state1 *listen_ts;
 
+  /* Receive thread and buffer pool for the shared-memory loopback
+     ring (ddsi_shm.c); shm_conn is NULL when not in use */
+  struct ddsi_tran_conn * shm_conn;
+  struct thread_state1 *shm_recv_ts;
+  struct nn_rbufpool *shm_rbufpool;
+
   /* Flag cleared when stopping (receive threads). FIXME. */
   int rtps_keepgoing;
 
@@ -266,8 +273,10 @@ struct q_globals {
   os_uint32 networkQueueId;
   struct thread_state1 *channel_reader_ts;
 
-  /* Application data gets its own delivery queue */
-  struct nn_dqueue *user_dqueue;
+  /* Application data gets its own delivery queues, each proxy writer
+     is bound to one of them (see DeliveryQueueThreads) */
+  unsigned n_user_dqueues;
+  struct nn_dqueue **user_dqueues;
 
   /* Transmit side: pools for the serializer & transmit messages and a
      transmit queue*/
@@ -288,6 +297,10 @@ struct q_globals {
   FILE *pcap_fp;
   os_mutex pcap_lock;
 
+  /* Binary event tracing (q_btrace.h), btrace_enabled is 0 if disabled */
+  int btrace_enabled;
+  struct nn_btrace *btrace;
+
   /* Data structure to capture power events */
   os_timePowerEvents powerEvents;
 
@@ -58,10 +58,12 @@
 #include "q_whc.h"
 #include "q_entity.h"
 #include "q_nwif.h"
+#include "q_compress.h"
 #include "q_globals.h"
 #include "q_xmsg.h"
 #include "q_receive.h"
 #include "q_pcap.h"
+#include "q_btrace.h"
 #include "q_feature_check.h"
 
 #include "sysdeps.h"
@@ -69,6 +71,7 @@
 #include "ddsi_ser.h"
 #include "ddsi_tran.h"
 #include "ddsi_udp.h"
+#include "ddsi_shm.h"
 #include "ddsi_tcp.h"
 
 static void add_peer_addresses (struct addrset *as, const struct config_peer_listelem *list)
@@ -377,7 +380,7 @@ static int set_ext_address_and_mask (void)
 
 static int check_thread_properties (void)
 {
-  static const char *fixed[] = { "recv", "tev", "gc", "lease", "dq.builtins", "xmit.user", "dq.user", "debmon", NULL };
+  static const char *fixed[] = { "recv", "tev", "gc", "lease", "dq.builtins", "xmit.user", "dq.user", "debmon", "btrace", NULL };
   const struct config_thread_properties_listelem *e;
   int ok = 1, i;
   for (e = config.thread_properties; e; e = e->next)
@@ -488,6 +491,12 @@ int rtps_config_prep (struct cfgst *cfgst)
     config.max_queued_rexmit_bytes = 2147483647u;
   }
 
+  if (config.delivery_queue_threads == 0)
+  {
+    NN_ERROR0 ("Internal/DeliveryQueueThreads must be at least 1\n");
+    goto err_config_late_error;
+  }
+
   /* Verify thread properties refer to defined threads */
   if (!check_thread_properties ())
   {
@@ -517,10 +526,12 @@ int rtps_config_prep (struct cfgst *cfgst)
   }
 
   /* Thread admin: need max threads, which is currently (2 or 3) for each
-   configured channel plus 7: main, recv, dqueue.builtin,
-   lease, gc, debmon; once thread state admin has been inited, upgrade the
-   main thread one participating in the thread tracking stuff as
-   if it had been created using create_thread(). */
+   configured channel plus 8: main, recv, dqueue.builtin,
+   lease, gc, debmon, btrace, plus one for each user delivery queue and
+   one for the shared-memory loopback receive thread; once thread
+   state admin has been inited, upgrade the main thread one participating
+   in the thread tracking stuff as if it had been created using
+   create_thread(). */
 
   {
   /* For Lite - Temporary
@@ -528,7 +539,7 @@ int rtps_config_prep (struct cfgst *cfgst)
   */
 #define USER_MAX_THREADS 0
 
-    const unsigned max_threads = 9 + USER_MAX_THREADS + config.ddsi2direct_max_threads;
+    const unsigned max_threads = 9 + config.delivery_queue_threads + USER_MAX_THREADS + config.ddsi2direct_max_threads + (config.shm_loopback_enable ? 1 : 0) + ((config.tcp_enable && config.tcp_async_write) ? 1 : 0);
     thread_states_init (max_threads);
   }
 
@@ -690,6 +701,7 @@ int rtps_init (void)
 
   gv.xmsgpool = nn_xmsgpool_new ();
   gv.serpool = ddsi_serstatepool_new ();
+  nn_compress_init ();
 
 
   nn_plist_init_default_participant (&gv.default_plist_pp);
@@ -780,6 +792,11 @@ int rtps_init (void)
     gv.pcap_fp = NULL;
   }
 
+  /* Binary tracing was asked for explicitly, so quietly running
+     without it would only be discovered when the trace is needed */
+  if (nn_btrace_init () < 0)
+    goto err_btrace;
+
   if (gv.m_factory->m_connless)
   {
     os_uint32 port;
@@ -845,6 +862,8 @@ int rtps_init (void)
     }
   }
 
+  ddsi_shm_init ();
+
   /* Create shared transmit connection */
 
   gv.tev_conn = gv.data_conn_uc;
@@ -884,6 +903,11 @@ int rtps_init (void)
   {
     NN_FATAL0 ("rtps_init: can't allocate receive buffer pool\n");
   }
+  gv.shm_rbufpool = NULL;
+  if (gv.shm_conn && (gv.shm_rbufpool = nn_rbufpool_new (config.rbuf_size, config.rmsg_chunk_size)) == NULL)
+  {
+    NN_FATAL0 ("rtps_init: can't allocate shared-memory receive buffer pool\n");
+  }
 
   gv.rtps_keepgoing = 1;
   os_rwlockInit (&gv.qoslock, NULL);
@@ -897,13 +921,28 @@ int rtps_init (void)
     }
   }
 
-  gv.user_dqueue = nn_dqueue_new ("user", config.delivery_queue_maxsamples, user_dqueue_handler, NULL);
+  {
+    unsigned i;
+    gv.n_user_dqueues = config.delivery_queue_threads;
+    gv.user_dqueues = os_malloc (gv.n_user_dqueues * sizeof (*gv.user_dqueues));
+    for (i = 0; i < gv.n_user_dqueues; i++)
+      gv.user_dqueues[i] = nn_dqueue_new ("user", config.delivery_queue_maxsamples, user_dqueue_handler, NULL);
+  }
 
   gv.recv_ts = create_thread ("recv", (void * (*) (void *)) recv_thread, gv.rbufpool);
+  if (gv.shm_conn)
+  {
+    gv.shm_recv_ts = create_thread ("recv.shm", (void * (*) (void *)) shm_recv_thread, gv.shm_rbufpool);
+  }
   if (gv.listener)
   {
     gv.listen_ts = create_thread ("listen", (void * (*) (void *)) listen_thread, gv.listener);
   }
+  if (config.tcp_enable)
+  {
+    /* On failure, TCP simply continues to write synchronously */
+    (void) ddsi_tcp_tx_start ();
+  }
 
   if (gv.startup_mode)
   {
@@ -917,6 +956,8 @@ err_mc_conn:
     ddsi_conn_free (gv.disc_conn_mc);
   if (gv.data_conn_mc)
     ddsi_conn_free (gv.data_conn_mc);
+  nn_btrace_fini ();
+err_btrace:
   if (gv.pcap_fp)
     os_mutexDestroy (&gv.pcap_lock);
   os_sockWaitsetFree (gv.waitset);
@@ -948,6 +989,7 @@ err_unicast_sockets:
   nn_xqos_fini (&gv.default_xqos_wr);
   nn_xqos_fini (&gv.default_xqos_rd);
   nn_plist_fini (&gv.default_plist_pp);
+  nn_compress_fini ();
   ddsi_serstatepool_free (gv.serpool);
   nn_xmsgpool_free (gv.xmsgpool);
   (ddsi_plugin.fini_fn) ();
@@ -987,6 +1029,14 @@ static void builtins_dqueue_ready_cb (void *varg)
   os_mutexUnlock (&arg->lock);
 }
 
+static void log_rbufpool_stats (const char *name, struct nn_rbufpool *rbp)
+{
+  struct nn_rbufpool_stats st;
+  nn_rbufpool_getstats (rbp, &st);
+  nn_log (LC_INFO, "%s: max %u rbufs pinned (rbuf size %u bytes), %"PA_PRIu64" allocated, %"PA_PRIu64" recycled, %"PA_PRIu64" samples (%"PA_PRIu64" bytes) copied out\n",
+          name, st.n_pinned_max, st.rbuf_size, st.n_allocated, st.n_recycled, st.n_copyout, st.copyout_bytes);
+}
+
 void rtps_term_prep (void)
 {
   /* Stop all I/O */
@@ -997,6 +1047,7 @@ void rtps_term_prep (void)
     pa_fence ();
     /* can't wake up throttle_writer, currently, but it'll check every few seconds */
     os_sockWaitsetTrigger (gv.waitset);
+    ddsi_shm_unblock ();
   }
   os_mutexUnlock (&gv.lock);
 }
@@ -1008,6 +1059,10 @@ void rtps_term (void)
   /* Stop all I/O */
   rtps_term_prep ();
   join_thread (gv.recv_ts, NULL);
+  if (gv.shm_conn)
+  {
+    join_thread (gv.shm_recv_ts, NULL);
+  }
 
   if (gv.listener)
   {
@@ -1116,17 +1171,25 @@ void rtps_term (void)
      the expected reference counts all over the radmin thingummies. */
   nn_dqueue_free (gv.builtins_dqueue);
 
-  nn_dqueue_free (gv.user_dqueue);
+  {
+    unsigned i;
+    for (i = 0; i < gv.n_user_dqueues; i++)
+      nn_dqueue_free (gv.user_dqueues[i]);
+    os_free (gv.user_dqueues);
+  }
 
   xeventq_free (gv.xevents);
 
 
   ut_thread_pool_free (gv.thread_pool);
 
+  ddsi_tcp_tx_stop ();
+
   os_sockWaitsetFree (gv.waitset);
 
   (void) joinleave_spdp_defmcip (0);
 
+  ddsi_shm_fini ();
   ddsi_conn_free (gv.disc_conn_mc);
   ddsi_conn_free (gv.data_conn_mc);
   if (gv.disc_conn_uc == gv.data_conn_uc)
@@ -1148,6 +1211,7 @@ void rtps_term (void)
     os_mutexDestroy (&gv.pcap_lock);
     fclose (gv.pcap_fp);
   }
+  nn_btrace_fini ();
 
   unref_addrset (gv.as_disc);
   unref_addrset (gv.as_disc_group);
@@ -1156,7 +1220,13 @@ void rtps_term (void)
      been dropped, which only happens once all receive threads have
      stopped, defrags and reorders have been freed, and all delivery
      queues been drained.  I.e., until very late in the game. */
+  log_rbufpool_stats ("rbufpool", gv.rbufpool);
   nn_rbufpool_free (gv.rbufpool);
+  if (gv.shm_rbufpool)
+  {
+    log_rbufpool_stats ("rbufpool.shm", gv.shm_rbufpool);
+    nn_rbufpool_free (gv.shm_rbufpool);
+  }
 
   ephash_free (gv.guid_hash);
   deleted_participants_admin_fini ();
@@ -1191,6 +1261,7 @@ void rtps_term (void)
       os_free (gv.interfaces[i].name);
   }
 
+  nn_compress_fini ();
   ddsi_serstatepool_free (gv.serpool);
   nn_xmsgpool_free (gv.xmsgpool);
   (ddsi_plugin.fini_fn) ();
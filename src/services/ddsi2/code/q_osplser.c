@@ -46,6 +46,7 @@
 #include "q_error.h"
 #include "q_globals.h"
 #include "q_murmurhash3.h"
+#include "q_compress.h"
 
 #include "sd_cdr.h"
 
@@ -2085,6 +2086,16 @@ v_message deserialize (const struct sertopic * topic, const void *vsrc, size_t v
   char *dst;
   const char *src;
   size_t srcsize;
+  if (vsrcsize >= sizeof (struct CDRHeader) && ((const struct CDRHeader *) vsrc)->identifier == CDR_COMPRESSED)
+  {
+    void *buf;
+    size_t bufsize;
+    if (!nn_decompress_payload (&buf, &bufsize, vsrc, vsrcsize))
+      return NULL;
+    msg = deserialize (topic, buf, bufsize);
+    os_free (buf);
+    return msg;
+  }
   if (!deserialize_prep (&msg, &dst, &df, &src, &srcsize, topic, vsrc, vsrcsize))
     goto fail;
 #if USE_PRIVATE_SERIALIZER
@@ -2239,6 +2250,10 @@ static int prettyprint_prep (char **dst, int *dstsize, int *swap, const char **s
     case CDR_LE:
       *swap = ! PLATFORM_IS_LITTLE_ENDIAN;
       break;
+    case CDR_COMPRESSED:
+      mysnprintf (dst, dstsize, "(compressed)");
+      *swap = 0;
+      goto fail;
     default:
       mysnprintf (dst, dstsize, "(unknown encoding)");
       *swap = 0;
@@ -2764,6 +2779,7 @@ void serstate_init (serstate_t st, const struct sertopic * topic)
   st->keyidx = 0;
   st->topic = topic;
   pa_st32 (&st->refcount, 1);
+  pa_stvoidp (&st->compressed, NULL);
   st->kind = STK_DATA; /* key and empty are rare cases and set separately */
   st->twrite.v = -1;
   st->data->v.isstringref = 0;
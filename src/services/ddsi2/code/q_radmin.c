@@ -19,6 +19,7 @@
  */
 #include <ctype.h>
 #include <stddef.h>
+#include <string.h>
 #include <stdarg.h>
 #include <limits.h>
 
@@ -51,6 +52,7 @@
 #include "q_radmin.h"
 #include "q_bitset.h"
 #include "q_thread.h"
+#include "q_stats.h"
 #include "q_globals.h" /* for mattr, cattr */
 
 #include "sysdeps.h"
@@ -298,10 +300,16 @@ struct nn_rbufpool {
      only allocating rmsgs from the rbufs in the pool. Any thread may
      be releasing buffers to the pool as they become empty.
 
-     Currently, we only have maintain a current rbuf, which gets
-     replaced when allocating a new one from it fails. Any rbufs that
-     are released are freed completely if different from the current
-     one.
+     We maintain a current rbuf, which gets replaced when allocating a
+     new one from it fails. The replaced ones are "pinned" until the
+     last rmsg in them is freed, at which point they are either put on
+     a small freelist for reuse (up to config.rbuf_cache of them), or
+     returned to the system.
+
+     A slow reader can cause a large number of rbufs to stay pinned by
+     only a few samples. When the pinned rbufs exceed
+     config.rbuf_copyout_threshold bytes, samples queued for delivery
+     are copied to the heap instead (see DQUEUE).
 
      Could trivially be done lockless, except that it requires
      compare-and-swap, and we don't have that. But it hardly ever
@@ -310,6 +318,18 @@ struct nn_rbufpool {
   struct nn_rbuf *current;
   os_uint32 rbuf_size;
   os_uint32 max_rmsg_size;
+  struct nn_rbuf *freelist;
+  int hugepage_failed;
+  os_size_t hugepage_size;
+  pa_uint32_t n_pinned; /* written with lock held, read anywhere */
+  os_uint32 n_pinned_max;
+  os_uint32 n_live;
+  os_uint32 n_hugepage;
+  os_uint32 n_cached;
+  os_uint64 n_allocated;
+  os_uint64 n_recycled;
+  os_uint64 n_copyout;
+  os_uint64 copyout_bytes;
 #ifndef NDEBUG
   /* Thread that owns this pool, so we can check that no other thread
      is calling functions only the owner may use. */
@@ -318,6 +338,7 @@ struct nn_rbufpool {
 };
 
 static struct nn_rbuf *nn_rbuf_alloc_new (struct nn_rbufpool *rbufpool);
+static void nn_rbuf_free_cached (struct nn_rbufpool *rbufpool);
 static void nn_rbuf_release (struct nn_rbuf *rbuf);
 
 static os_uint32 align8uint32 (os_uint32 x)
@@ -369,6 +390,25 @@ struct nn_rbufpool *nn_rbufpool_new (os_uint32 rbuf_size, os_uint32 max_rmsg_siz
 
   rbp->rbuf_size = rbuf_size;
   rbp->max_rmsg_size = max_rmsg_size;
+  rbp->freelist = NULL;
+  rbp->hugepage_failed = 0;
+  rbp->hugepage_size = 0;
+#if SYSDEPS_HAVE_HUGEPAGES
+  if (config.rbuf_hugepages && (rbp->hugepage_size = get_hugepage_size ()) == 0)
+  {
+    NN_WARNING0 ("receive buffer: huge page size unknown, using ordinary memory\n");
+    rbp->hugepage_failed = 1;
+  }
+#endif
+  pa_st32 (&rbp->n_pinned, 0);
+  rbp->n_pinned_max = 0;
+  rbp->n_live = 0;
+  rbp->n_hugepage = 0;
+  rbp->n_cached = 0;
+  rbp->n_allocated = 0;
+  rbp->n_recycled = 0;
+  rbp->n_copyout = 0;
+  rbp->copyout_bytes = 0;
 
 #if USE_VALGRIND
   VALGRIND_CREATE_MEMPOOL (rbp, 0, 0);
@@ -405,7 +445,14 @@ void nn_rbufpool_free (struct nn_rbufpool *rbp)
      reference counts are all 0, as they should be. */
   ASSERT_RBUFPOOL_OWNER (rbp);
 #endif
+  /* The current rbuf is treated as if it had been replaced, after
+     which it gets freed together with any cached ones */
+  os_mutexLock (&rbp->lock);
+  pa_inc32 (&rbp->n_pinned);
+  os_mutexUnlock (&rbp->lock);
   nn_rbuf_release (rbp->current);
+  assert (pa_ld32 (&rbp->n_pinned) == 0);
+  nn_rbuf_free_cached (rbp);
 #if USE_VALGRIND
   VALGRIND_DESTROY_MEMPOOL (rbp);
 #endif
@@ -413,6 +460,29 @@ void nn_rbufpool_free (struct nn_rbufpool *rbp)
   os_free (rbp);
 }
 
+void nn_rbufpool_getstats (struct nn_rbufpool *rbp, struct nn_rbufpool_stats *st)
+{
+  os_mutexLock (&rbp->lock);
+  st->rbuf_size = rbp->rbuf_size;
+  st->n_live = rbp->n_live;
+  st->n_hugepage = rbp->n_hugepage;
+  st->n_pinned = pa_ld32 (&rbp->n_pinned);
+  st->n_pinned_max = rbp->n_pinned_max;
+  st->n_cached = rbp->n_cached;
+  st->n_allocated = rbp->n_allocated;
+  st->n_recycled = rbp->n_recycled;
+  st->n_copyout = rbp->n_copyout;
+  st->copyout_bytes = rbp->copyout_bytes;
+  os_mutexUnlock (&rbp->lock);
+}
+
+static int nn_rbufpool_under_pressure (struct nn_rbufpool *rbp)
+{
+  /* Racy read, but it is only a heuristic anyway */
+  return (config.rbuf_copyout_threshold > 0 &&
+          (os_uint64) pa_ld32 (&rbp->n_pinned) * rbp->rbuf_size >= config.rbuf_copyout_threshold);
+}
+
 /* RBUF ---------------------------------------------------------------- */
 
 struct nn_rbuf {
@@ -420,6 +490,8 @@ struct nn_rbuf {
   os_uint32 size;
   os_uint32 max_rmsg_size;
   struct nn_rbufpool *rbufpool;
+  struct nn_rbuf *next_free; /* link in rbufpool->freelist */
+  int hugepage;
 
   /* Allocating sequentially, releasing in random order, not bothering
      to reuse memory as soon as it becomes available again. I think
@@ -438,20 +510,94 @@ struct nn_rbuf {
   } u;
 };
 
+static struct nn_rbuf *nn_rbuf_alloc_mem (struct nn_rbufpool *rbufpool)
+{
+  const os_size_t hdrsize = offsetof (struct nn_rbuf, u.raw);
+  struct nn_rbuf *rb;
+#if SYSDEPS_HAVE_HUGEPAGES
+  if (config.rbuf_hugepages && !rbufpool->hugepage_failed)
+  {
+    const os_size_t hpsize = rbufpool->hugepage_size;
+    const os_size_t asize = (hdrsize + rbufpool->rbuf_size + hpsize - 1) & ~(hpsize - 1);
+    void *mem = mmap (NULL, asize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem != MAP_FAILED)
+    {
+      rb = mem;
+      rb->hugepage = 1;
+      rb->size = (os_uint32) (asize - hdrsize);
+      return rb;
+    }
+    /* Don't keep trying if the system has no huge pages available,
+       warn once and revert to ordinary memory */
+    NN_WARNING0 ("receive buffer: no huge pages available, using ordinary memory\n");
+    rbufpool->hugepage_failed = 1;
+  }
+#endif
+  if ((rb = os_malloc (hdrsize + rbufpool->rbuf_size)) == NULL)
+    return NULL;
+  rb->hugepage = 0;
+  rb->size = rbufpool->rbuf_size;
+  return rb;
+}
+
+static void nn_rbuf_free_mem (struct nn_rbuf *rbuf)
+{
+#if SYSDEPS_HAVE_HUGEPAGES
+  if (rbuf->hugepage)
+  {
+    munmap ((void *) rbuf, offsetof (struct nn_rbuf, u.raw) + rbuf->size);
+    return;
+  }
+#endif
+  os_free (rbuf);
+}
+
+static void nn_rbuf_free_cached (struct nn_rbufpool *rbufpool)
+{
+  while (rbufpool->freelist)
+  {
+    struct nn_rbuf *rb = rbufpool->freelist;
+    rbufpool->freelist = rb->next_free;
+    rbufpool->n_cached--;
+    rbufpool->n_live--;
+    if (rb->hugepage)
+      rbufpool->n_hugepage--;
+    nn_rbuf_free_mem (rb);
+  }
+}
+
 static struct nn_rbuf *nn_rbuf_alloc_new (struct nn_rbufpool *rbufpool)
 {
   struct nn_rbuf *rb;
   ASSERT_RBUFPOOL_OWNER (rbufpool);
 
-  if ((rb = os_malloc (offsetof (struct nn_rbuf, u.raw) + rbufpool->rbuf_size)) == NULL)
-    return NULL;
+  os_mutexLock (&rbufpool->lock);
+  if ((rb = rbufpool->freelist) != NULL)
+  {
+    rbufpool->freelist = rb->next_free;
+    rbufpool->n_cached--;
+    rbufpool->n_recycled++;
+  }
+  os_mutexUnlock (&rbufpool->lock);
+
+  if (rb == NULL)
+  {
+    if ((rb = nn_rbuf_alloc_mem (rbufpool)) == NULL)
+      return NULL;
+    os_mutexLock (&rbufpool->lock);
+    rbufpool->n_live++;
+    rbufpool->n_allocated++;
+    if (rb->hugepage)
+      rbufpool->n_hugepage++;
+    os_mutexUnlock (&rbufpool->lock);
+  }
 #if USE_VALGRIND
-  VALGRIND_MAKE_MEM_NOACCESS (rb->u.raw, rbufpool->rbuf_size);
+  VALGRIND_MAKE_MEM_NOACCESS (rb->u.raw, rb->size);
 #endif
 
   rb->rbufpool = rbufpool;
+  rb->next_free = NULL;
   pa_st32 (&rb->n_live_rmsg_chunks, 1);
-  rb->size = rbufpool->rbuf_size;
   rb->max_rmsg_size = rbufpool->max_rmsg_size;
   rb->freeptr = rb->u.raw;
   TRACE_RADMIN (("rbuf_alloc_new(%p) = %p\n", rbufpool, rb));
@@ -465,10 +611,16 @@ static struct nn_rbuf *nn_rbuf_new (struct nn_rbufpool *rbufpool)
   ASSERT_RBUFPOOL_OWNER (rbufpool);
   if ((rb = nn_rbuf_alloc_new (rbufpool)) != NULL)
   {
+    struct nn_rbuf *old;
+    os_uint32 n_pinned;
     os_mutexLock (&rbufpool->lock);
-    nn_rbuf_release (rbufpool->current);
+    old = rbufpool->current;
     rbufpool->current = rb;
+    if ((n_pinned = pa_inc32_nv (&rbufpool->n_pinned)) > rbufpool->n_pinned_max)
+      rbufpool->n_pinned_max = n_pinned;
     os_mutexUnlock (&rbufpool->lock);
+    /* Releasing the old one may require the lock */
+    nn_rbuf_release (old);
   }
   return rb;
 }
@@ -479,8 +631,30 @@ static void nn_rbuf_release (struct nn_rbuf *rbuf)
   TRACE_RADMIN (("rbuf_release(%p) pool %p current %p\n", rbuf, rbp, rbp->current));
   if (pa_dec32_nv (&rbuf->n_live_rmsg_chunks) == 0)
   {
-    TRACE_RADMIN (("rbuf_release(%p) free\n", rbuf));
-    os_free (rbuf);
+    int keep;
+    /* The pool holds a reference to the current rbuf, so this one
+       must have been replaced already */
+    os_mutexLock (&rbp->lock);
+    assert (pa_ld32 (&rbp->n_pinned) > 0);
+    pa_dec32 (&rbp->n_pinned);
+    if ((keep = (rbp->n_cached < config.rbuf_cache)) != 0)
+    {
+      rbuf->next_free = rbp->freelist;
+      rbp->freelist = rbuf;
+      rbp->n_cached++;
+    }
+    else
+    {
+      rbp->n_live--;
+      if (rbuf->hugepage)
+        rbp->n_hugepage--;
+    }
+    os_mutexUnlock (&rbp->lock);
+    if (!keep)
+    {
+      TRACE_RADMIN (("rbuf_release(%p) free\n", rbuf));
+      nn_rbuf_free_mem (rbuf);
+    }
   }
 }
 
@@ -587,6 +761,13 @@ void nn_rmsg_free (struct nn_rmsg *rmsg)
   struct nn_rmsg_chunk *c;
   TRACE_RADMIN (("rmsg_free(%p)\n", rmsg));
   assert (pa_ld32 (&rmsg->refcount) == 0);
+  if (rmsg->chunk.rbuf == NULL)
+  {
+    /* copied out by nn_dqueue_enqueue: a single heap block */
+    assert (rmsg->chunk.next == NULL);
+    os_free (rmsg);
+    return;
+  }
   c = &rmsg->chunk;
   while (c)
   {
@@ -1194,6 +1375,10 @@ static struct nn_rsample *defrag_add_fragment (struct nn_rsample *sample, struct
   /* relatively expensive test: lastfrag, tree must be consistent */
   assert (dfsample->lastfrag == ut_avlFindMax (&rsample_defrag_fragtree_treedef, &dfsample->fragtree));
 
+  /* fragments of the other form of a compressed sample are handled by
+     nn_defrag_rsample */
+  assert (sampleinfo->size == dfsample->sampleinfo->size);
+
   TRACE_RADMIN (("  lastfrag %p [%u..%u)\n",
                  (void *) dfsample->lastfrag,
                  dfsample->lastfrag->min, dfsample->lastfrag->maxp1));
@@ -1385,6 +1570,22 @@ struct nn_rsample *nn_defrag_rsample (struct nn_defrag *defrag, struct nn_rdata
                  (void *) defrag, (void *) rdata, rdata->min, rdata->maxp1, rdata->rmsg,
                  (void *) sampleinfo, sampleinfo->seq, sampleinfo->size,
                  (void *) defrag->max_sample, max_seq));
+  /* A writer sends repairs of a sample in the form (compressed or not)
+     of the first transmission, unless the reader can't accept it, so
+     fragments of the other form are rare but possible. They are
+     recognisable by the sample size; the partially reassembled sample
+     is then discarded and reassembly restarts with the new fragment,
+     as the writer will continue sending this form. */
+  if (max_seq != 0 && sampleinfo->seq <= max_seq &&
+      (sample = (sampleinfo->seq == max_seq) ? defrag->max_sample : ut_avlLookup (&defrag_sampletree_treedef, &defrag->sampletree, &sampleinfo->seq)) != NULL &&
+      sample->u.defrag.sampleinfo->size != sampleinfo->size)
+  {
+    TRACE_RADMIN (("  sample size %u differs from %u, restarting\n", sampleinfo->size, sample->u.defrag.sampleinfo->size));
+    defrag_rsample_drop (defrag, sample, nn_fragchain_adjust_refcount);
+    defrag->max_sample = ut_avlFindMax (&defrag_sampletree_treedef, &defrag->sampletree);
+    max_seq = defrag->max_sample ? defrag->max_sample->u.defrag.seq : 0;
+  }
+
   /* fast path: rdata is part of message with the highest sequence
      number we're currently defragmenting, or is beyond that */
   if (sampleinfo->seq == max_seq)
@@ -1551,10 +1752,10 @@ int nn_defrag_nackmap (struct nn_defrag *defrag, os_int64 seq, os_uint32 maxfrag
          extra to cover everything up to iv->min. */
       ++bound;
     }
-    for (; i < map->bitmap_base + map->numbits && i < bound; i++)
+    if (i < bound)
     {
-      unsigned x = (unsigned) (i - map->bitmap_base);
-      nn_bitset_set (map->numbits, map->bits, x);
+      const os_uint32 end = (bound < map->bitmap_base + map->numbits) ? bound : map->bitmap_base + map->numbits;
+      nn_bitset_set_range (map->numbits, map->bits, i - map->bitmap_base, end - map->bitmap_base);
     }
     /* next sequence of fragments to request retranmsission of starts
        at fragment containing maxp1 (because we don't have that byte
@@ -1563,11 +1764,8 @@ int nn_defrag_nackmap (struct nn_defrag *defrag, os_int64 seq, os_uint32 maxfrag
     iv = ut_avlFindSucc (&rsample_defrag_fragtree_treedef, &s->u.defrag.fragtree, iv);
   }
   /* and set bits for missing fragments beyond the highest interval */
-  for (; i < map->bitmap_base + map->numbits; i++)
-  {
-    unsigned x = (unsigned) (i - map->bitmap_base);
-    nn_bitset_set (map->numbits, map->bits, x);
-  }
+  if (i < map->bitmap_base + map->numbits)
+    nn_bitset_set_range (map->numbits, map->bits, i - map->bitmap_base, map->numbits);
   return (int) map->numbits;
 }
 
@@ -2356,26 +2554,22 @@ unsigned nn_reorder_nackmap (struct nn_reorder *reorder, os_int64 base, os_int64
   if ((iv = ut_avlFindMin (&reorder_sampleivtree_treedef, &reorder->sampleivtree)) != NULL)
     assert (iv->u.reorder.min > base);
   i = base;
+  /* Each gap between successive intervals is a run of missing
+     samples, set those a word at a time */
   while (iv && i < base + map->numbits)
   {
-    for (; i < base + map->numbits && i < iv->u.reorder.min; i++)
+    if (i < iv->u.reorder.min)
     {
-      unsigned x = (unsigned) (i - base);
-      nn_bitset_set (map->numbits, map->bits, x);
+      const os_int64 end = (iv->u.reorder.min < base + map->numbits) ? iv->u.reorder.min : base + map->numbits;
+      nn_bitset_set_range (map->numbits, map->bits, (unsigned) (i - base), (unsigned) (end - base));
     }
     i = iv->u.reorder.maxp1;
     iv = ut_avlFindSucc (&reorder_sampleivtree_treedef, &reorder->sampleivtree, iv);
   }
   if (notail && i < base + map->numbits)
     map->numbits = (unsigned) (i - base);
-  else
-  {
-    for (; i < base + map->numbits; i++)
-    {
-      unsigned x = (unsigned) (i - base);
-      nn_bitset_set (map->numbits, map->bits, x);
-    }
-  }
+  else if (i < base + map->numbits)
+    nn_bitset_set_range (map->numbits, map->bits, (unsigned) (i - base), map->numbits);
   return map->numbits;
 }
 
@@ -2398,6 +2592,13 @@ struct nn_dqueue {
   char *name;
   os_uint32 max_samples;
   pa_uint32_t nof_samples;
+
+  /* Statistics: maximum queue length (protected by lock), number of
+     samples delivered and the time they spent in the queue, measured
+     from reception in ns (both updated only by the dqueue thread) */
+  os_uint32 max_nof_samples;
+  pa_uint32_t n_delivered;
+  struct nn_stat_hist delay_hist;
 };
 
 enum dqueue_elem_kind {
@@ -2445,6 +2646,7 @@ static void *dqueue_thread (struct nn_dqueue *q)
 {
   struct thread_state1 *self = lookup_thread_state ();
   nn_mtime_t next_thread_cputime = { 0 };
+  nn_wctime_t tnow;
   int keepgoing = 1;
   nn_guid_t rdguid, *prdguid = NULL;
   os_uint32 rdguid_count = 0;
@@ -2461,6 +2663,7 @@ static void *dqueue_thread (struct nn_dqueue *q)
     sc = q->sc;
     q->sc.first = q->sc.last = NULL;
     os_mutexUnlock (&q->lock);
+    tnow = now ();
 
     while (sc.first)
     {
@@ -2472,6 +2675,8 @@ static void *dqueue_thread (struct nn_dqueue *q)
       switch (dqueue_elem_kind (e))
       {
         case DQEK_DATA:
+          nn_stat_hist_add (&q->delay_hist, tnow.v - e->sampleinfo->reception_timestamp.v);
+          pa_inc32 (&q->n_delivered);
           ret = q->handler (e->sampleinfo, e->fragchain, prdguid, q->handler_arg);
           (void) ret; /* eliminate set-but-not-used in NDEBUG case */
           assert (ret == 0); /* so every handler will return 0 */
@@ -2538,6 +2743,9 @@ struct nn_dqueue *nn_dqueue_new (const char *name, os_uint32 max_samples, nn_dqu
     goto fail_name;
   q->max_samples = max_samples;
   pa_st32 (&q->nof_samples, 0);
+  q->max_nof_samples = 0;
+  pa_st32 (&q->n_delivered, 0);
+  nn_stat_hist_init (&q->delay_hist);
   q->handler = handler;
   q->handler_arg = arg;
   q->sc.first = q->sc.last = NULL;
@@ -2570,6 +2778,142 @@ struct nn_dqueue *nn_dqueue_new (const char *name, os_uint32 max_samples, nn_dqu
   return NULL;
 }
 
+/* Copying a sample out of the receive buffers, to be used when the
+   receive buffer pool is under pressure because rbufs get pinned by
+   samples waiting for delivery. The copy is a single heap block
+   formatted as an rmsg with a NULL rbuf, holding the submessage
+   header (up to the payload) followed by the defragmented payload,
+   and then the rdata, sample info, receiver state and chain element
+   referencing it. Everything the delivery handlers need is at the
+   same offsets relative to the submessage header, so they can't tell
+   the difference. */
+struct nn_rmsg_copyout {
+  struct nn_rdata rdata;
+  struct nn_rsample_info sampleinfo;
+  struct receiver_state rst;
+  struct nn_rsample_chain_elem sce;
+};
+
+static struct nn_rsample_chain_elem *nn_rsample_copyout (const struct nn_rsample_chain_elem *e)
+{
+  const struct nn_rdata *frag = e->fragchain;
+  const os_uint32 submsg_off = NN_RDATA_SUBMSG_OFF (frag);
+  const os_uint32 hdrsize = NN_RDATA_PAYLOAD_OFF (frag) - submsg_off;
+  const os_uint32 size = e->sampleinfo->size;
+  const os_uint32 payloadsize = align8uint32 (hdrsize + size);
+  struct nn_rmsg_copyout *cp;
+  struct nn_rmsg *rmsg;
+  unsigned char *dst;
+  os_uint32 off = 0;
+
+  assert (frag->min == 0);
+  assert (NN_RDATA_PAYLOAD_OFF (frag) >= submsg_off);
+  if ((rmsg = os_malloc (offsetof (struct nn_rmsg, chunk.u.payload) + payloadsize + sizeof (*cp))) == NULL)
+    return NULL;
+  pa_st32 (&rmsg->refcount, 1);
+  rmsg->lastchunk = &rmsg->chunk;
+  rmsg->chunk.rbuf = NULL;
+  rmsg->chunk.next = NULL;
+  rmsg->chunk.size = payloadsize;
+
+  dst = NN_RMSG_PAYLOAD (rmsg);
+  memcpy (dst, NN_RMSG_PAYLOADOFF (frag->rmsg, submsg_off), hdrsize);
+  dst += hdrsize;
+  while (frag)
+  {
+    /* same logic as the defragmenting in the delivery path:
+       overlapping fragments are possible */
+    if (frag->maxp1 > off)
+    {
+      memcpy (dst + off, NN_RMSG_PAYLOADOFF (frag->rmsg, NN_RDATA_PAYLOAD_OFF (frag)) + off - frag->min, frag->maxp1 - off);
+      off = frag->maxp1;
+    }
+    frag = frag->nextfrag;
+  }
+  assert (off == size);
+
+  cp = (struct nn_rmsg_copyout *) (NN_RMSG_PAYLOAD (rmsg) + payloadsize);
+  cp->rdata.rmsg = rmsg;
+  cp->rdata.nextfrag = NULL;
+  cp->rdata.min = 0;
+  cp->rdata.maxp1 = size;
+  cp->rdata.submsg_zoff = (os_ushort) NN_OFF_TO_ZOFF (0);
+  cp->rdata.payload_zoff = (os_ushort) NN_OFF_TO_ZOFF (hdrsize);
+#ifndef NDEBUG
+  pa_st32 (&cp->rdata.refcount_bias_added, 0);
+#endif
+  cp->sampleinfo = *e->sampleinfo;
+  cp->rst = *e->sampleinfo->rst;
+  cp->sampleinfo.rst = &cp->rst;
+  if (NN_SAMPLEINFO_HAS_WRINFO (&cp->sampleinfo))
+    cp->sampleinfo.pt_wr_info_zoff = (unsigned short) NN_OFF_TO_ZOFF (NN_SAMPLEINFO_WRINFO_OFF (e->sampleinfo) - submsg_off);
+  cp->sce.fragchain = &cp->rdata;
+  cp->sce.sampleinfo = &cp->sampleinfo;
+  cp->sce.next = NULL;
+  TRACE_RADMIN (("rsample_copyout(%p) = %p\n", (void *) e, (void *) &cp->sce));
+  return &cp->sce;
+}
+
+static void nn_dqueue_maybe_copyout (struct nn_rsample_chain *sc)
+{
+  /* Only the receive thread owning the rbufs in the chain enqueues
+     data (other than bubbles), so nothing else can touch the chain
+     yet. The chain holds one reference to each fragment of a sample;
+     that reference is dropped only after the sample has been copied,
+     and e (which lives in the rmsg) is not touched after that, because
+     the unref may free the rmsg. For the sample of the message being
+     processed the rmsg still carries RMSG_REFCOUNT_RDATA_BIAS until
+     nn_fragchain_adjust_refcount, so other chains referencing it (e.g.
+     of out-of-sync readers) remain valid.
+
+     Gaps are never copied: they are small and don't stay around for
+     long anyway. */
+  struct nn_rsample_chain_elem *e, **prev;
+  struct nn_rbufpool *rbp = NULL;
+  os_uint32 n = 0, nbytes = 0;
+  for (prev = &sc->first, e = sc->first; e != NULL; e = e->next)
+  {
+    struct nn_rsample_chain_elem *ecp;
+    struct nn_rbuf *rbuf;
+    if (e->sampleinfo == NULL || (rbuf = e->fragchain->rmsg->chunk.rbuf) == NULL)
+    {
+      prev = &e->next;
+      continue;
+    }
+    if (rbp == NULL)
+    {
+      rbp = rbuf->rbufpool;
+      if (!nn_rbufpool_under_pressure (rbp))
+        return;
+    }
+    if ((ecp = nn_rsample_copyout (e)) == NULL)
+      break;
+    ecp->next = e->next;
+    *prev = ecp;
+    prev = &ecp->next;
+    if (sc->last == e)
+      sc->last = ecp;
+    n++;
+    nbytes += ecp->sampleinfo->size;
+    /* e is no longer used after this, the copy has taken its place */
+    nn_fragchain_unref (e->fragchain);
+    e = ecp;
+  }
+  if (n > 0)
+  {
+    os_mutexLock (&rbp->lock);
+    rbp->n_copyout += n;
+    rbp->copyout_bytes += nbytes;
+    os_mutexUnlock (&rbp->lock);
+  }
+}
+
+static void nn_dqueue_note_length (struct nn_dqueue *q, os_uint32 n)
+{
+  if (n > q->max_nof_samples)
+    q->max_nof_samples = n;
+}
+
 static int nn_dqueue_enqueue_locked (struct nn_dqueue *q, struct nn_rsample_chain *sc)
 {
   int must_signal;
@@ -2592,8 +2936,9 @@ void nn_dqueue_enqueue (struct nn_dqueue *q, struct nn_rsample_chain *sc, nn_reo
   assert (rres > 0);
   assert (sc->first);
   assert (sc->last->next == NULL);
+  nn_dqueue_maybe_copyout (sc);
   os_mutexLock (&q->lock);
-  pa_add32 (&q->nof_samples, (os_uint32) rres);
+  nn_dqueue_note_length (q, pa_add32_nv (&q->nof_samples, (os_uint32) rres));
   if (nn_dqueue_enqueue_locked (q, sc))
     os_condSignal (&q->cond);
   os_mutexUnlock (&q->lock);
@@ -2641,14 +2986,26 @@ void nn_dqueue_enqueue1 (struct nn_dqueue *q, const nn_guid_t *rdguid, struct nn
   assert (rdguid != NULL);
   assert (sc->first);
   assert (sc->last->next == NULL);
+  nn_dqueue_maybe_copyout (sc);
   os_mutexLock (&q->lock);
-  pa_add32 (&q->nof_samples, 1 + (os_uint32) rres);
+  nn_dqueue_note_length (q, pa_add32_nv (&q->nof_samples, 1 + (os_uint32) rres));
   if (nn_dqueue_enqueue_bubble_locked (q, b))
     os_condSignal (&q->cond);
   nn_dqueue_enqueue_locked (q, sc);
   os_mutexUnlock (&q->lock);
 }
 
+void nn_dqueue_getstats (struct nn_dqueue *q, struct nn_dqueue_stats *st)
+{
+  os_mutexLock (&q->lock);
+  st->name = q->name;
+  st->nof_samples = pa_ld32 (&q->nof_samples);
+  st->max_nof_samples = q->max_nof_samples;
+  st->n_delivered = pa_ld32 (&q->n_delivered);
+  st->delay_hist = &q->delay_hist;
+  os_mutexUnlock (&q->lock);
+}
+
 int nn_dqueue_is_full (struct nn_dqueue *q)
 {
   /* Reading nof_samples exactly once. It IS a 32-bit int, so at
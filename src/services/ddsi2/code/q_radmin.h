@@ -43,11 +43,14 @@ struct nn_guid;
 struct proxy_writer;
 
 struct nn_fragment_number_set;
+struct nn_stat_hist;
 struct nn_sequence_number_set;
 
 typedef int (*nn_dqueue_handler_t) (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const struct nn_guid *rdguid, void *qarg);
 
 struct nn_rmsg_chunk {
+  /* rbuf is NULL for an rmsg copied out of the receive buffers to
+     heap memory by the delivery queue (see nn_dqueue_enqueue) */
   struct nn_rbuf *rbuf;
   struct nn_rmsg_chunk *next;
 
@@ -202,9 +205,31 @@ typedef os_int32 nn_reorder_result_t;
 
 typedef void (*nn_dqueue_callback_t) (void *arg);
 
+struct nn_rbufpool_stats {
+  os_uint32 rbuf_size;          /* configured size of an rbuf */
+  os_uint32 n_live;             /* rbufs allocated: current + pinned + cached */
+  os_uint32 n_hugepage;         /* of which backed by huge pages */
+  os_uint32 n_pinned;           /* replaced rbufs still referenced by samples */
+  os_uint32 n_pinned_max;       /* high-water mark of n_pinned */
+  os_uint32 n_cached;           /* drained rbufs retained for reuse */
+  os_uint64 n_allocated;        /* number of rbufs allocated from the system */
+  os_uint64 n_recycled;         /* number of rbufs taken from the cache */
+  os_uint64 n_copyout;          /* number of samples copied out of rbufs */
+  os_uint64 copyout_bytes;      /* bytes copied for those samples */
+};
+
+struct nn_dqueue_stats {
+  const char *name;
+  os_uint32 nof_samples;        /* current queue length */
+  os_uint32 max_nof_samples;    /* maximum queue length */
+  os_uint32 n_delivered;        /* number of samples delivered */
+  const struct nn_stat_hist *delay_hist; /* time from reception to delivery (ns) */
+};
+
 struct nn_rbufpool *nn_rbufpool_new (os_uint32 rbuf_size, os_uint32 max_rmsg_size);
 void nn_rbufpool_setowner (struct nn_rbufpool *rbp, os_threadId tid);
 void nn_rbufpool_free (struct nn_rbufpool *rbp);
+void nn_rbufpool_getstats (struct nn_rbufpool *rbp, struct nn_rbufpool_stats *st);
 
 struct nn_rmsg *nn_rmsg_new (struct nn_rbufpool *rbufpool);
 void nn_rmsg_setsize (struct nn_rmsg *rmsg, os_uint32 size);
@@ -239,6 +264,7 @@ void nn_dqueue_enqueue (struct nn_dqueue *q, struct nn_rsample_chain *sc, nn_reo
 void nn_dqueue_enqueue1 (struct nn_dqueue *q, const nn_guid_t *rdguid, struct nn_rsample_chain *sc, nn_reorder_result_t rres);
 void nn_dqueue_enqueue_callback (struct nn_dqueue *q, nn_dqueue_callback_t cb, void *arg);
 int  nn_dqueue_is_full (struct nn_dqueue *q);
+void nn_dqueue_getstats (struct nn_dqueue *q, struct nn_dqueue_stats *st);
 
 #if defined (__cplusplus)
 }
@@ -69,6 +69,8 @@
 #include "q_transmit.h"
 #include "q_globals.h"
 #include "q_static_assert.h"
+#include "q_btrace.h"
+#include "q_compress.h"
 
 #include "sysdeps.h"
 
@@ -444,6 +446,14 @@ static int valid_Data (const struct receiver_state *rst, struct nn_rmsg *rmsg, D
         sampleinfo->bswap = PLATFORM_IS_LITTLE_ENDIAN ? 0 : 1;
         break;
       }
+      case CDR_COMPRESSED:
+      {
+        /* encoding of the original is inside the compressed data */
+        if (config.test_no_compression)
+          return 0;
+        sampleinfo->bswap = 0;
+        break;
+      }
       default:
         return 0;
     }
@@ -583,6 +593,14 @@ static int valid_DataFrag (const struct receiver_state *rst, struct nn_rmsg *rms
         sampleinfo->bswap = PLATFORM_IS_LITTLE_ENDIAN ? 0 : 1;
         break;
       }
+      case CDR_COMPRESSED:
+      {
+        /* encoding of the original is inside the compressed data */
+        if (config.test_no_compression)
+          return 0;
+        sampleinfo->bswap = 0;
+        break;
+      }
       default:
         return 0;
     }
@@ -668,20 +686,33 @@ static os_int64 grow_gap_to_next_seq (const struct writer *wr, os_int64 seq)
 
 static int acknack_is_nack (const AckNack_t *msg)
 {
-  unsigned x = 0, mask;
-  int i;
-  if (msg->readerSNState.numbits == 0)
-    /* Disallowed by the spec, but RTI appears to require them (and so
-       even we generate them) */
-    return 0;
-  for (i = 0; i < (int) NN_SEQUENCE_NUMBER_SET_BITS_SIZE (msg->readerSNState.numbits) / 4 - 1; i++)
-    x |= msg->readerSNState.bits[i];
-  if ((msg->readerSNState.numbits % 32) == 0)
-    mask = ~0u;
-  else
-    mask = ~(~0u >> (msg->readerSNState.numbits % 32));
-  x |= msg->readerSNState.bits[i] & mask;
-  return x != 0;
+  /* numbits = 0 is disallowed by the spec, but RTI appears to require
+     them (and so even we generate them) */
+  return nn_bitset_find_set (msg->readerSNState.numbits, msg->readerSNState.bits, 0) < msg->readerSNState.numbits;
+}
+
+static void nackmap_next_run (const struct nn_sequence_number_set *set, unsigned numbits, unsigned idx, unsigned *lo, unsigned *hi)
+{
+  /* Locates the first run [*lo,*hi) of NACK'd sequence numbers
+     (relative to the bitmap base) at or after idx, with *lo = *hi =
+     numbits if there is none.  An accelerated schedule may run ahead
+     of the set contained in the acknack (numbits > set->numbits), and
+     assumes all messages beyond the set are NACK'd -- don't feel like
+     tracking where exactly we left off ... */
+  if (idx < set->numbits)
+  {
+    *lo = nn_bitset_find_set (set->numbits, set->bits, idx);
+    if (*lo < set->numbits)
+    {
+      *hi = nn_bitset_find_clear (set->numbits, set->bits, *lo);
+      if (*hi == set->numbits && numbits > set->numbits)
+        *hi = numbits;
+      return;
+    }
+    idx = set->numbits;
+  }
+  *lo = (idx < numbits) ? idx : numbits;
+  *hi = numbits;
 }
 
 static int accept_ack_or_hb_w_timeout (nn_count_t new_count, nn_count_t *exp_count, nn_etime_t tnow, nn_etime_t *t_last_accepted, int force_accept)
@@ -792,6 +823,7 @@ static int handle_AckNack (struct receiver_state *rst, nn_etime_t tnow, const Ac
   is_preemptive_ack = seqbase <= 1 && is_pure_ack;
 
   wr->num_acks_received++;
+  NN_BTRACE (NN_BTE_RECV_ACKNACK, &wr->e.guid, seqbase, msg->readerSNState.numbits);
   if (!is_pure_ack)
   {
     wr->num_nacks_received++;
@@ -946,76 +978,99 @@ static int handle_AckNack (struct receiver_state *rst, nn_etime_t tnow, const Ac
      that issue; if it has, then the timing is terribly unlucky, but
      a future request'll fix it. */
   enqueued = 1;
-  for (i = 0; i < numbits && seqbase + i <= wr->seq_xmit && enqueued; i++)
-  {
-    /* Accelerated schedule may run ahead of sequence number set
-       contained in the acknack, and assumes all messages beyond the
-       set are NACK'd -- don't feel like tracking where exactly we
-       left off ... */
-    if (i >= msg->readerSNState.numbits || nn_bitset_isset (numbits, msg->readerSNState.bits, i))
-    {
-      os_int64 seq = seqbase + i;
-      struct whc_node *whcn;
-      if ((whcn = whc_findseq (wr->whc, seq)) != NULL)
+  if (seqbase <= wr->seq_xmit)
+  {
+    /* Retransmit requests are handled as runs of consecutive NACK'd
+       sequence numbers, located by scanning the bitmap a word at a
+       time.  Within a run, successive samples are nearly always
+       adjacent in the WHC as well, so we follow the WHC links rather
+       than looking up every sequence number.  The messages for all
+       samples in a run are collected in a batch first and queued with
+       a single acquisition of the event queue lock, so the event
+       thread finds them back-to-back and packs them into as few
+       packets as possible.  A sample counts as retransmitted only if
+       all of its messages were queued. */
+    const unsigned limit = (wr->seq_xmit - seqbase + 1 < (os_int64) numbits) ? (unsigned) (wr->seq_xmit - seqbase + 1) : numbits;
+    const nn_mtime_t tstamp = now_mt ();
+    const int merge = (config.retransmit_merging != REXMIT_MERGE_NEVER && rn->assumed_in_sync);
+    struct qxev_rexmit_batch batch;
+    struct whc_node *runwhcn[256]; /* samples of the current run in batch */
+    unsigned runend[256]; /* batch.n after adding runwhcn[k] */
+    qxev_rexmit_batch_init (&batch);
+    i = 0;
+    while (i < limit && enqueued)
+    {
+      struct whc_node *whcn = NULL;
+      unsigned lo, hi, nrun = 0, nqueued, k;
+      nackmap_next_run (&msg->readerSNState, numbits, i, &lo, &hi);
+      if (hi > limit)
+        hi = limit;
+      for (i = lo; i < hi; i++)
       {
-        if (!wr->retransmitting && whcn->unacked)
-          writer_set_retransmitting (wr);
-
-        if (config.retransmit_merging != REXMIT_MERGE_NEVER && rn->assumed_in_sync)
+        os_int64 seq = seqbase + i;
+        if (whcn != NULL && whcn->next_seq != NULL && whcn->next_seq->seq == seq)
+          whcn = whcn->next_seq;
+        else
+          whcn = whc_findseq (wr->whc, seq);
+        if (whcn != NULL)
         {
-          /* send retransmit to all receivers, but skip if recently done */
-          nn_mtime_t tstamp = now_mt ();
-          if (tstamp.v > whcn->last_rexmit_ts.v + config.retransmit_merging_period)
+          if (!wr->retransmitting && whcn->unacked)
+            writer_set_retransmitting (wr);
+
+          if (merge && tstamp.v <= whcn->last_rexmit_ts.v + config.retransmit_merging_period)
           {
-            TRACE ((" RX%"PA_PRId64, seqbase + i));
-            enqueued = (enqueue_sample_wrlock_held (wr, seq, whcn->plist, whcn->serdata, NULL, 0) >= 0);
-            if (enqueued)
-            {
-              max_seq_in_reply = seqbase + i;
-              msgs_sent++;
-              whcn->last_rexmit_ts = tstamp;
-            }
+            /* sent to all receivers recently enough */
+            TRACE ((" RX%"PA_PRId64" (merged)", seqbase + i));
           }
           else
           {
-            TRACE ((" RX%"PA_PRId64" (merged)", seqbase + i));
+            /* with merging, send retransmit to all receivers, else a
+               directed one */
+            struct proxy_reader * const dst = merge ? NULL : prd;
+            TRACE ((" RX%"PA_PRId64, seqbase + i));
+            batch_rexmit_sample_wrlock_held (&batch, wr, seq, whcn->plist, whcn->serdata, dst, nn_compress_wanted_repair (wr, dst, whcn->compressed));
+            runwhcn[nrun] = whcn;
+            runend[nrun++] = batch.n;
           }
         }
-        else
+        else if (gapstart == -1)
         {
-          /* no merging, send directed retransmit */
-          TRACE ((" RX%"PA_PRId64"", seqbase + i));
-          enqueued = (enqueue_sample_wrlock_held (wr, seq, whcn->plist, whcn->serdata, prd, 0) >= 0);
-          if (enqueued)
-          {
-            max_seq_in_reply = seqbase + i;
-            msgs_sent++;
-            whcn->rexmit_count++;
-          }
+          TRACE ((" M%"PA_PRId64, seqbase + i));
+          gapstart = seqbase + i;
+          gapend = gapstart + 1;
+          msgs_lost++;
+        }
+        else if (seqbase + i == gapend)
+        {
+          TRACE ((" M%"PA_PRId64, seqbase + i));
+          gapend = seqbase + i + 1;
+          msgs_lost++;
+        }
+        else if (seqbase + i - gapend < 256)
+        {
+          unsigned idx = (unsigned) (seqbase + i - gapend);
+          TRACE ((" M%"PA_PRId64, seqbase + i));
+          gapnumbits = idx + 1;
+          nn_bitset_set (gapnumbits, gapbits, idx);
+          msgs_lost++;
         }
       }
-      else if (gapstart == -1)
-      {
-        TRACE ((" M%"PA_PRId64, seqbase + i));
-        gapstart = seqbase + i;
-        gapend = gapstart + 1;
-        msgs_lost++;
-      }
-      else if (seqbase + i == gapend)
-      {
-        TRACE ((" M%"PA_PRId64, seqbase + i));
-        gapend = seqbase + i + 1;
-        msgs_lost++;
-      }
-      else if (seqbase + i - gapend < 256)
+
+      nqueued = qxev_msgs_rexmit_wrlock_held (wr->evq, &batch, 0);
+      for (k = 0; k < nrun && runend[k] <= nqueued; k++)
       {
-        unsigned idx = (unsigned) (seqbase + i - gapend);
-        TRACE ((" M%"PA_PRId64, seqbase + i));
-        gapnumbits = idx + 1;
-        nn_bitset_set (gapnumbits, gapbits, idx);
-        msgs_lost++;
+        max_seq_in_reply = runwhcn[k]->seq;
+        msgs_sent++;
+        if (merge)
+          runwhcn[k]->last_rexmit_ts = tstamp;
+        else
+          runwhcn[k]->rexmit_count++;
+        NN_BTRACE (NN_BTE_REXMIT, &wr->e.guid, runwhcn[k]->seq, ~0u);
       }
+      if (k < nrun)
+        enqueued = 0;
     }
+    qxev_rexmit_batch_fini (&batch);
   }
   if (!enqueued)
     TRACE ((" rexmit-limit-hit"));
@@ -1247,6 +1302,8 @@ static int handle_Heartbeat (struct receiver_state *rst, nn_etime_t tnow, struct
 
   os_mutexLock (&pwr->e.lock);
 
+  pwr->num_heartbeats_received++;
+  NN_BTRACE (NN_BTE_RECV_HEARTBEAT, &pwr->e.guid, fromSN (msg->lastSN), (os_uint32) msg->count);
   pwr->have_seen_heartbeat = 1;
   if (fromSN (msg->lastSN) > pwr->last_seq)
   {
@@ -1523,19 +1580,24 @@ static int handle_NackFrag (struct receiver_state *rst, nn_etime_t tnow, const N
   else
   {
     const unsigned base = msg->fragmentNumberState.bitmap_base - 1;
-    int enqueued = 1;
+    /* fragment numbers refer to the form of the first transmission */
+    serdata_t txdata = nn_compress_wanted_repair (wr, prd, whcn->compressed) ? nn_compress_form (whcn->serdata) : whcn->serdata;
+    struct qxev_rexmit_batch batch;
     TRACE ((" scheduling requested frags ...\n"));
-    for (i = 0; i < msg->fragmentNumberState.numbits && enqueued; i++)
+    qxev_rexmit_batch_init (&batch);
+    for (i = 0; i < msg->fragmentNumberState.numbits; i++)
     {
       if (nn_bitset_isset (msg->fragmentNumberState.numbits, msg->fragmentNumberState.bits, i))
       {
         struct nn_xmsg *reply;
-        if (create_fragment_message (wr, seq, whcn->plist, whcn->serdata, base + i, prd, &reply, 0) < 0)
-          enqueued = 0;
-        else
-          enqueued = qxev_msg_rexmit_wrlock_held (wr->evq, reply, 0);
+        if (create_fragment_message (wr, seq, whcn->plist, txdata, base + i, prd, &reply, 0) < 0)
+          break;
+        else if (reply)
+          qxev_rexmit_batch_add (&batch, reply, NULL);
       }
     }
+    (void) qxev_msgs_rexmit_wrlock_held (wr->evq, &batch, 0);
+    qxev_rexmit_batch_fini (&batch);
   }
   if (seq < wr->seq_xmit)
   {
@@ -1722,6 +1784,8 @@ static int handle_Gap (struct receiver_state *rst, nn_etime_t tnow, struct nn_rm
     lease_renew (pa_ldvoidp (&pwr->c.proxypp->lease), tnow);
 
   os_mutexLock (&pwr->e.lock);
+  pwr->num_gaps_received++;
+  NN_BTRACE (NN_BTE_RECV_GAP, &pwr->e.guid, gapstart, (os_uint32) (listbase - gapstart));
   if ((wn = ut_avlLookup (&pwr_readers_treedef, &pwr->readers, &dst)) == NULL)
   {
     TRACE (("%x:%x:%x:%x -> %x:%x:%x:%x not a connection)", PGUID (src), PGUID (dst)));
@@ -2275,6 +2339,8 @@ static int deliver_user_data (const struct nn_rsample_info *sampleinfo, const st
   v_message payload;
   nn_prismtech_writer_info_t wri;
 
+  NN_BTRACE (NN_BTE_DELIVER, &pwr->e.guid, sampleinfo->seq, 0);
+
   /* NOTE: pwr->e.lock need not be held for correct processing (though
      it may be useful to hold it for maintaining order all the way to
      v_groupWrite): guid is constant, set_vmsg_header() explains about
@@ -2531,6 +2597,7 @@ static void handle_regular (struct receiver_state *rst, nn_etime_t tnow, struct
     pwr->last_fragnum_reset = 0;
   }
 
+  NN_BTRACE (NN_BTE_RECV_DATA, &pwr->e.guid, sampleinfo->seq, fragnum);
   clean_defrag (pwr);
 
   if ((rsample = nn_defrag_rsample (pwr->defrag, rdata, sampleinfo)) != NULL)
@@ -2540,6 +2607,11 @@ static void handle_regular (struct receiver_state *rst, nn_etime_t tnow, struct
     struct nn_rdata *fragchain = nn_rsample_fragchain (rsample);
     nn_reorder_result_t rres;
 
+    pwr->num_samples_received++;
+    pwr->num_bytes_received += sampleinfo->size;
+    if (valid_ddsi_timestamp (sampleinfo->timestamp))
+      nn_stat_hist_add (&pwr->latency_hist, sampleinfo->reception_timestamp.v - nn_wctime_from_ddsi_time (sampleinfo->timestamp).v);
+
     rres = nn_reorder_rsample (&sc, pwr->reorder, rsample, &refc_adjust, nn_dqueue_is_full (pwr->dqueue));
 
     if (rres == NN_REORDER_ACCEPT && pwr->n_reliable_readers == 0)
@@ -3514,6 +3586,22 @@ void * listen_thread (struct ddsi_tran_listener * listener)
   return NULL;
 }
 
+void * shm_recv_thread (struct nn_rbufpool * rbpool)
+{
+  /* Reading from gv.shm_conn blocks until a datagram arrives or
+     rtps_term_prep unblocks it */
+  struct thread_state1 *self = lookup_thread_state ();
+  nn_mtime_t next_thread_cputime = { 0 };
+
+  nn_rbufpool_setowner (rbpool, os_threadIdSelf ());
+  while (gv.rtps_keepgoing)
+  {
+    LOG_THREAD_CPUTIME (next_thread_cputime);
+    (void) do_packet (self, gv.shm_conn, NULL, rbpool);
+  }
+  return NULL;
+}
+
 void * recv_thread (struct nn_rbufpool * rbpool)
 {
   struct thread_state1 *self = lookup_thread_state ();
@@ -3583,6 +3671,13 @@ void * recv_thread (struct nn_rbufpool * rbpool)
           ret = do_packet (self, conn, &lps.ps[(unsigned)idx - num_fixed].guid_prefix, rbpool);
         }
 
+        /* Stream connections may have read more than one message */
+
+        while (ret && conn->m_stream && ddsi_conn_buffered (conn))
+        {
+          ret = do_packet (self, conn, NULL, rbpool);
+        }
+
         /* Clean out connection if failed or closed */
 
         if (! ret && ! conn->m_connless)
@@ -31,6 +31,7 @@ struct ddsi_tran_listener;
 
 void *recv_thread (struct nn_rbufpool *rbpool);
 void *listen_thread (struct ddsi_tran_listener * listener);
+void *shm_recv_thread (struct nn_rbufpool *rbpool);
 int user_dqueue_handler (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const nn_guid_t *rdguid, void *qarg);
 
 #if defined (__cplusplus)
@@ -0,0 +1,107 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include <assert.h>
+
+#include "os_defs.h"
+#include "os_atomics.h"
+
+#include "q_stats.h"
+
+static unsigned nn_stat_hist_msb (os_uint64 v)
+{
+  /* v != 0 */
+#if defined (__GNUC__)
+  return 63u - (unsigned) __builtin_clzll (v);
+#else
+  unsigned n = 0;
+  while (v >>= 1)
+    n++;
+  return n;
+#endif
+}
+
+static unsigned nn_stat_hist_index (os_int64 v)
+{
+  const unsigned sub = NN_STAT_HIST_SUBBITS;
+  unsigned e;
+  if (v < (1 << sub))
+    return (v < 0) ? 0 : (unsigned) v;
+  if ((e = nn_stat_hist_msb ((os_uint64) v)) >= NN_STAT_HIST_MAXBITS)
+    return NN_STAT_HIST_NBUCKETS - 1;
+  return ((e - sub + 1) << sub) | ((unsigned) ((os_uint64) v >> (e - sub)) & ((1u << sub) - 1));
+}
+
+os_int64 nn_stat_hist_bucket_min (unsigned idx)
+{
+  const unsigned sub = NN_STAT_HIST_SUBBITS;
+  assert (idx < NN_STAT_HIST_NBUCKETS);
+  if (idx < (1u << sub))
+    return (os_int64) idx;
+  else
+  {
+    const unsigned e = (idx >> sub) - 1 + sub;
+    const os_uint64 m = (1u << sub) | (idx & ((1u << sub) - 1));
+    return (os_int64) (m << (e - sub));
+  }
+}
+
+void nn_stat_hist_init (struct nn_stat_hist *h)
+{
+  unsigned i;
+  for (i = 0; i < NN_STAT_HIST_NBUCKETS; i++)
+    pa_st32 (&h->bucket[i], 0);
+}
+
+void nn_stat_hist_add (struct nn_stat_hist *h, os_int64 v)
+{
+  pa_inc32 (&h->bucket[nn_stat_hist_index (v)]);
+}
+
+os_uint32 nn_stat_hist_count (const struct nn_stat_hist *h)
+{
+  os_uint32 n = 0;
+  unsigned i;
+  for (i = 0; i < NN_STAT_HIST_NBUCKETS; i++)
+    n += pa_ld32 (&h->bucket[i]);
+  return n;
+}
+
+os_int64 nn_stat_hist_percentile (const struct nn_stat_hist *h, unsigned pct)
+{
+  /* Returns the upper bound of the bucket containing the requested
+     percentile, or 0 if the histogram is empty; the last bucket being
+     unbounded, it returns its lower bound instead. */
+  os_uint32 n = nn_stat_hist_count (h), acc = 0, lim;
+  unsigned i;
+  assert (pct <= 100);
+  if (n == 0)
+    return 0;
+  lim = (os_uint32) (((os_uint64) n * pct + 99) / 100);
+  if (lim == 0)
+    lim = 1;
+  for (i = 0; i < NN_STAT_HIST_NBUCKETS - 1; i++)
+  {
+    if ((acc += pa_ld32 (&h->bucket[i])) >= lim)
+      return nn_stat_hist_bucket_min (i + 1) - 1;
+  }
+  return nn_stat_hist_bucket_min (NN_STAT_HIST_NBUCKETS - 1);
+}
+
+/* SHA1 not available (unoffical build.) */
@@ -0,0 +1,61 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#ifndef NN_STATS_H
+#define NN_STATS_H
+
+#include "os_defs.h"
+#include "os_atomics.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* Log-linear ("HDR-style") histogram for non-negative values, usually
+   durations in ns: values below 2**NN_STAT_HIST_SUBBITS each have a
+   bucket of their own, larger ones are grouped by their most
+   significant bit and the NN_STAT_HIST_SUBBITS bits following it, so
+   the relative error is at most 2**-NN_STAT_HIST_SUBBITS. Values of
+   2**NN_STAT_HIST_MAXBITS (about 18 minutes in ns) or more all end up
+   in the last bucket, negative values in the first.
+
+   Buckets are updated atomically, so recording never requires a lock
+   and they can be read at any time, at the cost of a dump not being
+   an exact snapshot. */
+#define NN_STAT_HIST_SUBBITS 2
+#define NN_STAT_HIST_MAXBITS 40
+#define NN_STAT_HIST_NBUCKETS ((NN_STAT_HIST_MAXBITS - NN_STAT_HIST_SUBBITS + 1) << NN_STAT_HIST_SUBBITS)
+
+struct nn_stat_hist {
+  pa_uint32_t bucket[NN_STAT_HIST_NBUCKETS];
+};
+
+void nn_stat_hist_init (struct nn_stat_hist *h);
+void nn_stat_hist_add (struct nn_stat_hist *h, os_int64 v);
+os_uint32 nn_stat_hist_count (const struct nn_stat_hist *h);
+os_int64 nn_stat_hist_bucket_min (unsigned idx);
+os_int64 nn_stat_hist_percentile (const struct nn_stat_hist *h, unsigned pct);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* NN_STATS_H */
+
+/* SHA1 not available (unoffical build.) */
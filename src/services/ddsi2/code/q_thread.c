@@ -29,6 +29,7 @@
 #include "q_log.h"
 #include "q_config.h"
 #include "q_globals.h"
+#include "q_btrace.h"
 #include "sysdeps.h"
 
 #include "u_service.h"
@@ -80,6 +81,7 @@ void thread_states_init (unsigned maxthreads)
     thread_states.ts[i].vtime = 1;
     thread_states.ts[i].watchdog = 1;
     thread_states.ts[i].lb = NULL;
+    thread_states.ts[i].btr = NULL;
     thread_states.ts[i].name = NULL;
   }
 }
@@ -256,12 +258,14 @@ struct thread_state1 *create_thread (const char *name, void * (*f) (void *arg),
 
 static void reap_thread_state (struct thread_state1 *ts1, int sync_with_servicelease)
 {
+  nn_btrace_thread_exit (ts1);
   os_mutexLock (&thread_states.lock);
   ts1->state = THREAD_STATE_ZERO;
   if (sync_with_servicelease)
     nn_servicelease_statechange_barrier (gv.servicelease);
   if (ts1->name != main_thread_name)
     os_free (ts1->name);
+  ts1->name = NULL;
   os_mutexUnlock (&thread_states.lock);
 }
 
@@ -58,6 +58,21 @@ enum thread_state {
 };
 
 struct logbuf;
+struct nn_btrace_ring;
+
+/* Transport statistics are kept per thread and per transport factory
+   (indexed by ddsi_tran_factory::m_stat_idx), so counting a datagram is
+   a plain increment on a cache line no other thread writes. Only the
+   owning thread updates them; readers sum over all threads. */
+#define THREAD_TRAN_STATS_MAX 8
+
+struct thread_tran_stats {
+  os_uint64 packets_in;
+  os_uint64 bytes_in;
+  os_uint64 packets_out;
+  os_uint64 bytes_out;
+  os_uint64 errors_out;
+};
 
 /*
  * watchdog indicates progress for the service lease liveliness mechsanism, while vtime
@@ -72,6 +87,8 @@ struct logbuf;
   os_threadId extTid;                           \
   enum thread_state state;                      \
   struct logbuf *lb;                            \
+  struct nn_btrace_ring *btr;                   \
+  struct thread_tran_stats tran_stats[THREAD_TRAN_STATS_MAX]; \
   char *name /* note: no semicolon! */
 
 struct thread_state_base {
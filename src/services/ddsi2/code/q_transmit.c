@@ -45,6 +45,8 @@
 #include "q_static_assert.h"
 
 #include "q_osplser.h"
+#include "q_btrace.h"
+#include "q_compress.h"
 
 #include "sysdeps.h"
 
@@ -398,6 +400,7 @@ void add_Heartbeat (struct nn_xmsg *msg, struct writer *wr, int hbansreq, nn_ent
   hb->lastSN = toSN (max);
 
   hb->count = ++wr->hbcount;
+  NN_BTRACE (NN_BTE_SEND_HEARTBEAT, &wr->e.guid, max, (os_uint32) hb->count);
 
   nn_xmsg_submsg_setnext (msg, sm_marker);
 }
@@ -631,15 +634,20 @@ static int must_skip_frag (const char *frags_to_skip, unsigned frag)
 }
 #endif
 
-static int transmit_sample (struct nn_xpack *xp, struct writer *wr, os_int64 seq, const struct nn_plist *plist, serdata_t serdata, struct proxy_reader *prd, int isnew)
+static int transmit_sample (struct nn_xpack *xp, struct writer *wr, os_int64 seq, const struct nn_plist *plist, serdata_t serdata, struct proxy_reader *prd, int isnew, int compressed)
 {
   unsigned i, sz, nfrags;
+  serdata_t txdata;
 #if 0
   const char *frags_to_skip = getenv ("SKIPFRAGS");
 #endif
   assert(xp);
 
-  sz = ddsi_serdata_size (serdata);
+  /* The WHC holds the uncompressed sample; compressing is done outside
+     the writer lock */
+  txdata = compressed ? nn_compress_form (serdata) : serdata;
+
+  sz = ddsi_serdata_size (txdata);
   nfrags = (sz + config.fragment_size - 1) / config.fragment_size;
   if (nfrags == 0)
   {
@@ -660,7 +668,7 @@ static int transmit_sample (struct nn_xpack *xp, struct writer *wr, os_int64 seq
        we haven't yet completed transmitting a fragmented message, add
        a HeartbeatFrag. */
     os_mutexLock (&wr->e.lock);
-    ret = create_fragment_message (wr, seq, plist, serdata, i, prd, &fmsg, isnew);
+    ret = create_fragment_message (wr, seq, plist, txdata, i, prd, &fmsg, isnew);
     if (ret >= 0)
     {
       if (nfrags > 1 && i + 1 < nfrags)
@@ -697,21 +705,64 @@ static int transmit_sample (struct nn_xpack *xp, struct writer *wr, os_int64 seq
   return 0;
 }
 
-int enqueue_sample_wrlock_held (struct writer *wr, os_int64 seq, const struct nn_plist *plist, serdata_t serdata, struct proxy_reader *prd, int isnew)
+static unsigned sample_nfrags (serdata_t serdata)
 {
-  unsigned i, sz, nfrags;
-  int enqueued = 1;
+  const unsigned sz = ddsi_serdata_size (serdata);
+  const unsigned nfrags = (sz + config.fragment_size - 1) / config.fragment_size;
+  /* end-of-transaction messages are empty, but still need to be sent */
+  return (nfrags == 0) ? 1 : nfrags;
+}
+
+void batch_rexmit_sample_wrlock_held (struct qxev_rexmit_batch *batch, struct writer *wr, os_int64 seq, const struct nn_plist *plist, serdata_t serdata, struct proxy_reader *prd, int compressed)
+{
+  unsigned i, nfrags;
 
   ASSERT_MUTEX_HELD (&wr->e.lock);
 
-  sz = ddsi_serdata_size (serdata);
-  nfrags = (sz + config.fragment_size - 1) / config.fragment_size;
-  if (nfrags == 0)
+  if (compressed)
+    serdata = nn_compress_form (serdata);
+  nfrags = sample_nfrags (serdata);
+  for (i = 0; i < nfrags; i++)
   {
-    /* end-of-transaction messages are empty, but still need to be sent */
-    nfrags = 1;
+    struct nn_xmsg *fmsg = NULL;
+    struct nn_xmsg *hmsg = NULL;
+    /* Ignore out-of-memory errors, as in enqueue_sample_wrlock_held */
+    if (create_fragment_message (wr, seq, plist, serdata, i, prd, &fmsg, 0) >= 0)
+    {
+      if (nfrags > 1 && i + 1 < nfrags)
+        create_HeartbeatFrag (wr, seq, i, prd, &hmsg);
+    }
+    if (fmsg)
+      qxev_rexmit_batch_add (batch, fmsg, hmsg);
+    else if (hmsg)
+      nn_xmsg_free (hmsg);
+  }
+}
+
+int enqueue_sample_wrlock_held (struct writer *wr, os_int64 seq, const struct nn_plist *plist, serdata_t serdata, struct proxy_reader *prd, int isnew, int compressed)
+{
+  unsigned i, nfrags;
+
+  ASSERT_MUTEX_HELD (&wr->e.lock);
+
+  if (!isnew)
+  {
+    /* Implementations that never use NACKFRAG are allowed by the specification, and for such a peer, we must always force out the full sample on a retransmit request. I am not aware of any such implementations so leaving the override flag in, but not actually using it at the moment. Should set force = (i != 0) for "known bad" implementations. */
+    const int force = 0;
+    struct qxev_rexmit_batch batch;
+    unsigned n;
+    qxev_rexmit_batch_init (&batch);
+    batch_rexmit_sample_wrlock_held (&batch, wr, seq, plist, serdata, prd, compressed);
+    n = batch.n;
+    n -= qxev_msgs_rexmit_wrlock_held (wr->evq, &batch, force);
+    qxev_rexmit_batch_fini (&batch);
+    return (n == 0) ? 0 : -1;
   }
-  for (i = 0; i < nfrags && enqueued; i++)
+
+  if (compressed)
+    serdata = nn_compress_form (serdata);
+  nfrags = sample_nfrags (serdata);
+  for (i = 0; i < nfrags; i++)
   {
     struct nn_xmsg *fmsg = NULL;
     struct nn_xmsg *hmsg = NULL;
@@ -724,34 +775,13 @@ int enqueue_sample_wrlock_held (struct writer *wr, os_int64 seq, const struct nn
       if (nfrags > 1 && i + 1 < nfrags)
         create_HeartbeatFrag (wr, seq, i, prd, &hmsg);
     }
-    if (isnew)
-    {
-      if(fmsg) qxev_msg (wr->evq, fmsg);
-      if(hmsg) qxev_msg (wr->evq, hmsg);
-    }
-    else
-    {
-      /* Implementations that never use NACKFRAG are allowed by the specification, and for such a peer, we must always force out the full sample on a retransmit request. I am not aware of any such implementations so leaving the override flag in, but not actually using it at the moment. Should set force = (i != 0) for "known bad" implementations. */
-      const int force = 0;
-      if(fmsg)
-      {
-        enqueued = qxev_msg_rexmit_wrlock_held (wr->evq, fmsg, force);
-      }
-      /* Functioning of the system is not dependent on getting the
-         HeartbeatFrags out, so never force them into the queue. */
-      if(hmsg)
-      {
-        if (enqueued > 1)
-          qxev_msg (wr->evq, hmsg);
-        else
-          nn_xmsg_free (hmsg);
-      }
-    }
+    if(fmsg) qxev_msg (wr->evq, fmsg);
+    if(hmsg) qxev_msg (wr->evq, hmsg);
   }
-  return enqueued ? 0 : -1;
+  return 0;
 }
 
-static int insert_sample_in_whc (struct writer *wr, os_int64 seq, struct nn_plist *plist, serdata_t serdata)
+static int insert_sample_in_whc (struct writer *wr, os_int64 seq, struct nn_plist *plist, serdata_t serdata, int compressed)
 {
   /* returns: < 0 on error, 0 if no need to insert in whc, > 0 if inserted */
   int do_insert, insres, res;
@@ -784,7 +814,7 @@ static int insert_sample_in_whc (struct writer *wr, os_int64 seq, struct nn_plis
 
   if (!do_insert)
     res = 0;
-  else if ((insres = whc_insert (wr->whc, writer_max_drop_seq (wr), seq, plist, serdata)) < 0)
+  else if ((insres = whc_insert (wr->whc, writer_max_drop_seq (wr), seq, plist, serdata, compressed)) < 0)
     res = insres;
   else
     res = 1;
@@ -874,6 +904,7 @@ static os_result throttle_writer (struct nn_xpack *xp, struct writer *wr)
   TRACE (("writer %x:%x:%x:%x topic %s waiting for whc to shrink below low-water mark (whc %"PA_PRIuSIZE" low=%u high=%u)\n", PGUID (wr->e.guid), wr->topic ? wr->topic->name : "(null)", n_unacked, wr->whc_low, wr->whc_high));
   wr->throttling++;
   wr->throttle_count++;
+  NN_BTRACE (NN_BTE_THROTTLE, &wr->e.guid, wr->seq, (os_uint32) n_unacked);
 
   /* Force any outstanding packet out: there will be a heartbeat
      requesting an answer in it.  FIXME: obviously, this is doing
@@ -947,7 +978,7 @@ static int maybe_grow_whc (struct writer *wr)
 
 static int write_sample_kernel_seq_eot (struct nn_xpack *xp, struct writer *wr, struct nn_plist *plist, serdata_t serdata, int have_kernel_seq, os_uint32 kernel_seq, int end_of_txn)
 {
-  int r;
+  int r, compressed;
   os_int64 seq;
   nn_mtime_t tnow;
 
@@ -1021,6 +1052,9 @@ static int write_sample_kernel_seq_eot (struct nn_xpack *xp, struct writer *wr,
   ddsi_serdata_set_twrite (serdata, tnow);
 
   seq = ++wr->seq;
+  wr->num_samples_written++;
+  wr->num_bytes_written += ddsi_serdata_size (serdata);
+  NN_BTRACE (NN_BTE_WRITE, &wr->e.guid, seq, ddsi_serdata_size (serdata));
   if (wr->cs_seq != 0)
   {
     if (plist == NULL)
@@ -1033,7 +1067,11 @@ static int write_sample_kernel_seq_eot (struct nn_xpack *xp, struct writer *wr,
     plist->coherent_set_seqno = toSN (wr->cs_seq);
   }
 
-  if ((r = insert_sample_in_whc (wr, seq, plist, serdata)) < 0)
+  /* The form of the first transmission is decided once, here, and
+     recorded in the WHC: repairs must use the same form, as readers
+     reassemble fragments of one form only */
+  compressed = nn_compress_wanted (wr, NULL);
+  if ((r = insert_sample_in_whc (wr, seq, plist, serdata, compressed)) < 0)
   {
     /* Failure of some kind */
     os_mutexUnlock (&wr->e.lock);
@@ -1063,7 +1101,7 @@ static int write_sample_kernel_seq_eot (struct nn_xpack *xp, struct writer *wr,
         nn_plist_copy (plist_copy, plist);
       }
       os_mutexUnlock (&wr->e.lock);
-      transmit_sample (xp, wr, seq, plist_copy, serdata, NULL, 1);
+      transmit_sample (xp, wr, seq, plist_copy, serdata, NULL, 1, compressed);
       if (plist_copy)
         nn_plist_fini (plist_copy);
     }
@@ -1071,7 +1109,7 @@ static int write_sample_kernel_seq_eot (struct nn_xpack *xp, struct writer *wr,
     {
       if (wr->heartbeat_xevent)
         writer_hbcontrol_note_asyncwrite (wr, tnow);
-      enqueue_sample_wrlock_held (wr, seq, plist, serdata, NULL, 1);
+      enqueue_sample_wrlock_held (wr, seq, plist, serdata, NULL, 1, compressed);
       os_mutexUnlock (&wr->e.lock);
     }
 
@@ -32,6 +32,7 @@ struct nn_xmsg;
 struct writer;
 struct proxy_reader;
 struct serdata;
+struct qxev_rexmit_batch;
 
 /* Writing new data; serdata_twrite (serdata) is assumed to be really
    recentish; serdata is unref'd.  If xp == NULL, data is queued, else
@@ -45,7 +46,10 @@ int end_coherent_set (struct nn_xpack *xp, struct writer *wr, struct nn_plist *p
 
 /* When calling the following functions, wr->lock must be held */
 int create_fragment_message (struct writer *wr, os_int64 seq, const struct nn_plist *plist, struct serdata *serdata, unsigned fragnum, struct proxy_reader *prd,struct nn_xmsg **msg, int isnew);
-int enqueue_sample_wrlock_held (struct writer *wr, os_int64 seq, const struct nn_plist *plist, struct serdata *serdata, struct proxy_reader *prd, int isnew);
+int enqueue_sample_wrlock_held (struct writer *wr, os_int64 seq, const struct nn_plist *plist, struct serdata *serdata, struct proxy_reader *prd, int isnew, int compressed);
+/* Adds the messages retransmitting sample SEQ to PRD (all readers if
+   NULL) to BATCH, for queueing with qxev_msgs_rexmit_wrlock_held */
+void batch_rexmit_sample_wrlock_held (struct qxev_rexmit_batch *batch, struct writer *wr, os_int64 seq, const struct nn_plist *plist, struct serdata *serdata, struct proxy_reader *prd, int compressed);
 void add_Heartbeat (struct nn_xmsg *msg, struct writer *wr, int hbansreq, nn_entityid_t dst, int issync);
 
 #if defined (__cplusplus)
@@ -709,7 +709,7 @@ struct whc_node *whc_findkey (const struct whc *whc, const struct serdata *serda
   }
 }
 
-static struct whc_node *whc_insert_seq (struct whc *whc, os_int64 max_drop_seq, os_int64 seq, struct nn_plist *plist, serdata_t serdata)
+static struct whc_node *whc_insert_seq (struct whc *whc, os_int64 max_drop_seq, os_int64 seq, struct nn_plist *plist, serdata_t serdata, int compressed)
 {
   struct whc_node *newn = NULL;
 
@@ -720,6 +720,7 @@ static struct whc_node *whc_insert_seq (struct whc *whc, os_int64 max_drop_seq,
   newn->seq = seq;
   newn->plist = plist;
   newn->unacked = (seq > max_drop_seq);
+  newn->compressed = (compressed != 0);
   newn->idxnode = NULL; /* initial state, may be changed */
   newn->idxnode_pos = 0;
   newn->last_rexmit_ts.v = 0;
@@ -767,7 +768,7 @@ static struct whc_node *whc_insert_seq (struct whc *whc, os_int64 max_drop_seq,
   return newn;
 }
 
-int whc_insert (struct whc *whc, os_int64 max_drop_seq, os_int64 seq, struct nn_plist *plist, serdata_t serdata)
+int whc_insert (struct whc *whc, os_int64 max_drop_seq, os_int64 seq, struct nn_plist *plist, serdata_t serdata, int compressed)
 {
   struct whc_node *newn = NULL;
   struct whc_idxnode *idxn;
@@ -792,7 +793,7 @@ int whc_insert (struct whc *whc, os_int64 max_drop_seq, os_int64 seq, struct nn_
   assert (whc_empty (whc) || seq > whc_max_seq (whc));
 
   /* Always insert in seq admin */
-  newn = whc_insert_seq (whc, max_drop_seq, seq, plist, serdata);
+  newn = whc_insert_seq (whc, max_drop_seq, seq, plist, serdata, compressed);
 
   TRACE_WHC(("  whcn %p:", (void*)newn));
 
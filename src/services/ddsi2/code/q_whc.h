@@ -42,6 +42,7 @@ struct whc_node {
   os_int64 seq;
   struct nn_plist *plist; /* 0 if nothing special */
   unsigned unacked: 1; /* counted in whc::unacked_bytes iff 1 */
+  unsigned compressed: 1; /* first sent in compressed form (see nn_compress_wanted_repair) */
   nn_mtime_t last_rexmit_ts;
   unsigned rexmit_count;
   struct serdata *serdata;
@@ -98,7 +99,7 @@ struct whc_node *whc_findkey (const struct whc *whc, const struct serdata *serda
    reliable readers that have not acknowledged all data */
 /* max_drop_seq must go soon, it's way too ugly. */
 /* plist may be NULL or os_malloc'd, WHC takes ownership of plist */
-int whc_insert (struct whc *whc, os_int64 max_drop_seq, os_int64 seq, struct nn_plist *plist, struct serdata *serdata);
+int whc_insert (struct whc *whc, os_int64 max_drop_seq, os_int64 seq, struct nn_plist *plist, struct serdata *serdata, int compressed);
 void whc_downgrade_to_volatile (struct whc *whc);
 unsigned whc_remove_acked_messages (struct whc *whc, os_int64 max_drop_seq);
 
@@ -51,6 +51,8 @@
 #include "q_lease.h"
 #include "q_xmsg.h"
 #include "q_osplser.h"
+#include "q_stats.h"
+#include "q_btrace.h"
 #include "ddsi_ser.h"
 
 #include "sysdeps.h"
@@ -167,6 +169,14 @@ struct xeventq {
   os_cond cond;
   ddsi_tran_conn_t tev_conn;
   os_uint32 auxiliary_bandwidth_limit;
+
+  /* Statistics, protected by lock except for the histogram of how
+     late timed events are handled (in ns) */
+  os_uint32 n_timed_handled;
+  os_uint32 n_nontimed_handled;
+  os_uint32 n_rexmit_dropped;
+  size_t max_seen_queued_rexmit_bytes;
+  struct nn_stat_hist lateness_hist;
 };
 
 static void *xevent_thread (struct xeventq *xevq);
@@ -507,11 +517,29 @@ struct xeventq * xeventq_new
   evq->queued_rexmit_bytes = 0;
   evq->queued_rexmit_msgs = 0;
   evq->tev_conn = conn;
+  evq->n_timed_handled = 0;
+  evq->n_nontimed_handled = 0;
+  evq->n_rexmit_dropped = 0;
+  evq->max_seen_queued_rexmit_bytes = 0;
+  nn_stat_hist_init (&evq->lateness_hist);
   os_mutexInit (&evq->lock, NULL);
   os_condInit (&evq->cond, &evq->lock, NULL);
   return evq;
 }
 
+void xeventq_getstats (struct xeventq *evq, struct xeventq_stats *st)
+{
+  os_mutexLock (&evq->lock);
+  st->n_timed_handled = evq->n_timed_handled;
+  st->n_nontimed_handled = evq->n_nontimed_handled;
+  st->n_rexmit_dropped = evq->n_rexmit_dropped;
+  st->queued_rexmit_bytes = evq->queued_rexmit_bytes;
+  st->queued_rexmit_msgs = evq->queued_rexmit_msgs;
+  st->max_seen_queued_rexmit_bytes = evq->max_seen_queued_rexmit_bytes;
+  st->lateness_hist = &evq->lateness_hist;
+  os_mutexUnlock (&evq->lock);
+}
+
 int xeventq_start (struct xeventq *evq, const char *name)
 {
   char * evqname = "tev";
@@ -798,6 +826,11 @@ static void add_AckNack (struct nn_xmsg *msg, struct proxy_writer *pwr, struct p
      that'd a very useful feature in combination with directed
      heartbeats, or somesuch, to get reliability guarantees. */
   *nack_seq = (numbits > 0) ? base + numbits : 0;
+  if (*nack_seq || nackfrag_numbits > 0)
+    pwr->num_nacks_sent++;
+  else
+    pwr->num_acks_sent++;
+  NN_BTRACE (NN_BTE_SEND_ACKNACK, &pwr->e.guid, base, numbits | ((*nack_seq || nackfrag_numbits > 0) ? 0x80000000u : 0));
   if (!pwr->have_seen_heartbeat) {
     /* We must have seen a heartbeat for us to consider setting FINAL */
   } else if (*nack_seq && base + numbits <= pwr->last_seq) {
@@ -1025,7 +1058,7 @@ static void handle_xevk_spdp (UNUSED_ARG (struct nn_xpack *xp), struct xevent *e
        updating of the last transmitted sequence number won't take
        place anyway.  Nor is it necessary to fiddle with heartbeat
        control stuff. */
-    enqueue_sample_wrlock_held (spdp_wr, whcn->seq, whcn->plist, whcn->serdata, prd, 1);
+    enqueue_sample_wrlock_held (spdp_wr, whcn->seq, whcn->plist, whcn->serdata, prd, 1, 0);
   }
   os_mutexUnlock (&spdp_wr->e.lock);
 
@@ -1312,6 +1345,8 @@ static void handle_xevents (struct thread_state1 *self, struct xeventq *xevq, st
            determine whether it is currently on the heap or not (i.e.,
            scheduled or not), so set to TSCHED_NEVER to indicate it
            currently isn't. */
+        nn_stat_hist_add (&xevq->lateness_hist, tnow.v - xev->tsched.v);
+        xevq->n_timed_handled++;
         xev->tsched.v = T_NEVER;
         handle_timed_xevent (self, xev, xp, tnow);
       }
@@ -1324,6 +1359,7 @@ static void handle_xevents (struct thread_state1 *self, struct xeventq *xevq, st
     if (!non_timed_xmit_list_is_empty (xevq))
     {
       struct xevent_nt *xev = getnext_from_non_timed_xmit_list (xevq);
+      xevq->n_nontimed_handled++;
       handle_nontimed_xevent (self, xev, xp);
       tnow = now_mt ();
     }
@@ -1459,19 +1495,19 @@ void qxev_pwr_entityid (struct proxy_writer * pwr, nn_guid_prefix_t * id)
   }
 }
 
-int qxev_msg_rexmit_wrlock_held (struct xeventq *evq, struct nn_xmsg *msg, int force)
+static int qxev_msg_rexmit_locked (struct xeventq *evq, struct nn_xmsg *msg, int force)
 {
+  /* Returns 2 if MSG was queued, 1 if it got merged with a pending
+     retransmit and 0 if it was dropped; in the latter two cases the
+     caller must free MSG once it has released EVQ->lock */
   size_t msg_size = nn_xmsg_size (msg);
   struct xevent_nt *ev;
 
-  assert (evq);
+  ASSERT_MUTEX_HELD (&evq->lock);
   assert (nn_xmsg_kind (msg) == NN_XMSG_KIND_DATA_REXMIT);
-  os_mutexLock (&evq->lock);
   if ((ev = lookup_msg (evq, msg)) != NULL && nn_xmsg_merge_rexmit_destinations_wrlock_held (ev->u.msg_rexmit.msg, msg))
   {
     /* MSG got merged with a pending retransmit, so it has effectively been queued */
-    os_mutexUnlock (&evq->lock);
-    nn_xmsg_free (msg);
     return 1;
   }
   else if ((evq->queued_rexmit_bytes > evq->max_queued_rexmit_bytes ||
@@ -1479,8 +1515,7 @@ int qxev_msg_rexmit_wrlock_held (struct xeventq *evq, struct nn_xmsg *msg, int f
            !force)
   {
     /* drop it if insufficient resources available */
-    os_mutexUnlock (&evq->lock);
-    nn_xmsg_free (msg);
+    evq->n_rexmit_dropped++;
 #if 0
     TRACE ((" qxev_msg_rexmit%s drop (sz %"PA_PRIuSIZE" qb %"PA_PRIuSIZE" qm %"PA_PRIuSIZE")", force ? "!" : "",
             msg_size, evq->queued_rexmit_bytes, evq->queued_rexmit_msgs));
@@ -1494,15 +1529,97 @@ int qxev_msg_rexmit_wrlock_held (struct xeventq *evq, struct nn_xmsg *msg, int f
     ev->u.msg_rexmit.queued_rexmit_bytes = msg_size;
     evq->queued_rexmit_bytes += msg_size;
     evq->queued_rexmit_msgs++;
+    if (evq->queued_rexmit_bytes > evq->max_seen_queued_rexmit_bytes)
+      evq->max_seen_queued_rexmit_bytes = evq->queued_rexmit_bytes;
     qxev_insert_nt (ev);
 #if 0
     TRACE (("AAA(%p,%"PA_PRIuSIZE")", (void *) ev, msg_size));
 #endif
-    os_mutexUnlock (&evq->lock);
     return 2;
   }
 }
 
+int qxev_msg_rexmit_wrlock_held (struct xeventq *evq, struct nn_xmsg *msg, int force)
+{
+  int res;
+  assert (evq);
+  os_mutexLock (&evq->lock);
+  res = qxev_msg_rexmit_locked (evq, msg, force);
+  os_mutexUnlock (&evq->lock);
+  if (res < 2)
+    nn_xmsg_free (msg);
+  return res;
+}
+
+void qxev_rexmit_batch_init (struct qxev_rexmit_batch *b)
+{
+  b->n = b->size = 0;
+  b->elems = NULL;
+}
+
+void qxev_rexmit_batch_fini (struct qxev_rexmit_batch *b)
+{
+  assert (b->n == 0);
+  os_free (b->elems);
+}
+
+void qxev_rexmit_batch_add (struct qxev_rexmit_batch *b, struct nn_xmsg *msg, struct nn_xmsg *hbfrag)
+{
+  if (b->n == b->size)
+  {
+    b->size = (b->size == 0) ? 16 : 2 * b->size;
+    b->elems = os_realloc (b->elems, b->size * sizeof (*b->elems));
+  }
+  b->elems[b->n].msg = msg;
+  b->elems[b->n].hbfrag = hbfrag;
+  b->n++;
+}
+
+unsigned qxev_msgs_rexmit_wrlock_held (struct xeventq *evq, struct qxev_rexmit_batch *b, int force)
+{
+  unsigned i, nqueued;
+  int res;
+
+  assert (evq);
+  if (b->n == 0)
+    return 0;
+  os_mutexLock (&evq->lock);
+  for (i = 0; i < b->n; i++)
+  {
+    struct qxev_rexmit_batch_elem *e = &b->elems[i];
+    if ((res = qxev_msg_rexmit_locked (evq, e->msg, force)) == 0)
+      break;
+    else if (res == 2)
+    {
+      e->msg = NULL;
+      /* Functioning of the system is not dependent on getting the
+         HeartbeatFrags out, so they only go with a retransmit that
+         was newly queued */
+      if (e->hbfrag)
+      {
+        struct xevent_nt *ev = qxev_common_nt (evq, XEVK_MSG);
+        ev->u.msg.msg = e->hbfrag;
+        qxev_insert_nt (ev);
+        e->hbfrag = NULL;
+      }
+    }
+  }
+  nqueued = i;
+  os_mutexUnlock (&evq->lock);
+
+  /* Free merged and dropped retransmits and their HeartbeatFrags
+     outside the event queue lock */
+  for (i = 0; i < b->n; i++)
+  {
+    if (b->elems[i].msg)
+      nn_xmsg_free (b->elems[i].msg);
+    if (b->elems[i].hbfrag)
+      nn_xmsg_free (b->elems[i].hbfrag);
+  }
+  b->n = 0;
+  return nqueued;
+}
+
 struct xevent *qxev_heartbeat (struct xeventq *evq, nn_mtime_t tsched, const nn_guid_t *wr_guid)
 {
   /* Event _must_ be deleted before enough of the writer is freed to
@@ -38,6 +38,18 @@ struct xevent;
 struct xeventq;
 struct proxy_writer;
 struct proxy_reader;
+struct nn_stat_hist;
+struct nn_xmsg;
+
+struct xeventq_stats {
+  os_uint32 n_timed_handled;
+  os_uint32 n_nontimed_handled;
+  os_uint32 n_rexmit_dropped;
+  size_t queued_rexmit_bytes;
+  size_t queued_rexmit_msgs;
+  size_t max_seen_queued_rexmit_bytes;
+  const struct nn_stat_hist *lateness_hist; /* how late timed events are handled (ns) */
+};
 
 struct xeventq *xeventq_new
 (
@@ -52,6 +64,7 @@ struct xeventq *xeventq_new
 void xeventq_free (struct xeventq *evq);
 int xeventq_start (struct xeventq *evq, const char *name); /* <0 => error, =0 => ok */
 void xeventq_stop (struct xeventq *evq);
+void xeventq_getstats (struct xeventq *evq, struct xeventq_stats *st);
 
 void qxev_msg (struct xeventq *evq, struct nn_xmsg *msg);
 void qxev_pwr_entityid (struct proxy_writer * pwr, nn_guid_prefix_t * id);
@@ -61,6 +74,32 @@ void qxev_prd_entityid (struct proxy_reader * prd, nn_guid_prefix_t * id);
    event, you can't do anything with it anyway) */
 int qxev_msg_rexmit_wrlock_held (struct xeventq *evq, struct nn_xmsg *msg, int force);
 
+/* A batch of retransmits, e.g. all samples of a run of NACK'd sequence
+   numbers, queued with a single acquisition of the event queue lock so
+   that the event thread finds them back-to-back and packs them into as
+   few packets as possible. Each element is a DATA(FRAG) retransmit with
+   an optional HeartbeatFrag, which is queued only if the retransmit is
+   queued as a new event. */
+struct qxev_rexmit_batch_elem {
+  struct nn_xmsg *msg;
+  struct nn_xmsg *hbfrag;
+};
+
+struct qxev_rexmit_batch {
+  unsigned n, size;
+  struct qxev_rexmit_batch_elem *elems;
+};
+
+void qxev_rexmit_batch_init (struct qxev_rexmit_batch *b);
+void qxev_rexmit_batch_fini (struct qxev_rexmit_batch *b);
+void qxev_rexmit_batch_add (struct qxev_rexmit_batch *b, struct nn_xmsg *msg, struct nn_xmsg *hbfrag);
+
+/* Queues the elements of B in order and empties B. It stops at the
+   first retransmit that doesn't fit in the queue and frees the
+   remaining messages. Returns the number of elements queued, including
+   those merged with a pending retransmit. */
+unsigned qxev_msgs_rexmit_wrlock_held (struct xeventq *evq, struct qxev_rexmit_batch *b, int force);
+
 /* All of the following lock EVQ for the duration of the operation */
 void delete_xevent (struct xevent *ev);
 int resched_xevent_if_earlier (struct xevent *ev, nn_mtime_t tsched);
@@ -226,6 +226,29 @@ os_int64 get_thread_cputime (void)
 }
 #endif
 
+#if SYSDEPS_HAVE_HUGEPAGES
+#include <stdio.h>
+
+os_size_t get_hugepage_size (void)
+{
+  char line[128];
+  unsigned long kb = 0;
+  FILE *fp;
+  if ((fp = fopen ("/proc/meminfo", "r")) == NULL)
+    return 0;
+  while (fgets (line, sizeof (line), fp) != NULL)
+  {
+    if (sscanf (line, "Hugepagesize: %lu kB", &kb) == 1)
+      break;
+  }
+  fclose (fp);
+  /* must be a power of two for rounding allocations up to it */
+  if ((kb & (kb - 1)) != 0)
+    return 0;
+  return (os_size_t) kb * 1024;
+}
+#endif
+
 #if ! OS_HAVE_THREADEQUAL
 int os_threadEqual (os_threadId a, os_threadId b)
 {
@@ -69,6 +69,20 @@
 #define SYSDEPS_HAVE_CLOCK_THREAD_CPUTIME 1
 #endif
 
+#if defined (__linux) || defined (__linux__)
+#include <sys/mman.h>
+#if defined (MAP_HUGETLB)
+#define SYSDEPS_HAVE_HUGEPAGES 1
+#endif
+#endif
+
+#if defined (__linux) || defined (__linux__)
+/* POSIX shared memory + futexes for the shared-memory loopback transport */
+#define SYSDEPS_HAVE_SHM_FUTEX 1
+/* epoll + eventfd for asynchronous TCP writes */
+#define SYSDEPS_HAVE_EPOLL 1
+#endif
+
 #if defined (INTEGRITY)
 #include <sys/uio.h>
 #include <limits.h>
@@ -180,6 +194,12 @@ long random (void);
 
 os_int64 get_thread_cputime (void);
 
+#if SYSDEPS_HAVE_HUGEPAGES
+/* Default huge page size of the system (the one MAP_HUGETLB uses), 0 if
+   it can't be determined */
+os_size_t get_hugepage_size (void);
+#endif
+
 int os_threadEqual (os_threadId a, os_threadId b);
 void log_stacktrace (const char *name, os_threadId tid);
 
@@ -0,0 +1,184 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* Prints the binary trace written by DDSI2 (Tracing/BinaryOutputFile,
+ * see q_btrace.h for the format) as text, one line per record:
+ *
+ *   TIMESTAMP SLOT THREAD GUID EVENT SEQ ARG
+ *
+ * Records are printed in the order of the file, i.e., per chunk of a
+ * single thread; as the timestamp comes first, "sort -n" merges them.
+ * Files written on a machine with the other byte order are converted.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "vortex_os.h"
+#include "q_btrace.h"
+
+static const char * const event_names[] = {
+    "WRITE",
+    "SEND_HEARTBEAT",
+    "RECV_ACKNACK",
+    "REXMIT",
+    "THROTTLE",
+    "RECV_DATA",
+    "RECV_HEARTBEAT",
+    "RECV_GAP",
+    "SEND_ACKNACK",
+    "DELIVER"
+};
+
+static os_uint32
+bswap4(
+    os_uint32 x)
+{
+    return (x >> 24) | ((x >> 8) & 0xff00u) | ((x << 8) & 0xff0000u) | (x << 24);
+}
+
+static os_int64
+bswap8(
+    os_int64 x)
+{
+    os_uint64 u = (os_uint64)x;
+    return (os_int64)(((os_uint64)bswap4((os_uint32)u) << 32) | bswap4((os_uint32)(u >> 32)));
+}
+
+static void
+print_arg(
+    const struct nn_btrace_record *r)
+{
+    switch (r->event) {
+    case NN_BTE_REXMIT:
+    case NN_BTE_RECV_DATA:
+        /* fragment number, or ~0 for a complete sample */
+        if (r->arg == ~0u) {
+            printf("-\n");
+        } else {
+            printf("frag %u\n", r->arg);
+        }
+        break;
+    case NN_BTE_SEND_ACKNACK:
+        printf("%s %u\n", (r->arg & 0x80000000u) ? "nack" : "ack", r->arg & 0x7fffffffu);
+        break;
+    default:
+        printf("%u\n", r->arg);
+        break;
+    }
+}
+
+static int
+dump(
+    FILE *fp,
+    const char *fileName)
+{
+    struct nn_btrace_file_header fhdr;
+    struct nn_btrace_chunk_header chdr;
+    struct nn_btrace_record r;
+    const char *tname;
+    os_uint32 i;
+    int swap;
+
+    if (fread(&fhdr, sizeof(fhdr), 1, fp) != 1) {
+        fprintf(stderr, "%s: not a binary trace file\n", fileName);
+        return -1;
+    }
+    if (fhdr.magic == NN_BTRACE_MAGIC) {
+        swap = 0;
+    } else if (fhdr.magic == bswap4(NN_BTRACE_MAGIC)) {
+        swap = 1;
+        fhdr.version = bswap4(fhdr.version);
+        fhdr.record_size = bswap4(fhdr.record_size);
+    } else {
+        fprintf(stderr, "%s: not a binary trace file\n", fileName);
+        return -1;
+    }
+    if (fhdr.version != NN_BTRACE_VERSION || fhdr.record_size != sizeof(r)) {
+        fprintf(stderr, "%s: unsupported version %u (record size %u)\n",
+                fileName, fhdr.version, fhdr.record_size);
+        return -1;
+    }
+
+    while (fread(&chdr, sizeof(chdr), 1, fp) == 1) {
+        if (swap) {
+            chdr.slot = bswap4(chdr.slot);
+            chdr.nrecords = bswap4(chdr.nrecords);
+            chdr.ndropped = bswap4(chdr.ndropped);
+        }
+        chdr.tname[sizeof(chdr.tname) - 1] = 0;
+        tname = chdr.tname[0] ? chdr.tname : "-";
+        if (chdr.ndropped > 0) {
+            printf("# slot %u %s: %u records dropped\n", chdr.slot, tname, chdr.ndropped);
+        }
+        for (i = 0; i < chdr.nrecords; i++) {
+            if (fread(&r, sizeof(r), 1, fp) != 1) {
+                fprintf(stderr, "%s: truncated chunk (slot %u)\n", fileName, chdr.slot);
+                return -1;
+            }
+            if (swap) {
+                r.tstamp = bswap8(r.tstamp);
+                r.seq = bswap8(r.seq);
+                r.guid.prefix.u[0] = bswap4(r.guid.prefix.u[0]);
+                r.guid.prefix.u[1] = bswap4(r.guid.prefix.u[1]);
+                r.guid.prefix.u[2] = bswap4(r.guid.prefix.u[2]);
+                r.guid.entityid.u = bswap4(r.guid.entityid.u);
+                r.event = bswap4(r.event);
+                r.arg = bswap4(r.arg);
+            }
+            printf("%"PA_PRId64".%09d %u %s %x:%x:%x:%x ",
+                   r.tstamp / 1000000000, (int)(r.tstamp % 1000000000),
+                   chdr.slot, tname, PGUID(r.guid));
+            if (r.event < sizeof(event_names) / sizeof(event_names[0])) {
+                printf("%s ", event_names[r.event]);
+            } else {
+                printf("EVENT%u ", r.event);
+            }
+            printf("%"PA_PRId64" ", r.seq);
+            print_arg(&r);
+        }
+    }
+    if (ferror(fp)) {
+        fprintf(stderr, "%s: read error\n", fileName);
+        return -1;
+    }
+    return 0;
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    FILE *fp;
+    int result;
+
+    if (argc != 2) {
+        printf("Usage: %s file\n", argv[0]);
+        return 1;
+    }
+    if ((fp = fopen(argv[1], "rb")) == NULL) {
+        fprintf(stderr, "%s: cannot open\n", argv[1]);
+        return 1;
+    }
+    result = dump(fp, argv[1]);
+    fclose(fp);
+    return (result == 0) ? 0 : 1;
+}
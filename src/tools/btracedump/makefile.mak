@@ -0,0 +1,8 @@
+TARGET_EXEC	:= btracedump
+
+include		$(OSPL_HOME)/setup/makefiles/target.mak
+
+
+CINCS		+= -I$(OSPL_HOME)/src/services/ddsi2/code
+
+-include $(DEPENDENCIES)
@@ -0,0 +1,249 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include "u_user.h"
+#include "c_base.h"
+#include "c__base.h"
+#include "c_metabase.h"
+#include "os_errno.h"
+#include "os_abstract.h"
+#include "os_stdlib.h"
+#include "os_heap.h"
+#include "os_atomics.h"
+
+#include "mm_apc.h"
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <regex.h>
+
+/* Shows the sampling allocation profile maintained by the database (see
+ * c_baseSetAllocSampling). All figures are estimates: the sampled values
+ * are scaled by the sample interval.
+ */
+
+C_CLASS(apcLeaf);
+C_STRUCT(apcLeaf) {
+    c_baseAllocSite site;
+    os_uint32 count;
+    os_uint32 live;
+    unsigned long long bytes;
+    long long liveBytes;   /* estimated live bytes */
+    long long growth;      /* estimated growth in bytes since previous cycle */
+    double rate;           /* estimated allocations per second */
+};
+
+C_STRUCT(monitor_apc) {
+    char *filterExpression;
+    regex_t expression;
+    int orderCount;
+    c_bool delta;
+    struct timeval prevTime;
+    os_uint32 prevCount[C_BASE_ALLOCPROFILE_SIZE];
+    os_uint32 prevLive[C_BASE_ALLOCPROFILE_SIZE];
+    C_STRUCT(apcLeaf) leafs[C_BASE_ALLOCPROFILE_SIZE];
+};
+
+monitor_apc
+monitor_apcNew (
+    const char *filterExpression,
+    int orderCount,
+    c_bool delta)
+{
+    char expressionError [1024];
+    monitor_apc o = malloc (C_SIZEOF(monitor_apc));
+
+    if (o) {
+        memset (o, 0, C_SIZEOF(monitor_apc));
+        if (filterExpression) {
+            o->filterExpression = os_strdup(filterExpression);
+            if (regcomp (&o->expression, o->filterExpression, REG_EXTENDED) != 0) {
+                regerror (os_getErrno(), &o->expression, expressionError, sizeof(expressionError));
+                printf ("Filter expression error: %s\r\n", expressionError);
+                fflush(stdout);
+                regfree (&o->expression);
+                os_free (o->filterExpression);
+                o->filterExpression = NULL;
+            }
+        }
+        o->orderCount = orderCount;
+        o->delta = delta;
+    }
+    return o;
+}
+
+void
+monitor_apcFree (
+    monitor_apc o
+    )
+{
+    if (o) {
+        if (o->filterExpression) {
+            os_free (o->filterExpression);
+            regfree (&o->expression);
+        }
+        free (o);
+    }
+}
+
+/* The accumulated size is kept as two 32-bit words, retry if the high word
+ * changed while reading the low word. */
+static unsigned long long
+siteBytes (
+    c_baseAllocSite site)
+{
+    os_uint32 hi, lo;
+
+    do {
+        hi = pa_ld32 (&site->bytesHi);
+        lo = pa_ld32 (&site->bytes);
+    } while (hi != pa_ld32 (&site->bytesHi));
+    return ((unsigned long long)hi << 32) | lo;
+}
+
+static int
+orderLeafs (
+    const void *v1,
+    const void *v2,
+    c_bool delta)
+{
+    const C_STRUCT(apcLeaf) *l1 = v1, *l2 = v2;
+    long long n1 = delta ? l1->growth : l1->liveBytes;
+    long long n2 = delta ? l2->growth : l2->liveBytes;
+
+    return (n1 > n2) ? -1 : (n1 < n2) ? 1 : 0;
+}
+
+static int
+orderLeafsByLiveBytes (
+    const void *v1,
+    const void *v2)
+{
+    return orderLeafs (v1, v2, FALSE);
+}
+
+static int
+orderLeafsByGrowth (
+    const void *v1,
+    const void *v2)
+{
+    return orderLeafs (v1, v2, TRUE);
+}
+
+void
+monitor_apcAction (
+    v_public entity,
+    c_voidp args
+    )
+{
+    monitor_apc trace = monitor_apc(args);
+    c_baseAllocProfile profile;
+    c_baseAllocSite site;
+    apcLeaf leaf;
+    regmatch_t match[1];
+    struct timeval now;
+    double elapsed;
+    char *name;
+    c_type type;
+    os_uint32 interval;
+    long long totalLive = 0, totalGrowth = 0, mean;
+    int i, n, shown;
+    time_t t;
+
+    time (&t);
+    gettimeofday (&now, NULL);
+    profile = (c_baseAllocProfile) pa_ldvoidp (&c_getBase(entity)->allocProfile);
+
+    printf ("\r\n############# Allocation profile ############# %s\r\n", ctime(&t));
+    if (profile == NULL) {
+        printf ("Allocation sampling is not enabled for this domain, set\r\n"
+                "Domain/Database/AllocationSampleInterval in the configuration.\r\n");
+        fflush(stdout);
+        return;
+    }
+    interval = profile->interval;
+    if (trace->prevTime.tv_sec != 0) {
+        elapsed = (double)(now.tv_sec - trace->prevTime.tv_sec) +
+                  (double)(now.tv_usec - trace->prevTime.tv_usec) / 1e6;
+    } else {
+        elapsed = 0.0;
+    }
+    printf ("Interval          : %u\r\n", interval);
+    printf ("Samples (dropped) : %u (%u)\r\n",
+            pa_ld32 (&profile->samples), pa_ld32 (&profile->dropped));
+    if (trace->filterExpression) {
+        printf ("Filter expression : %s\r\n", trace->filterExpression);
+    }
+    printf ("\r\n");
+
+    n = 0;
+    for (i = 0; i < C_BASE_ALLOCPROFILE_SIZE; i++) {
+        site = &profile->sites[i];
+        if (pa_ldvoidp (&site->type) == NULL) {
+            continue;
+        }
+        leaf = &trace->leafs[n++];
+        leaf->site = site;
+        leaf->count = pa_ld32 (&site->count);
+        leaf->live = pa_ld32 (&site->live);
+        leaf->bytes = siteBytes (site);
+        /* Sizes of a type can differ (strings, arrays), so live bytes are
+         * estimated from the mean size of the sampled allocations. */
+        mean = leaf->count ? (long long)(leaf->bytes / leaf->count) : 0;
+        leaf->liveBytes = (long long)leaf->live * interval * mean;
+        leaf->growth = ((long long)leaf->live - (long long)trace->prevLive[i]) *
+            interval * mean;
+        leaf->rate = (elapsed > 0.0) ?
+            (double)(leaf->count - trace->prevCount[i]) * interval / elapsed : 0.0;
+        trace->prevCount[i] = leaf->count;
+        trace->prevLive[i] = leaf->live;
+    }
+    qsort (trace->leafs, (size_t)n, sizeof(trace->leafs[0]),
+           trace->delta ? orderLeafsByGrowth : orderLeafsByLiveBytes);
+
+    printf ("%14s %14s %12s %12s %s\r\n",
+            "LiveBytes", "Growth", "LiveObjs", "Allocs/s", "TypeName");
+    printf ("----------------------------------------------------------------------------------------------------------\r\n");
+    shown = 0;
+    for (i = 0; i < n && shown < trace->orderCount; i++) {
+        leaf = &trace->leafs[i];
+        type = c_type (pa_ldvoidp (&leaf->site->type));
+        name = c_metaScopedName (c_metaObject (type));
+        if (trace->filterExpression && name &&
+            regexec (&trace->expression, name, 1, match, 0) == REG_NOMATCH) {
+            os_free (name);
+            continue;
+        }
+        printf ("%14lld %14lld %12lld %12.0f %s\r\n",
+                leaf->liveBytes,
+                leaf->growth,
+                (long long)leaf->live * interval,
+                leaf->rate,
+                name ? name : "(anonymous)");
+        os_free (name);
+        totalLive += leaf->liveBytes;
+        totalGrowth += leaf->growth;
+        shown++;
+    }
+    printf ("\r\n");
+    printf ("Total : %lld  (%.2f KB), growth %lld\r\n",
+            totalLive, (double)totalLive/1024.0, totalGrowth);
+    fflush(stdout);
+    trace->prevTime = now;
+}
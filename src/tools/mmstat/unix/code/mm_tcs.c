@@ -0,0 +1,156 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include "u_user.h"
+#include "c_base.h"
+#include "c_metabase.h"
+#include "os_errno.h"
+#include "os_abstract.h"
+#include "os_stdlib.h"
+#include "os_heap.h"
+
+#include "mm_tcs.h"
+
+#include <sys/types.h>
+#include <regex.h>
+
+/* Shows the statistics of the per-type free-object caches (see
+ * c_baseTypeCacheEnable) of all types bound in the database.
+ */
+
+C_STRUCT(monitor_tcs) {
+    char *filterExpression;
+    regex_t expression;
+    int count;
+    c_ulonglong totalHits;
+    c_ulonglong totalMisses;
+};
+
+monitor_tcs
+monitor_tcsNew (
+    const char *filterExpression)
+{
+    char expressionError [1024];
+    monitor_tcs o = malloc (C_SIZEOF(monitor_tcs));
+
+    if (o) {
+        memset (o, 0, C_SIZEOF(monitor_tcs));
+        if (filterExpression) {
+            o->filterExpression = os_strdup(filterExpression);
+            if (regcomp (&o->expression, o->filterExpression, REG_EXTENDED) != 0) {
+                regerror (os_getErrno(), &o->expression, expressionError, sizeof(expressionError));
+                printf ("Filter expression error: %s\r\n", expressionError);
+                fflush(stdout);
+                regfree (&o->expression);
+                os_free (o->filterExpression);
+                o->filterExpression = NULL;
+            }
+        }
+    }
+    return o;
+}
+
+void
+monitor_tcsFree (
+    monitor_tcs o
+    )
+{
+    if (o) {
+        if (o->filterExpression) {
+            os_free (o->filterExpression);
+            regfree (&o->expression);
+        }
+        free (o);
+    }
+}
+
+static void
+display_tcs (
+    c_metaObject object,
+    c_metaWalkActionArg arg)
+{
+    monitor_tcs trace = monitor_tcs(arg);
+    c_baseTypeCacheStats stats;
+    regmatch_t match[1];
+    c_ulonglong requests;
+    char *name;
+
+    switch (c_baseObjectKind(object)) {
+    case M_MODULE:
+        c_metaWalk (object, display_tcs, arg);
+        return;
+    case M_CLASS:
+        break;
+    default:
+        return;
+    }
+    if (!c_baseTypeCacheGetStats (c_type(object), &stats)) {
+        return;
+    }
+    name = c_metaScopedName (object);
+    if (trace->filterExpression && name &&
+        regexec (&trace->expression, name, 1, match, 0) == REG_NOMATCH) {
+        os_free (name);
+        return;
+    }
+    requests = stats.hits + stats.misses;
+    printf ("%8u %8u %14"PA_PRIu64" %14"PA_PRIu64" %6.1f %14"PA_PRIu64" %14"PA_PRIu64" %s\r\n",
+            stats.retain,
+            stats.nfree,
+            stats.hits,
+            stats.misses,
+            requests ? 100.0 * (double)stats.hits / (double)requests : 0.0,
+            stats.cached,
+            stats.released,
+            name ? name : "(anonymous)");
+    os_free (name);
+    trace->totalHits += stats.hits;
+    trace->totalMisses += stats.misses;
+    trace->count++;
+}
+
+void
+monitor_tcsAction (
+    v_public entity,
+    c_voidp args
+    )
+{
+    monitor_tcs trace = monitor_tcs(args);
+    c_ulonglong requests;
+    time_t t;
+
+    time (&t);
+    printf ("\r\n############# Type caches ############# %s\r\n", ctime(&t));
+    if (trace->filterExpression) {
+        printf ("Filter expression : %s\r\n\r\n", trace->filterExpression);
+    }
+    printf ("%8s %8s %14s %14s %6s %14s %14s %s\r\n",
+            "Retain", "Free", "Hits", "Misses", "Hit%", "Cached", "Released", "TypeName");
+    printf ("----------------------------------------------------------------------------------------------------------\r\n");
+    trace->count = 0;
+    trace->totalHits = 0;
+    trace->totalMisses = 0;
+    c_metaWalk (c_metaObject(c_getBase(entity)), display_tcs, trace);
+    requests = trace->totalHits + trace->totalMisses;
+    printf ("\r\n");
+    printf ("Total : %d caches, %"PA_PRIu64" hits, %"PA_PRIu64" misses (%.1f%%)\r\n",
+            trace->count, trace->totalHits, trace->totalMisses,
+            requests ? 100.0 * (double)trace->totalHits / (double)requests : 0.0);
+    fflush(stdout);
+}
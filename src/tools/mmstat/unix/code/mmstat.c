@@ -41,22 +41,26 @@
 #include "mm_orc.h"
 #include "mm_trc.h"
 #include "mm_ms.h"
+#include "mm_apc.h"
+#include "mm_tcs.h"
 
 #ifdef INTEGRITY
 #include <netinet/in.h>
 static int connection;
 static int port = 2323;
 static int orig_stdout;
-static const char *optflags="p:i:l:f:s:o:n:hertTmMa";
+static const char *optflags="p:i:l:f:s:o:n:hertTmMgGca";
 #else
-static const char *optflags="i:l:f:s:o:n:hertTmMa";
+static const char *optflags="i:l:f:s:o:n:hertTmMgGca";
 #endif
 
 typedef enum
 {
     memoryStats,
     typeRefCount,
-    objectRefCount
+    objectRefCount,
+    allocProfile,
+    typeCaches
 } monitorMode;
 
 
@@ -66,7 +70,9 @@ print_usage ()
     printf ("Usage:\n"
         "      mmstat -h\n"
         "      mmstat [-M|m] [-e] [-a] [-i interval] [-s sample_count] [URI]\n"
-        "      mmstat [-t|T] [-i interval] [-s sample_count] [-l limit] [-o C|S|T] [-n nrEntries] [-f filter_expression] [URI]\n");
+        "      mmstat [-t|T] [-i interval] [-s sample_count] [-l limit] [-o C|S|T] [-n nrEntries] [-f filter_expression] [URI]\n"
+        "      mmstat [-g|G] [-i interval] [-s sample_count] [-n nrEntries] [-f filter_expression] [URI]\n"
+        "      mmstat -c [-i interval] [-s sample_count] [-f filter_expression] [URI]\n");
     printf ("\n");
     printf ("Show the memory statistics of the OpenSplice system identified by the specified URI. "
             "If no URI is specified, the environment variable OSPL_URI will be used. "
@@ -78,6 +84,9 @@ print_usage ()
     printf ("      -M                   Show memory statistics difference\n");
     printf ("      -t                   Show meta object references\n");
     printf ("      -T                   Show meta object references difference\n");
+    printf ("      -g                   Show sampled allocation profile, ordered by live bytes\n");
+    printf ("      -G                   Show sampled allocation profile, ordered by growth\n");
+    printf ("      -c                   Show free-object cache statistics per type\n");
     printf ("\n");
     printf ("Options:\n");
     printf ("      -h                   Show this help\n");
@@ -139,6 +148,8 @@ OPENSPLICE_MAIN ("")
     monitor_ms  ms_data         = NULL;
     monitor_trc trc_data        = NULL;
     monitor_orc orc_data        = NULL;
+    monitor_apc apc_data        = NULL;
+    monitor_tcs tcs_data        = NULL;
 
     orderKind selectedOrdering  = NO_ORDERING;
     int orderCount = INT_MAX;
@@ -198,6 +209,16 @@ OPENSPLICE_MAIN ("")
                 selected_action = typeRefCount;
                 delta = TRUE;
                 break;
+            case 'g':
+                selected_action = allocProfile;
+                break;
+            case 'G':
+                selected_action = allocProfile;
+                delta = TRUE;
+                break;
+            case 'c':
+                selected_action = typeCaches;
+                break;
             case 'o':
                 if (selectedOrdering  == NO_ORDERING && strlen(optarg) == 1)
                 {
@@ -406,6 +427,12 @@ OPENSPLICE_MAIN ("")
                 case objectRefCount:
                     orc_data = monitor_orcNew (obj_cnt_limit, filter_expr, delta);
                     break;
+                case allocProfile:
+                    apc_data = monitor_apcNew (filter_expr, orderCount, delta);
+                    break;
+                case typeCaches:
+                    tcs_data = monitor_tcsNew (filter_expr);
+                    break;
             }
 
             lost = 0;
@@ -425,6 +452,12 @@ OPENSPLICE_MAIN ("")
                         case objectRefCount:
                             ur = u_observableAction(u_observable(participant), monitor_orcAction, orc_data);
                             break;
+                        case allocProfile:
+                            ur = u_observableAction(u_observable(participant), monitor_apcAction, apc_data);
+                            break;
+                        case typeCaches:
+                            ur = u_observableAction(u_observable(participant), monitor_tcsAction, tcs_data);
+                            break;
                     }
 
                     sample++;
@@ -552,6 +585,12 @@ OPENSPLICE_MAIN ("")
             case objectRefCount:
                 monitor_orcFree (orc_data);
                 break;
+            case allocProfile:
+                monitor_apcFree (apc_data);
+                break;
+            case typeCaches:
+                monitor_tcsFree (tcs_data);
+                break;
         }
     }
     else
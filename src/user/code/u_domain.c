@@ -90,6 +90,7 @@ C_STRUCT(u_domainConfig) {
     u_domainId_t  id;
     u_bool        idReadFromConfig;
     c_bool        maintainObjectCount;
+    c_ulong       allocSampleInterval;
     u_bool        inProcessExceptionHandling;
     struct v_systemIdConfig systemIdConfig;
 };
@@ -174,6 +175,7 @@ GetDomainConfig(
     cf_element singleProcess;
     cf_element locked;
     cf_element maintainObjectCount;
+    cf_element allocSampleInterval;
     c_value value;
     cf_attribute attr;
     os_boolean doAppend;
@@ -322,6 +324,19 @@ GetDomainConfig(
                             }
                         }
                     } /* else: leave enabled */
+                    allocSampleInterval = cf_element(cf_elementChild(child, CFG_ALLOCSAMPLEINTERVAL));
+                    if (allocSampleInterval != NULL) {
+                        elementData = cf_data(cf_elementChild(allocSampleInterval, "#text"));
+                        if (elementData != NULL) {
+                            value = cf_dataValue(elementData);
+                            if (sscanf(value.is.String, "%u", &domainConfig->allocSampleInterval) != 1) {
+                                OS_REPORT(OS_WARNING, OSRPT_CNTXT_USER, U_RESULT_INTERNAL_ERROR,
+                                    "Incorrect <Database/AllocationSampleInterval> parameter for Domain: \"%s\","
+                                    " allocation sampling disabled",value.is.String);
+                                domainConfig->allocSampleInterval = 0;
+                            }
+                        }
+                    } /* else: leave disabled */
                 }
                 singleProcess = cf_element(cf_elementChild(dc, CFG_SINGLEPROCESS));
                 if (singleProcess != NULL) {
@@ -728,6 +743,7 @@ u_domainNew(
         domainCfg.dbSize = DATABASE_SIZE;
         domainCfg.dbFreeMemThreshold = DATABASE_FREE_MEM_THRESHOLD;
         domainCfg.maintainObjectCount = 1;
+        domainCfg.allocSampleInterval = 0;
         domainCfg.inProcessExceptionHandling = TRUE;
         domainCfg.name = os_strdup(DOMAIN_NAME);
         domainCfg.systemIdConfig.min = 1;
@@ -925,6 +941,7 @@ u_domainNew(
     if (result == U_RESULT_OK) {
         C_STRUCT(v_kernelQos) kernelQos;
         c_baseSetMaintainObjectCount (base, domainCfg.maintainObjectCount);
+        c_baseSetAllocSampling (base, domainCfg.allocSampleInterval);
         kernelQos.builtin.v.enabled = domainCfg.builtinTopicEnabled;
         kernelQos.systemIdConfig = domainCfg.systemIdConfig;
         kernel = v_kernelNew(base, KERNEL_NAME, &kernelQos, &procInfo);
@@ -1146,6 +1163,7 @@ u__domainOpen(
      * In singleprocess mode this is set back to 0 as default if no size is configured*/
     domainCfg.dbSize = DATABASE_SIZE;
     domainCfg.dbFreeMemThreshold = DATABASE_FREE_MEM_THRESHOLD;
+    domainCfg.allocSampleInterval = 0;
     domainCfg.inProcessExceptionHandling = TRUE;
     domainCfg.name = os_strdup(DOMAIN_NAME);
     domainCfg.systemIdConfig.min = 1;
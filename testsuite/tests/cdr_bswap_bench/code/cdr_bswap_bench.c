@@ -0,0 +1,355 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* Measures the throughput of CDR serialization and deserialization of
+ * arrays and sequences of primitives in native byte order and
+ * byte-swapped, the latter going through the bulk byte-swapping kernels
+ * of sd_cdr. Before that, it checks that byte-swapped and native round
+ * trips reproduce the input for lengths that are not multiples of the
+ * vector widths and for several start offsets of the arrays, so that
+ * the scalar tails of the kernels get covered as well.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os_time.h"
+#include "c_base.h"
+#include "c_metabase.h"
+#include "sd_serializer.h"
+#include "sd_serializerXMLTypeinfo.h"
+#include "sd_cdr.h"
+
+#define BENCH_NELEMS 4096
+#define BENCH_PAD 1
+
+/* Lengths around the vector widths (8 shorts, 4 longs and 2 doubles in
+ * SSE2; twice that in AVX2) and the bulk threshold, plus a long odd one */
+static const os_uint32 check_nelems[] = { 1, 2, 3, 7, 15, 16, 17, 31, 33, 255, 4095 };
+
+/* A leading octet array of 1 .. CHECK_MAXPAD bytes shifts the start of
+ * the other members, in CDR as well as in memory */
+#define CHECK_MAXPAD 8
+
+/* The members are ordered to make their offsets vary: shorts, longs and
+ * doubles each get aligned to their own size only, and the octets can
+ * leave the sequence that follows at any multiple of 4 */
+static const char *bench_type_fmt =
+    "<MetaData version=\"1.0.0\">"
+    "<Struct name=\"cdr_bswap_bench_%u_%u\">"
+    "<Member name=\"pad\"><Array size=\"%u\"><Octet/></Array></Member>"
+    "<Member name=\"s\"><Array size=\"%u\"><Short/></Array></Member>"
+    "<Member name=\"l\"><Array size=\"%u\"><Long/></Array></Member>"
+    "<Member name=\"d\"><Array size=\"%u\"><Double/></Array></Member>"
+    "<Member name=\"o\"><Array size=\"%u\"><Octet/></Array></Member>"
+    "<Member name=\"sd\"><Sequence><Double/></Sequence></Member>"
+    "</Struct>"
+    "</MetaData>";
+
+struct bench {
+    os_uint32 n;
+    os_uint32 pad;
+    c_type type;
+    c_type sdType;
+    struct sd_cdrInfo *ci;
+    os_size_t offPad, offS, offL, offD, offO, offSd;
+};
+
+static c_member
+bench_member(
+    c_type type,
+    const char *name)
+{
+    c_ulong i;
+
+    for (i = 0; i < c_structureMemberCount(type); i++) {
+        c_member m = c_structureMember(type, i);
+        if (strcmp(c_specifierName(m), name) == 0) {
+            return m;
+        }
+    }
+    return NULL;
+}
+
+static int
+bench_init(
+    struct bench *b,
+    c_base base,
+    os_uint32 n,
+    os_uint32 pad)
+{
+    char xml[1024];
+    sd_serializer serializer;
+    sd_serializedData serData;
+    c_member sd;
+
+    memset(b, 0, sizeof(*b));
+    b->n = n;
+    b->pad = pad;
+    snprintf(xml, sizeof(xml), bench_type_fmt, n, pad, pad, n, n, n, n);
+    serializer = sd_serializerXMLTypeinfoNew(base, FALSE);
+    serData = sd_serializerFromString(serializer, xml);
+    b->type = c_type(sd_serializerDeserialize(serializer, serData));
+    sd_serializedDataFree(serData);
+    sd_serializerFree(serializer);
+    if (b->type == NULL || (sd = bench_member(b->type, "sd")) == NULL) {
+        fprintf(stderr, "cdr_bswap_bench: failed to create type (n = %u, pad = %u)\n", n, pad);
+        return -1;
+    }
+    b->sdType = c_typeActualType(c_memberType(sd));
+    b->offSd = c_memberOffset(sd);
+    b->offPad = c_memberOffset(bench_member(b->type, "pad"));
+    b->offS = c_memberOffset(bench_member(b->type, "s"));
+    b->offL = c_memberOffset(bench_member(b->type, "l"));
+    b->offD = c_memberOffset(bench_member(b->type, "d"));
+    b->offO = c_memberOffset(bench_member(b->type, "o"));
+    if ((b->ci = sd_cdrInfoNew(b->type)) == NULL || sd_cdrCompile(b->ci) < 0) {
+        fprintf(stderr, "cdr_bswap_bench: failed to compile serializer (n = %u, pad = %u)\n", n, pad);
+        return -1;
+    }
+    return 0;
+}
+
+static void
+bench_fini(
+    struct bench *b)
+{
+    if (b->ci) {
+        sd_cdrInfoFree(b->ci);
+    }
+    c_free(b->type);
+}
+
+/* Size of the payload, for computing throughputs */
+static os_uint32
+bench_payload_size(
+    const struct bench *b)
+{
+    return b->pad + b->n * (os_uint32)(sizeof(c_short) + sizeof(c_long) + 2 * sizeof(c_double) + sizeof(c_octet));
+}
+
+/* All bytes of an element differ, so that any misplaced byte shows */
+static c_object
+bench_sample_new(
+    const struct bench *b)
+{
+    c_object obj = c_new(b->type);
+    char *p = obj;
+    c_short *s = (c_short *)(p + b->offS);
+    c_long *l = (c_long *)(p + b->offL);
+    c_double *d = (c_double *)(p + b->offD);
+    c_octet *o = (c_octet *)(p + b->offO);
+    c_double *sd;
+    os_uint32 i;
+
+    memset(p + b->offPad, 0xa5, b->pad);
+    sd = c_newSequence(c_collectionType(b->sdType), b->n);
+    *(c_double **)(p + b->offSd) = sd;
+    for (i = 0; i < b->n; i++) {
+        s[i] = (c_short)(0x0102 + i * 0x0303);
+        l[i] = (c_long)(0x01020304 + i * 0x05050505u);
+        d[i] = (c_double)i / 3.0 + 1.0e10;
+        o[i] = (c_octet)i;
+        sd[i] = -(c_double)i / 7.0 - 1.0e-10;
+    }
+    return obj;
+}
+
+static int
+bench_sample_equal(
+    const struct bench *b,
+    c_object a,
+    c_object x)
+{
+    const char *pa = a, *px = x;
+    const c_double *sda = *(c_double * const *)(pa + b->offSd);
+    const c_double *sdx = *(c_double * const *)(px + b->offSd);
+
+    return memcmp(pa + b->offPad, px + b->offPad, b->pad) == 0 &&
+           memcmp(pa + b->offS, px + b->offS, b->n * sizeof(c_short)) == 0 &&
+           memcmp(pa + b->offL, px + b->offL, b->n * sizeof(c_long)) == 0 &&
+           memcmp(pa + b->offD, px + b->offD, b->n * sizeof(c_double)) == 0 &&
+           memcmp(pa + b->offO, px + b->offO, b->n * sizeof(c_octet)) == 0 &&
+           sdx != NULL && c_sequenceSize((c_sequence)sdx) == b->n &&
+           memcmp(sda, sdx, b->n * sizeof(c_double)) == 0;
+}
+
+static int
+bench_round_trip(
+    const struct bench *b,
+    c_object sample,
+    c_bool bswap)
+{
+    struct sd_cdrSerdata *sd;
+    const void *blob;
+    os_uint32 size;
+    void *copy = NULL;
+    int rc, ok;
+
+    sd = bswap ? sd_cdrSerializeBSwap(b->ci, sample) : sd_cdrSerialize(b->ci, sample);
+    if (sd == NULL) {
+        return 0;
+    }
+    size = sd_cdrSerdataBlob(&blob, sd);
+    rc = bswap ? sd_cdrDeserializeObjectBSwap(&copy, b->ci, size, blob) : sd_cdrDeserializeObject(&copy, b->ci, size, blob);
+    ok = (rc >= 0 && bench_sample_equal(b, sample, copy));
+    c_free(copy);
+    sd_cdrSerdataFree(sd);
+    return ok;
+}
+
+/* Round trips through both byte orders must reproduce the input for
+ * all lengths and start offsets */
+static int
+check_round_trips(
+    c_base base)
+{
+    struct bench b;
+    c_object sample;
+    os_uint32 i, pad;
+    int nfail = 0;
+
+    for (i = 0; i < sizeof(check_nelems) / sizeof(check_nelems[0]); i++) {
+        for (pad = 1; pad <= CHECK_MAXPAD; pad++) {
+            if (bench_init(&b, base, check_nelems[i], pad) < 0) {
+                bench_fini(&b);
+                return -1;
+            }
+            sample = bench_sample_new(&b);
+            if (!bench_round_trip(&b, sample, TRUE)) {
+                fprintf(stderr, "cdr_bswap_bench: byte-swapped round trip mismatch (n = %u, pad = %u)\n", b.n, pad);
+                nfail++;
+            }
+            if (!bench_round_trip(&b, sample, FALSE)) {
+                fprintf(stderr, "cdr_bswap_bench: native round trip mismatch (n = %u, pad = %u)\n", b.n, pad);
+                nfail++;
+            }
+            c_free(sample);
+            bench_fini(&b);
+        }
+    }
+    return (nfail == 0) ? 0 : -1;
+}
+
+static double
+bench_serialize(
+    const struct bench *b,
+    c_object sample,
+    int iterations,
+    c_bool bswap)
+{
+    struct sd_cdrSerdata *sd;
+    os_timeM t0;
+    int i;
+
+    t0 = os_timeMGet();
+    for (i = 0; i < iterations; i++) {
+        sd = bswap ? sd_cdrSerializeBSwap(b->ci, sample) : sd_cdrSerialize(b->ci, sample);
+        if (sd == NULL) {
+            fprintf(stderr, "cdr_bswap_bench: serialization failed\n");
+            exit(1);
+        }
+        sd_cdrSerdataFree(sd);
+    }
+    return os_durationToReal(os_timeMDiff(os_timeMGet(), t0));
+}
+
+static double
+bench_deserialize(
+    const struct bench *b,
+    c_object sample,
+    int iterations,
+    c_bool bswap)
+{
+    struct sd_cdrSerdata *sd;
+    const void *blob;
+    os_uint32 size;
+    void *copy;
+    os_timeM t0;
+    double t;
+    int i, rc;
+
+    sd = bswap ? sd_cdrSerializeBSwap(b->ci, sample) : sd_cdrSerialize(b->ci, sample);
+    size = sd_cdrSerdataBlob(&blob, sd);
+    t0 = os_timeMGet();
+    for (i = 0; i < iterations; i++) {
+        rc = bswap ? sd_cdrDeserializeObjectBSwap(&copy, b->ci, size, blob) : sd_cdrDeserializeObject(&copy, b->ci, size, blob);
+        if (rc < 0) {
+            fprintf(stderr, "cdr_bswap_bench: deserialization failed\n");
+            exit(1);
+        }
+        c_free(copy);
+    }
+    t = os_durationToReal(os_timeMDiff(os_timeMGet(), t0));
+    sd_cdrSerdataFree(sd);
+    return t;
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    struct bench b;
+    c_object sample;
+    c_base base;
+    int iterations;
+    double mb, t;
+
+    iterations = (argc > 1) ? atoi(argv[1]) : 20000;
+    if (iterations < 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    if ((base = c_create("cdr_bswap_bench", NULL, 0, 0)) == NULL) {
+        fprintf(stderr, "cdr_bswap_bench: failed to create database\n");
+        return 1;
+    }
+
+    if (check_round_trips(base) < 0) {
+        return 1;
+    }
+    printf("round trips ok for %u lengths and %u start offsets\n",
+           (unsigned)(sizeof(check_nelems) / sizeof(check_nelems[0])), (unsigned)CHECK_MAXPAD);
+    if (iterations == 0) {
+        c_destroy(base);
+        return 0;
+    }
+
+    if (bench_init(&b, base, BENCH_NELEMS, BENCH_PAD) < 0) {
+        return 1;
+    }
+    sample = bench_sample_new(&b);
+    mb = (double)bench_payload_size(&b) / 1048576.0;
+
+    t = bench_serialize(&b, sample, iterations, FALSE);
+    printf("serialize native     %8.1f MB/s\n", iterations * mb / t);
+    t = bench_serialize(&b, sample, iterations, TRUE);
+    printf("serialize bswap      %8.1f MB/s\n", iterations * mb / t);
+    t = bench_deserialize(&b, sample, iterations, FALSE);
+    printf("deserialize native   %8.1f MB/s\n", iterations * mb / t);
+    t = bench_deserialize(&b, sample, iterations, TRUE);
+    printf("deserialize bswap    %8.1f MB/s\n", iterations * mb / t);
+
+    c_free(sample);
+    bench_fini(&b);
+    c_destroy(base);
+    return 0;
+}
@@ -0,0 +1,13 @@
+# included by bld/$(SPLICE_HOST)/makefile
+
+TARGET_EXEC     := cdr_bswap_bench
+TARGET_LINK_DIR := ../../exec/$(SPLICE_TARGET)
+
+include $(OSPL_OUTER_HOME)/setup/makefiles/test_target.mak
+
+CINCS += -I$(OSPL_HOME)/src/database/database/include
+CINCS += -I$(OSPL_HOME)/src/database/serialization/include
+
+LDLIBS += -l$(DDS_CORE)
+
+-include $(DEPENDENCIES)
@@ -0,0 +1,18 @@
+#!/bin/sh
+
+# Runs the CDR byte-swapping round-trip checks and benchmark with
+# ITERATIONS iterations per measurement (default 20000; 0 only runs the
+# checks). Exits with a non-zero status if a check fails.
+
+ITERATIONS=${1:-20000}
+BENCH=${BENCH:-exec/$SPLICE_TARGET/cdr_bswap_bench}
+
+if [ ! -x "$BENCH" ]; then
+    echo "cdr_bswap_bench executable not found at $BENCH"
+    exit 1
+fi
+
+"$BENCH" $ITERATIONS > cdr_bswap_bench.log 2>&1
+STATUS=$?
+cat cdr_bswap_bench.log
+exit $STATUS
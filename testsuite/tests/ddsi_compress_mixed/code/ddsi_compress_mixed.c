@@ -0,0 +1,264 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* Publisher and subscriber for checking DDSI payload compression with a
+ * writer that has readers which accept compressed payloads and readers
+ * which don't (see run_test.sh). The samples are large and compressible,
+ * so both forms are fragmented, and the writer's node drops packets, so
+ * that most samples need repairs. Every subscriber must receive every
+ * sample intact.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os_time.h"
+#include "dds_dcps.h"
+
+#define TOPIC_NAME "ddsi_compress_mixed"
+#define PAYLOAD_SIZE 65536
+
+static const char *mixed_type =
+    "<MetaData version=\"1.0.0\">"
+    "<Struct name=\"ddsi_compress_mixed\">"
+    "<Member name=\"id\"><Long/></Member>"
+    "<Member name=\"payload\"><Sequence><Octet/></Sequence></Member>"
+    "</Struct>"
+    "</MetaData>";
+
+struct mixed_sample {
+    DDS_long id;
+    struct DDS_sequence_s payload;
+};
+
+/* Runs of identical bytes compress well with any of the algorithms */
+static DDS_octet
+payload_byte(
+    DDS_long id,
+    DDS_unsigned_long i)
+{
+    return (DDS_octet)('a' + (id + i / 100) % 26);
+}
+
+static int
+payload_check(
+    const struct mixed_sample *s)
+{
+    const DDS_octet *p = s->payload._buffer;
+    DDS_unsigned_long i;
+
+    if (s->payload._length != PAYLOAD_SIZE) {
+        return 0;
+    }
+    for (i = 0; i < PAYLOAD_SIZE; i++) {
+        if (p[i] != payload_byte(s->id, i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static DDS_Topic
+create_topic(
+    DDS_DomainParticipant participant)
+{
+    DDS_TypeSupport ts;
+    DDS_TopicQos *qos;
+    DDS_Topic topic = NULL;
+
+    ts = DDS_TypeSupport__alloc(TOPIC_NAME, "id", mixed_type);
+    if (ts == NULL ||
+        DDS_TypeSupport_register_type(ts, participant, TOPIC_NAME) != DDS_RETCODE_OK) {
+        fprintf(stderr, "ddsi_compress_mixed: register_type failed\n");
+        return NULL;
+    }
+    qos = DDS_TopicQos__alloc();
+    if (DDS_DomainParticipant_get_default_topic_qos(participant, qos) == DDS_RETCODE_OK) {
+        qos->reliability.kind = DDS_RELIABLE_RELIABILITY_QOS;
+        qos->history.kind = DDS_KEEP_ALL_HISTORY_QOS;
+        topic = DDS_DomainParticipant_create_topic(participant, TOPIC_NAME, TOPIC_NAME,
+                                                   qos, NULL, DDS_STATUS_MASK_NONE);
+    }
+    DDS_free(qos);
+    DDS_free(ts);
+    if (topic == NULL) {
+        fprintf(stderr, "ddsi_compress_mixed: create_topic failed\n");
+    }
+    return topic;
+}
+
+static int
+publish(
+    DDS_DomainParticipant participant,
+    DDS_Topic topic,
+    int nsamples,
+    int nreaders)
+{
+    DDS_Publisher publisher;
+    DDS_DataWriter writer;
+    DDS_PublicationMatchedStatus status;
+    DDS_Duration_t timeout = { 60, 0 };
+    struct mixed_sample s;
+    DDS_octet *buf;
+    DDS_unsigned_long i;
+    int n, tries;
+
+    publisher = DDS_DomainParticipant_create_publisher(participant, DDS_PUBLISHER_QOS_DEFAULT,
+                                                       NULL, DDS_STATUS_MASK_NONE);
+    writer = publisher ? DDS_Publisher_create_datawriter(publisher, topic, DDS_DATAWRITER_QOS_USE_TOPIC_QOS,
+                                                         NULL, DDS_STATUS_MASK_NONE) : NULL;
+    if (writer == NULL) {
+        fprintf(stderr, "ddsi_compress_mixed: create_datawriter failed\n");
+        return 1;
+    }
+
+    /* Only start once all readers are matched, so that every sample goes
+     * to readers of both kinds */
+    memset(&status, 0, sizeof(status));
+    for (tries = 0; tries < 600; tries++) {
+        if (DDS_DataWriter_get_publication_matched_status(writer, &status) == DDS_RETCODE_OK &&
+            status.current_count >= nreaders) {
+            break;
+        }
+        os_sleep(100*OS_DURATION_MILLISECOND);
+    }
+    if (status.current_count < nreaders) {
+        fprintf(stderr, "ddsi_compress_mixed: %d of %d readers matched\n", status.current_count, nreaders);
+        return 1;
+    }
+
+    buf = malloc(PAYLOAD_SIZE);
+    s.payload._maximum = s.payload._length = PAYLOAD_SIZE;
+    s.payload._buffer = buf;
+    s.payload._release = FALSE;
+    for (n = 0; n < nsamples; n++) {
+        s.id = n;
+        for (i = 0; i < PAYLOAD_SIZE; i++) {
+            buf[i] = payload_byte(n, i);
+        }
+        if (DDS_DataWriter_write(writer, &s, DDS_HANDLE_NIL) != DDS_RETCODE_OK) {
+            fprintf(stderr, "ddsi_compress_mixed: write of sample %d failed\n", n);
+            free(buf);
+            return 1;
+        }
+    }
+    free(buf);
+    if (DDS_DataWriter_wait_for_acknowledgments(writer, &timeout) != DDS_RETCODE_OK) {
+        fprintf(stderr, "ddsi_compress_mixed: not all samples acknowledged\n");
+        return 1;
+    }
+    printf("published %d samples to %d readers\n", nsamples, nreaders);
+    return 0;
+}
+
+static int
+subscribe(
+    DDS_DomainParticipant participant,
+    DDS_Topic topic,
+    int nsamples)
+{
+    DDS_Subscriber subscriber;
+    DDS_DataReader reader;
+    DDS_sequence data;
+    DDS_SampleInfoSeq *info;
+    const struct mixed_sample *s;
+    os_timeM tend;
+    char *seen;
+    int nseen = 0, nbad = 0;
+    DDS_unsigned_long i;
+
+    subscriber = DDS_DomainParticipant_create_subscriber(participant, DDS_SUBSCRIBER_QOS_DEFAULT,
+                                                         NULL, DDS_STATUS_MASK_NONE);
+    reader = subscriber ? DDS_Subscriber_create_datareader(subscriber, topic, DDS_DATAREADER_QOS_USE_TOPIC_QOS,
+                                                           NULL, DDS_STATUS_MASK_NONE) : NULL;
+    if (reader == NULL) {
+        fprintf(stderr, "ddsi_compress_mixed: create_datareader failed\n");
+        return 1;
+    }
+
+    seen = calloc((size_t)nsamples, 1);
+    data = DDS_sequence_malloc();
+    info = DDS_SampleInfoSeq__alloc();
+    tend = os_timeMAdd(os_timeMGet(), OS_DURATION_INIT(120,0));
+    while (nseen < nsamples && os_timeMCompare(os_timeMGet(), tend) == OS_LESS) {
+        if (DDS_DataReader_take(reader, data, info, DDS_LENGTH_UNLIMITED, DDS_ANY_SAMPLE_STATE,
+                                DDS_ANY_VIEW_STATE, DDS_ANY_INSTANCE_STATE) != DDS_RETCODE_OK) {
+            os_sleep(10*OS_DURATION_MILLISECOND);
+            continue;
+        }
+        s = data->_buffer;
+        for (i = 0; i < data->_length; i++) {
+            if (!info->_buffer[i].valid_data) {
+                continue;
+            }
+            if (s[i].id < 0 || s[i].id >= nsamples || !payload_check(&s[i])) {
+                nbad++;
+            } else if (!seen[s[i].id]) {
+                seen[s[i].id] = 1;
+                nseen++;
+            }
+        }
+        DDS_DataReader_return_loan(reader, data, info);
+    }
+    DDS_free(info);
+    DDS_free(data);
+    free(seen);
+
+    printf("received %d of %d samples, %d corrupt\n", nseen, nsamples, nbad);
+    return (nseen == nsamples && nbad == 0) ? 0 : 1;
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    DDS_DomainParticipantFactory factory;
+    DDS_DomainParticipant participant;
+    DDS_Topic topic;
+    int nsamples, nreaders = 0, rc;
+
+    if (argc < 3 ||
+        (strcmp(argv[1], "pub") != 0 && strcmp(argv[1], "sub") != 0) ||
+        (nsamples = atoi(argv[2])) <= 0 ||
+        (strcmp(argv[1], "pub") == 0 && (argc < 4 || (nreaders = atoi(argv[3])) <= 0))) {
+        fprintf(stderr, "usage: %s pub NSAMPLES NREADERS | sub NSAMPLES\n", argv[0]);
+        return 1;
+    }
+
+    factory = DDS_DomainParticipantFactory_get_instance();
+    participant = factory ? DDS_DomainParticipantFactory_create_participant(
+            factory, DDS_DOMAIN_ID_DEFAULT, DDS_PARTICIPANT_QOS_DEFAULT,
+            NULL, DDS_STATUS_MASK_NONE) : NULL;
+    if (participant == NULL) {
+        fprintf(stderr, "ddsi_compress_mixed: create_participant failed\n");
+        return 1;
+    }
+    if ((topic = create_topic(participant)) == NULL) {
+        rc = 1;
+    } else if (nreaders > 0) {
+        rc = publish(participant, topic, nsamples, nreaders);
+    } else {
+        rc = subscribe(participant, topic, nsamples);
+    }
+    DDS_DomainParticipant_delete_contained_entities(participant);
+    DDS_DomainParticipantFactory_delete_participant(factory, participant);
+    return rc;
+}
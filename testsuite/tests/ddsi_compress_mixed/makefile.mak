@@ -0,0 +1,13 @@
+# included by bld/$(SPLICE_HOST)/makefile
+
+TARGET_EXEC     := ddsi_compress_mixed
+TARGET_LINK_DIR := ../../exec/$(SPLICE_TARGET)
+
+include $(OSPL_OUTER_HOME)/setup/makefiles/test_target.mak
+
+CINCS += -I$(OSPL_HOME)/src/api/dcps/sac/include
+
+LDLIBS += -l$(DDS_DCPSSAC)
+LDLIBS += -l$(DDS_CORE)
+
+-include $(DEPENDENCIES)
@@ -0,0 +1,37 @@
+#!/bin/sh
+
+# Runs a compressing writer with two readers on the same host, one that
+# accepts compressed payloads and one that doesn't (each in its own
+# single-process domain), and checks that both receive all NSAMPLES
+# samples (default 200) intact although the writer drops 10% of its
+# packets.
+
+NSAMPLES=${1:-200}
+TEST=${TEST:-exec/$SPLICE_TARGET/ddsi_compress_mixed}
+ETC=`pwd`/etc
+
+if [ ! -x "$TEST" ]; then
+    echo "ddsi_compress_mixed executable not found at $TEST"
+    exit 1
+fi
+
+OSPL_URI=file://$ETC/reader.xml "$TEST" sub $NSAMPLES > reader.log 2>&1 &
+READER=$!
+OSPL_URI=file://$ETC/reader_nocompress.xml "$TEST" sub $NSAMPLES > reader_nocompress.log 2>&1 &
+READER_NOCOMPRESS=$!
+OSPL_URI=file://$ETC/writer.xml "$TEST" pub $NSAMPLES 2 > writer.log 2>&1
+WRITER_RC=$?
+
+wait $READER
+READER_RC=$?
+wait $READER_NOCOMPRESS
+READER_NOCOMPRESS_RC=$?
+
+for f in writer reader reader_nocompress; do
+    echo "$f: `tail -n 1 $f.log`"
+done
+if [ $WRITER_RC -ne 0 ] || [ $READER_RC -ne 0 ] || [ $READER_NOCOMPRESS_RC -ne 0 ]; then
+    echo "FAIL"
+    exit 1
+fi
+echo "PASS"
@@ -0,0 +1,70 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* Measures how long it takes to bring up a domain: the first participant in
+ * a single-process deployment creates the database, the metamodel and the
+ * kernelModule types before it returns. Run it once per process (see
+ * run_test.sh) and compare the reported times across builds.
+ */
+#include <stdio.h>
+
+#include "os_time.h"
+#include "dds_dcps.h"
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    DDS_DomainParticipantFactory factory;
+    DDS_DomainParticipant participant;
+    os_timeM t0, t1, t2;
+    os_duration create, teardown;
+
+    (void)argc;
+    (void)argv;
+
+    t0 = os_timeMGet();
+    factory = DDS_DomainParticipantFactory_get_instance();
+    if (factory == NULL) {
+        fprintf(stderr, "startup_bench: no participant factory\n");
+        return 1;
+    }
+    participant = DDS_DomainParticipantFactory_create_participant(
+            factory, DDS_DOMAIN_ID_DEFAULT, DDS_PARTICIPANT_QOS_DEFAULT,
+            NULL, DDS_STATUS_MASK_NONE);
+    if (participant == NULL) {
+        fprintf(stderr, "startup_bench: create_participant failed\n");
+        return 1;
+    }
+    t1 = os_timeMGet();
+    if (DDS_DomainParticipantFactory_delete_participant(factory, participant) != DDS_RETCODE_OK) {
+        fprintf(stderr, "startup_bench: delete_participant failed\n");
+        return 1;
+    }
+    t2 = os_timeMGet();
+
+    create = os_timeMDiff(t1, t0);
+    teardown = os_timeMDiff(t2, t1);
+    printf("startup %d.%09u s, participant delete %d.%09u s\n",
+           (int)OS_DURATION_GET_SECONDS(create), (unsigned)OS_DURATION_GET_NANOSECONDS(create),
+           (int)OS_DURATION_GET_SECONDS(teardown), (unsigned)OS_DURATION_GET_NANOSECONDS(teardown));
+    return 0;
+}
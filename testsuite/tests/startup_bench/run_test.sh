@@ -0,0 +1,23 @@
+#!/bin/sh
+
+# Starts a single-process domain RUNS times (default 20) and reports the
+# startup time of each run and the median. OSPL_URI must point to a
+# single-process configuration.
+
+RUNS=${1:-20}
+BENCH=${BENCH:-exec/$SPLICE_TARGET/startup_bench}
+
+if [ ! -x "$BENCH" ]; then
+    echo "startup_bench executable not found at $BENCH"
+    exit 1
+fi
+
+i=0
+while [ $i -lt $RUNS ]; do
+    "$BENCH" || exit 1
+    i=`expr $i + 1`
+done | tee startup_bench.log
+
+awk '{ print $2 }' startup_bench.log | sort -n | awk '
+    { t[NR] = $1 }
+    END { if (NR > 0) printf "median startup over %d runs: %s s\n", NR, t[int((NR + 1) / 2)] }'